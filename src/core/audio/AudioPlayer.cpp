@@ -1,5 +1,8 @@
 #include "AudioPlayer.h"
 
+#include <algorithm>  // for max
+#include <cstdint>    // for int64_t
+
 #include "audio/AudioQueue.h"         // for AudioQueue
 #include "audio/DeviceInfo.h"         // for DeviceInfo
 #include "audio/PortAudioConsumer.h"  // for PortAudioConsumer
@@ -73,6 +76,17 @@ void AudioPlayer::seek(int seconds) {
     this->vorbisProducer->seek(seconds);
 }
 
+auto AudioPlayer::getPlaybackPosition() const -> size_t {
+    auto [sampleRate, channels] = this->audioQueue->getAudioAttributes();
+    if (channels == 0 || !(sampleRate > 0)) {
+        return 0;
+    }
+    // The samples still waiting in the queue have been read from the file but not been played yet
+    auto queuedFrames = static_cast<int64_t>(this->audioQueue->size() / channels);
+    auto frames = std::max<int64_t>(0, this->vorbisProducer->getFramePosition() - queuedFrames);
+    return static_cast<size_t>(static_cast<double>(frames) * 1000.0 / sampleRate);
+}
+
 auto AudioPlayer::getOutputDevices() -> std::vector<DeviceInfo> { return this->portAudioConsumer->getOutputDevices(); }
 
 auto AudioPlayer::getSettings() -> Settings& { return this->settings; }
@@ -11,8 +11,9 @@
 
 #pragma once
 
-#include <memory>  // for make_unique, unique_ptr
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <memory>   // for make_unique, unique_ptr
+#include <vector>   // for vector
 
 #include "filesystem.h"  // for path
 
@@ -41,6 +42,11 @@ public:
     void pause();
     void seek(int seconds);
 
+    /**
+     * @return The position of the playback in the current audio file, in milliseconds
+     */
+    size_t getPlaybackPosition() const;
+
     std::vector<DeviceInfo> getOutputDevices();
 
     Settings& getSettings();
@@ -12,71 +12,127 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
-#include <deque>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <mutex>
+#include <utility>
+#include <vector>
 
+/**
+ * @brief Single-producer/single-consumer ring buffer connecting an audio producer and an audio consumer.
+ *
+ * The storage is allocated once on construction. push() and pop() copy whole chunks and never take queueLock, so they
+ * can be called from the PortAudio callback thread without waiting on the other side. Exactly one thread may push and
+ * exactly one thread may pop at any time.
+ *
+ * The non-realtime side (VorbisProducer / VorbisConsumer) may block on waitForProducer() / waitForConsumer(). As the
+ * realtime side never takes queueLock, a notification can race with the start of a wait: waits are therefore bounded by
+ * WAIT_TIMEOUT, after which the waiting thread re-checks the queue state.
+ */
 template <typename T>
 class AudioQueue {
 public:
+    /// Default capacity in samples (~1.4s of stereo audio at 48kHz)
+    static constexpr size_t DEFAULT_CAPACITY = size_t{1} << 17U;
+    static constexpr std::chrono::milliseconds WAIT_TIMEOUT{10};
+
+    /**
+     * @param minCapacity Minimal number of samples the queue can hold. Rounded up to the next power of two.
+     */
+    explicit AudioQueue(size_t minCapacity = DEFAULT_CAPACITY): buffer(roundUpToPowerOfTwo(minCapacity)) {
+        mask = buffer.size() - 1;
+    }
+
+    AudioQueue(AudioQueue const&) = delete;
+    AudioQueue(AudioQueue&&) = delete;
+    auto operator=(AudioQueue const&) -> AudioQueue& = delete;
+    auto operator=(AudioQueue&&) -> AudioQueue& = delete;
+
+    /**
+     * Empties the queue and resets the stream state.
+     * Must only be called while neither the producer nor the consumer is running.
+     */
     void reset() {
-        std::lock_guard<std::mutex> lock(internalLock);
+        this->readIndex.store(0, std::memory_order_relaxed);
+        this->writeIndex.store(0, std::memory_order_relaxed);
         this->popNotified = false;
         this->pushNotified = false;
         this->streamEnd = false;
-        internalQueue.clear();
 
         this->sampleRate = -1;
         this->channels = 0;
     }
 
-    bool empty() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.empty();
-    }
+    [[nodiscard]] bool empty() const { return size() == 0; }
 
-    size_t size() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.size();
+    [[nodiscard]] size_t size() const {
+        // Load the read index first: it only grows, so the difference can never underflow
+        auto r = this->readIndex.load(std::memory_order_acquire);
+        auto w = this->writeIndex.load(std::memory_order_acquire);
+        return w - r;
     }
 
-    template <typename Iter>
-    void emplace(Iter begI, Iter endI) {
-        std::lock_guard<std::mutex> lock(internalLock);
-        std::move(begI, endI, std::front_inserter(internalQueue));
+    [[nodiscard]] size_t capacity() const { return buffer.size(); }
+
+    /**
+     * Copies up to nSamples samples into the queue (producer side, lock free).
+     * If the queue is full, only whole frames are written so that the channels stay interleaved.
+     * @return The number of samples actually written. Less than nSamples if the queue is full.
+     */
+    size_t push(T const* data, size_t nSamples) {
+        auto w = this->writeIndex.load(std::memory_order_relaxed);
+        auto r = this->readIndex.load(std::memory_order_acquire);
+        auto n = std::min(nSamples, buffer.size() - (w - r));
+        if (auto nChannels = this->channels.load(std::memory_order_relaxed); n < nSamples && nChannels > 1) {
+            n -= n % nChannels;
+        }
+
+        auto first = std::min(n, buffer.size() - (w & mask));
+        std::copy_n(data, first, buffer.begin() + static_cast<std::ptrdiff_t>(w & mask));
+        std::copy_n(data + first, n - first, buffer.begin());
+
+        this->writeIndex.store(w + n, std::memory_order_release);
 
         this->pushNotified = true;
         this->pushLockCondition.notify_one();
+        return n;
     }
 
-    template <typename InsertIter>
-    InsertIter pop(InsertIter insertIter, size_t nSamples) {
-        std::lock_guard<std::mutex> lock(internalLock);
-
-        if (this->channels == 0) {
+    /**
+     * Moves up to nSamples samples out of the queue (consumer side, lock free).
+     * Only whole frames (i.e. multiples of the channel count) are returned.
+     * @return The number of samples actually read.
+     */
+    size_t pop(T* out, size_t nSamples) {
+        auto nChannels = this->channels.load(std::memory_order_relaxed);
+        if (nChannels == 0) {
             this->popNotified = true;
             this->popLockCondition.notify_one();
-            return insertIter;
+            return 0;
         }
 
+        auto r = this->readIndex.load(std::memory_order_relaxed);
+        auto w = this->writeIndex.load(std::memory_order_acquire);
+        auto available = w - r;
+        auto n = std::min<size_t>(nSamples, available - available % nChannels);
 
-        auto queueSize = internalQueue.size();
-        auto returnBufferLength = std::min<size_t>(nSamples, queueSize - queueSize % this->channels);
-        auto begI = rbegin(internalQueue);
-        auto endI = std::next(begI, returnBufferLength);
+        auto first = std::min(n, buffer.size() - (r & mask));
+        std::copy_n(buffer.cbegin() + static_cast<std::ptrdiff_t>(r & mask), first, out);
+        std::copy_n(buffer.cbegin(), n - first, out + first);
 
-        auto ret = std::move(begI, endI, insertIter);
-        internalQueue.erase(endI.base(), begI.base());
+        this->readIndex.store(r + n, std::memory_order_release);
 
         this->popNotified = true;
         this->popLockCondition.notify_one();
-        return ret;
+        return n;
     }
 
     void signalEndOfStream() {
-        std::lock_guard<std::mutex> lock(internalLock);
         this->streamEnd = true;
         this->pushNotified = true;
         this->popNotified = true;
@@ -85,33 +141,27 @@ public:
     }
 
     void waitForProducer(std::unique_lock<std::mutex>& lock) {
-        // static_assert(lock.mutex() == &this->queueLock);
         assert(lock.mutex() == &this->queueLock);
-        while (!this->pushNotified && !hasStreamEnded()) { this->pushLockCondition.wait(lock); }
+        this->pushLockCondition.wait_for(lock, WAIT_TIMEOUT,
+                                         [this] { return this->pushNotified.load() || hasStreamEnded(); });
         this->pushNotified = false;
     }
 
     void waitForConsumer(std::unique_lock<std::mutex>& lock) {
-        // static_assert(lock.mutex() == &this->queueLock);
         assert(lock.mutex() == &this->queueLock);
-        while (!this->popNotified && !hasStreamEnded()) { this->popLockCondition.wait(lock); }
+        this->popLockCondition.wait_for(lock, WAIT_TIMEOUT,
+                                        [this] { return this->popNotified.load() || hasStreamEnded(); });
         this->popNotified = false;
     }
 
-    bool hasStreamEnded() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return this->streamEnd;
-    }
+    [[nodiscard]] bool hasStreamEnded() const { return this->streamEnd; }
 
-    [[nodiscard]] std::unique_lock<std::mutex> acquire_lock() {
-        std::unique_lock retLock{this->queueLock, std::defer_lock};
-        std::lock(retLock, this->internalLock);
-        std::lock_guard{this->internalLock, std::adopt_lock};
-        return retLock;
-    }
+    /**
+     * @return The lock to pass to waitForProducer() / waitForConsumer(). Only needed by the non-realtime side.
+     */
+    [[nodiscard]] std::unique_lock<std::mutex> acquire_lock() { return std::unique_lock{this->queueLock}; }
 
     void setAudioAttributes(double lSampleRate, unsigned int lChannels) {
-        std::lock_guard<std::mutex> lock(internalLock);
         this->sampleRate = lSampleRate;
         this->channels = lChannels;
     }
@@ -122,24 +172,31 @@ public:
      * Todo (readability, type-safety): create a struct AudioAttributes; remove this comment
      */
 
-    [[nodiscard]] std::pair<double, uint32_t> getAudioAttributes() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return {this->sampleRate, this->channels};
+    [[nodiscard]] std::pair<double, uint32_t> getAudioAttributes() const { return {this->sampleRate, this->channels}; }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t n) {
+        size_t res = 1;
+        while (res < n) { res <<= 1U; }
+        return res;
     }
 
 private:
-    std::mutex queueLock;
-    std::mutex internalLock;
+    std::vector<T> buffer;
+    size_t mask{};
 
-    std::deque<T> internalQueue;
+    // Monotonic indices, wrapped with `mask` on access. Kept on separate cache lines to avoid false sharing.
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    alignas(64) std::atomic<size_t> readIndex{0};
 
+    std::mutex queueLock;
     std::condition_variable pushLockCondition;
     std::condition_variable popLockCondition;
 
-    double sampleRate{std::numeric_limits<double>::quiet_NaN()};
-    uint32_t channels{0};
+    std::atomic<double> sampleRate{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<uint32_t> channels{0};
 
-    bool streamEnd{false};
-    bool pushNotified{false};
-    bool popNotified{false};
+    std::atomic<bool> streamEnd{false};
+    std::atomic<bool> pushNotified{false};
+    std::atomic<bool> popNotified{false};
 };
@@ -1,7 +1,6 @@
 #include "PortAudioConsumer.h"
 
 #include <algorithm>  // for for_each, transform, max
-#include <deque>      // for _Deque_iterator
 #include <iterator>   // for next, prev
 #include <string>     // for to_string, string
 
@@ -103,7 +102,7 @@ auto PortAudioConsumer::playCallback(const void* /*inputBuffer*/, void* outputBu
 
     if (outputBuffer != nullptr) {
         auto begI = static_cast<float*>(outputBuffer);
-        auto midI = this->audioQueue.pop(begI, framesPerBuffer * this->outputChannels);
+        auto midI = std::next(begI, this->audioQueue.pop(begI, framesPerBuffer * this->outputChannels));
         auto endI = std::next(begI, framesPerBuffer * this->outputChannels);
         // Fill buffer to requested length if necessary
 
@@ -2,10 +2,9 @@
 
 #include <algorithm>  // for min, max
 #include <cstddef>    // for size_t
-#include <iterator>   // for next
 #include <string>     // for to_string, string
 
-#include <glib.h>  // for g_message
+#include <glib.h>  // for g_message, g_warning
 
 #include "audio/AudioQueue.h"           // for AudioQueue
 #include "audio/DeviceInfo.h"           // for DeviceInfo
@@ -94,9 +93,10 @@ auto PortAudioProducer::recordCallback(const void* inputBuffer, void* /*outputBu
     }
 
     if (inputBuffer != nullptr) {
-        size_t providedFrames = framesPerBuffer * this->inputChannels;
-        auto begI = static_cast<float const*>(inputBuffer);
-        this->audioQueue.emplace(begI, std::next(begI, providedFrames));
+        size_t providedSamples = framesPerBuffer * static_cast<size_t>(this->inputChannels);
+        size_t written = this->audioQueue.push(static_cast<float const*>(inputBuffer), providedSamples);
+        // Never block the realtime thread: samples that do not fit are dropped and reported when recording stops
+        this->droppedSamples += providedSamples - written;
     }
     return paContinue;
 }
@@ -113,6 +113,10 @@ void PortAudioProducer::stopRecording() {
         }
     }
 
+    if (auto dropped = this->droppedSamples.exchange(0); dropped > 0) {
+        g_warning("PortAudioProducer: The audio queue overflowed, %zu samples were dropped", dropped);
+    }
+
     // Notify the consumer at the other side that there will be no more data
     this->audioQueue.signalEndOfStream();
 
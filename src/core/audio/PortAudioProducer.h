@@ -11,8 +11,10 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
-#include <vector>  // for vector
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <vector>   // for vector
 
 #include <portaudiocpp/PortAudioCpp.hxx>  // for MemFunCallbackStream, System
 
@@ -49,4 +51,7 @@ private:
     std::unique_ptr<portaudio::MemFunCallbackStream<PortAudioProducer>> inputStream;
 
     int inputChannels = 0;
+
+    /// Number of samples the realtime callback could not push into the full queue
+    std::atomic<size_t> droppedSamples{0};
 };
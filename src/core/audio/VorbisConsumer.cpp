@@ -1,9 +1,8 @@
 #include "VorbisConsumer.h"
 
-#include <algorithm>  // for for_each, min, max
-#include <cstddef>    // for size_t
-#include <deque>      // for _Deque_iterator
-#include <iterator>   // for back_insert_iterator, back_in...
+#include <algorithm>  // for for_each
+#include <cstddef>    // for size_t, ptrdiff_t
+#include <iterator>   // for next
 #include <memory>     // for unique_ptr
 #include <string>     // for string
 #include <utility>    // for move
@@ -26,6 +25,10 @@ auto VorbisConsumer::start(fs::path const& file) -> bool {
         g_warning("VorbisConsumer: Timing issue - Sample rate requested before known");
         return false;
     }
+    if (channels <= 0) {
+        g_warning("VorbisConsumer: Invalid number of channels: %d", static_cast<int>(channels));
+        return false;
+    }
 
     SF_INFO sfInfo;
     sfInfo.channels = int(channels);
@@ -41,22 +44,27 @@ auto VorbisConsumer::start(fs::path const& file) -> bool {
 
     this->consumerThread = std::thread([this, sfFile = std::move(sfFile), channels = channels] {
         auto lock{audioQueue.acquire_lock()};
-        auto buffer_size{size_t(64 * channels)};
-        std::vector<float> buffer;
-        buffer.reserve(buffer_size);  // efficiency
+        auto buffer_size{size_t(1024 * channels)};
+        std::vector<float> buffer(buffer_size);
         double audioGain = this->settings.getAudioGain();
 
         while (!(this->stopConsumer || (audioQueue.hasStreamEnded() && audioQueue.empty()))) {
             audioQueue.waitForProducer(lock);
             while (audioQueue.size() > buffer_size || (audioQueue.hasStreamEnded() && !audioQueue.empty())) {
-                buffer.resize(0);
-                this->audioQueue.pop(std::back_inserter(buffer), buffer_size);
+                auto nSamples = this->audioQueue.pop(buffer.data(), buffer_size);
+                if (nSamples == 0) {
+                    // Only an incomplete frame is left
+                    break;
+                }
                 // apply gain
                 if (audioGain != 1.0) {
-                    std::for_each(begin(buffer), end(buffer), [audioGain](auto& val) { val *= audioGain; });
+                    std::for_each(begin(buffer), std::next(begin(buffer), static_cast<std::ptrdiff_t>(nSamples)),
+                                  [audioGain](auto& val) { val *= audioGain; });
                 }
-                sf_writef_float(sfFile.get(), buffer.data(),
-                                std::min<sf_count_t>(sf_count_t(buffer.size()) / channels, 64));
+                sf_writef_float(sfFile.get(), buffer.data(), sf_count_t(nSamples / channels));
+            }
+            if (audioQueue.hasStreamEnded() && audioQueue.size() < static_cast<size_t>(channels)) {
+                break;
             }
         }
     });
@@ -2,7 +2,6 @@
 
 #include <algorithm>  // for fill_n, max
 #include <cstdio>     // for size_t, SEEK_CUR, SEEK_SET
-#include <iterator>   // for begin, end
 #include <memory>     // for unique_ptr
 #include <string>     // for string
 #include <utility>    // for move
@@ -30,8 +29,9 @@ auto VorbisProducer::start(fs::path const& file, unsigned int timestamp) -> bool
     sf_count_t seekPosition = sfInfo.samplerate / 1000 * sf_count_t(timestamp);
 
     if (seekPosition < sfInfo.frames) {
-        sf_seek(sfFile.get(), seekPosition, SEEK_SET);
+        this->framePosition = sf_seek(sfFile.get(), seekPosition, SEEK_SET);
     } else {
+        this->framePosition = 0;
         g_warning("VorbisProducer: Seeking outside of audio file extent");
     }
 
@@ -58,7 +58,14 @@ auto VorbisProducer::start(fs::path const& file, unsigned int timestamp) -> bool
                 this->seekSeconds -= tmpSeekSeconds;
             }
 
-            this->audioQueue.emplace(begin(sampleBuffer), end(sampleBuffer));
+            size_t written = 0;
+            while (written < sampleBuffer.size() && !this->audioQueue.hasStreamEnded() && !this->stopProducer) {
+                written += this->audioQueue.push(sampleBuffer.data() + written, sampleBuffer.size() - written);
+                if (written < sampleBuffer.size()) {
+                    audioQueue.waitForConsumer(lock);
+                }
+            }
+            this->framePosition = sf_seek(sfFile.get(), 0, SEEK_CUR);
         }
         this->audioQueue.signalEndOfStream();
     });
@@ -81,3 +88,5 @@ void VorbisProducer::stop() {
 
 
 void VorbisProducer::seek(int seconds) { this->seekSeconds = seconds; }
+
+auto VorbisProducer::getFramePosition() const -> int64_t { return this->framePosition; }
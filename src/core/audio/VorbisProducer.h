@@ -11,8 +11,9 @@
 
 #pragma once
 
-#include <atomic>  // for atomic
-#include <thread>  // for thread
+#include <atomic>   // for atomic
+#include <cstdint>  // for int64_t
+#include <thread>   // for thread
 
 #include "filesystem.h"  // for path
 
@@ -28,10 +29,16 @@ public:
     void stop();
     void seek(int seconds);
 
+    /**
+     * @return The position (in frames) in the audio file up to which samples have been read into the queue
+     */
+    int64_t getFramePosition() const;
+
 private:
     AudioQueue<float>& audioQueue;
     std::thread producerThread{};
 
     std::atomic<bool> stopProducer{false};
     std::atomic<int> seekSeconds{0};
+    std::atomic<int64_t> framePosition{0};
 };
@@ -10,10 +10,13 @@
 #include "audio/AudioPlayer.h"                   // for AudioPlayer
 #include "audio/AudioRecorder.h"                 // for AudioRecorder
 #include "audio/DeviceInfo.h"                    // for DeviceInfo
+#include "control/AudioFollowHighlight.h"        // for AudioFollowHighlight
 #include "control/Control.h"                     // for Control
 #include "control/settings/Settings.h"           // for Settings
 #include "gui/MainWindow.h"                      // for MainWindow
 #include "gui/toolbarMenubar/ToolMenuHandler.h"  // for ToolMenuHandler
+#include "model/AudioIndex.h"                    // for AudioIndex
+#include "model/Document.h"                      // for Document
 #include "util/XojMsgBox.h"                      // for XojMsgBox
 #include "util/i18n.h"                           // for _
 
@@ -25,9 +28,10 @@ AudioController::AudioController(Settings* settings, Control* control):
         settings(*settings),
         control(*control),
         audioRecorder(std::make_unique<AudioRecorder>(*settings)),
-        audioPlayer(std::make_unique<AudioPlayer>(*control, *settings)) {}
+        audioPlayer(std::make_unique<AudioPlayer>(*control, *settings)),
+        followHighlight(std::make_unique<AudioFollowHighlight>()) {}
 
-AudioController::~AudioController() = default;
+AudioController::~AudioController() { stopFollowTimer(); }
 
 
 auto AudioController::startRecording() -> bool {
@@ -84,6 +88,8 @@ auto AudioController::startPlayback(fs::path const& file, unsigned int timestamp
     bool status = this->audioPlayer->start(file, timestamp);
     if (status) {
         this->control.getWindow()->getToolMenuHandler()->enableAudioPlaybackButtons();
+        this->playbackFilename = file;
+        startFollowTimer();
     }
     return status;
 }
@@ -102,11 +108,61 @@ void AudioController::continuePlayback() {
     this->control.getWindow()->getToolMenuHandler()->setAudioPlaybackPaused(false);
 
     this->audioPlayer->play();
+    startFollowTimer();
 }
 
 void AudioController::stopPlayback() {
     this->control.getWindow()->getToolMenuHandler()->disableAudioPlaybackButtons();
     this->audioPlayer->stop();
+    stopFollowTimer();
+    this->followHighlight->clear();
+}
+
+void AudioController::setFollowPlayback(bool enabled) {
+    this->followPlayback = enabled;
+    if (enabled) {
+        startFollowTimer();
+    } else {
+        stopFollowTimer();
+        this->followHighlight->clear();
+    }
+}
+
+auto AudioController::isFollowingPlayback() const -> bool { return this->followPlayback; }
+
+auto AudioController::getFollowHighlight() const -> AudioFollowHighlight* { return this->followHighlight.get(); }
+
+void AudioController::startFollowTimer() {
+    if (this->followPlayback && this->followTimeout == 0 && this->audioPlayer->isPlaying()) {
+        this->followTimeout =
+                g_timeout_add(FOLLOW_INTERVAL, reinterpret_cast<GSourceFunc>(followPlaybackCallback), this);
+    }
+}
+
+void AudioController::stopFollowTimer() {
+    if (this->followTimeout) {
+        g_source_remove(this->followTimeout);
+        this->followTimeout = 0;
+    }
+}
+
+auto AudioController::followPlaybackCallback(AudioController* self) -> gboolean {
+    if (!self->audioPlayer->isPlaying()) {
+        // Paused or finished: keep the last highlight until the playback is stopped or continued
+        self->followTimeout = 0;
+        return G_SOURCE_REMOVE;
+    }
+
+    size_t position = self->audioPlayer->getPlaybackPosition();
+    size_t begin = position > FOLLOW_WINDOW ? position - FOLLOW_WINDOW : 0;
+
+    Document* doc = self->control.getDocument();
+    doc->lock();
+    auto entries = doc->getAudioIndex().findInRange(self->playbackFilename, begin, position + 1);
+    self->followHighlight->setHighlighted(entries);
+    doc->unlock();
+
+    return G_SOURCE_CONTINUE;
 }
 
 auto AudioController::getAudioFilename() const -> fs::path const& { return this->audioFilename; }
@@ -15,10 +15,12 @@
 #include <memory>   // for make_unique, unique_ptr
 #include <vector>   // for vector
 
+#include <glib.h>                         // for gboolean, guint
 #include <portaudiocpp/PortAudioCpp.hxx>  // for AutoSystem
 
 #include "filesystem.h"  // for path
 
+class AudioFollowHighlight;
 class AudioPlayer;
 class AudioRecorder;
 class Control;
@@ -43,12 +45,24 @@ public:
     void seekForwards();
     void seekBackwards();
 
+    /**
+     * Highlight the elements written at the current playback position while audio is playing
+     */
+    void setFollowPlayback(bool enabled);
+    bool isFollowingPlayback() const;
+    AudioFollowHighlight* getFollowHighlight() const;
+
     fs::path const& getAudioFilename() const;
     fs::path getAudioFolder() const;
     size_t getStartTime() const;
     std::vector<DeviceInfo> getOutputDevices() const;
     std::vector<DeviceInfo> getInputDevices() const;
 
+private:
+    void startFollowTimer();
+    void stopFollowTimer();
+    static gboolean followPlaybackCallback(AudioController* self);
+
 private:
     Settings& settings;
     Control& control;
@@ -63,4 +77,14 @@ private:
 
     fs::path audioFilename;
     size_t timestamp = 0;
+
+    fs::path playbackFilename;
+    bool followPlayback = false;
+    guint followTimeout = 0;
+    std::unique_ptr<AudioFollowHighlight> followHighlight;
+
+    /// Refresh interval of the playback highlight (ms)
+    static constexpr guint FOLLOW_INTERVAL = 100;
+    /// Elements written up to this long (ms) before the playback position are highlighted
+    static constexpr size_t FOLLOW_WINDOW = 3000;
 };
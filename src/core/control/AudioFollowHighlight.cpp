@@ -0,0 +1,49 @@
+#include "AudioFollowHighlight.h"
+
+#include <map>  // for map
+
+#include "model/AudioElement.h"  // for AudioElement
+#include "model/XojPage.h"       // for XojPage
+#include "util/Range.h"          // for Range
+#include "view/overlays/AudioFollowHighlightView.h"
+
+AudioFollowHighlight::AudioFollowHighlight():
+        viewPool(std::make_shared<xoj::util::DispatchPool<xoj::view::AudioFollowHighlightView>>()) {}
+
+AudioFollowHighlight::~AudioFollowHighlight() = default;
+
+void AudioFollowHighlight::setHighlighted(const std::vector<AudioIndexEntry>& entries) {
+    std::vector<Highlight> newHighlights;
+    newHighlights.reserve(entries.size());
+    for (const auto& e: entries) {
+        newHighlights.push_back({e.page.get(), e.element, e.element->boundingRect()});
+    }
+
+    if (newHighlights == this->highlights) {
+        return;
+    }
+
+    // Repaint the union of the old and the new highlights, page by page
+    std::map<const XojPage*, Range> dirty;
+    for (const auto& h: this->highlights) { dirty[h.page] = dirty[h.page].unite(Range(h.rect)); }
+    for (const auto& h: newHighlights) { dirty[h.page] = dirty[h.page].unite(Range(h.rect)); }
+
+    this->highlights = std::move(newHighlights);
+
+    for (auto& [page, rg]: dirty) {
+        rg.addPadding(xoj::view::AudioFollowHighlightView::PADDING);
+        this->viewPool->dispatch(xoj::view::AudioFollowHighlightView::HIGHLIGHT_CHANGED_NOTIFICATION, page, rg);
+    }
+}
+
+void AudioFollowHighlight::clear() { setHighlighted({}); }
+
+auto AudioFollowHighlight::getRectsOnPage(const XojPage* page) const -> std::vector<xoj::util::Rectangle<double>> {
+    std::vector<xoj::util::Rectangle<double>> rects;
+    for (const auto& h: this->highlights) {
+        if (h.page == page) {
+            rects.push_back(h.rect);
+        }
+    }
+    return rects;
+}
@@ -0,0 +1,63 @@
+/*
+ * Xournal++
+ *
+ * Highlights the elements written at the current audio playback position
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <memory>  // for shared_ptr
+#include <vector>  // for vector
+
+#include "model/AudioIndex.h"   // for AudioIndexEntry
+#include "model/OverlayBase.h"  // for OverlayBase
+#include "util/DispatchPool.h"  // for DispatchPool
+#include "util/Rectangle.h"     // for Rectangle
+
+class Element;
+class XojPage;
+
+namespace xoj::view {
+class AudioFollowHighlightView;
+};
+
+class AudioFollowHighlight: public OverlayBase {
+public:
+    AudioFollowHighlight();
+    ~AudioFollowHighlight() override;
+
+    /**
+     * Replaces the highlighted elements and flags the affected regions of the pages as dirty
+     */
+    void setHighlighted(const std::vector<AudioIndexEntry>& entries);
+
+    void clear();
+
+    /**
+     * @return The bounding boxes of the highlighted elements on the given page
+     */
+    std::vector<xoj::util::Rectangle<double>> getRectsOnPage(const XojPage* page) const;
+
+    const std::shared_ptr<xoj::util::DispatchPool<xoj::view::AudioFollowHighlightView>>& getViewPool() const {
+        return viewPool;
+    }
+
+private:
+    struct Highlight {
+        const XojPage* page;
+        const Element* element;
+        xoj::util::Rectangle<double> rect;
+
+        bool operator==(const Highlight& o) const { return page == o.page && element == o.element; }
+    };
+
+    /// Bounding boxes are copied so that drawing never touches elements which may have been deleted meanwhile
+    std::vector<Highlight> highlights;
+
+    std::shared_ptr<xoj::util::DispatchPool<xoj::view::AudioFollowHighlightView>> viewPool;
+};
@@ -0,0 +1,137 @@
+#include "BatchExport.h"
+
+#include <algorithm>  // for max
+#include <chrono>     // for steady_clock, duration_cast, milliseconds
+#include <exception>  // for exception
+#include <istream>    // for istream, getline
+#include <ostream>    // for ostream, flush
+#include <sstream>    // for ostringstream
+#include <thread>     // for thread
+#include <vector>     // for vector
+
+#include "control/xojfile/LoadHandler.h"  // for LoadHandler
+#include "model/Document.h"               // for Document
+#include "util/StringUtils.h"             // for StringUtils
+#include "util/i18n.h"                    // for _
+
+#include "ExportHelper.h"  // for exportImgToFile, exportPdfToFile
+#include "filesystem.h"    // for path, u8path
+
+using std::string;
+
+BatchExport::BatchExport(ExportBackgroundType exportBackground, bool progressiveMode, int pngDpi, int pngWidth,
+                         int pngHeight, size_t jobCount):
+        exportBackground(exportBackground),
+        progressiveMode(progressiveMode),
+        pngDpi(pngDpi),
+        pngWidth(pngWidth),
+        pngHeight(pngHeight),
+        jobCount(std::max<size_t>(1, jobCount)) {}
+
+auto BatchExport::nextJob(std::istream& manifest, Job& job) -> bool {
+    std::lock_guard lock(manifestMutex);
+    string line;
+    while (std::getline(manifest, line)) {
+        this->lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (StringUtils::trim(line).empty() || line[0] == '#') {
+            continue;
+        }
+
+        auto fields = StringUtils::split(line, '\t');
+        job = Job();
+        job.line = this->lineNumber;
+        job.input = fields[0];
+        job.output = fields.size() > 1 ? fields[1] : "";
+        job.range = fields.size() > 2 ? fields[2] : "";
+        job.layerRange = fields.size() > 3 ? fields[3] : "";
+        return true;
+    }
+    return false;
+}
+
+static auto millisecondsSince(std::chrono::steady_clock::time_point start) -> long {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+auto BatchExport::runJob(const Job& job) const -> Result {
+    Result result;
+    if (job.input.empty() || job.output.empty()) {
+        result.error = _("Invalid manifest line, expected: input<TAB>output[<TAB>range[<TAB>layer range]]");
+        return result;
+    }
+
+    auto output = fs::u8path(job.output);
+    auto extension = StringUtils::toLowerCase(output.extension().u8string());
+    if (extension != ".pdf" && extension != ".png" && extension != ".svg") {
+        result.error = _("Unsupported output format, use .pdf, .png or .svg");
+        return result;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        LoadHandler loader;
+        Document* doc = loader.loadDocument(fs::u8path(job.input));
+        result.loadMs = millisecondsSince(start);
+        if (doc == nullptr) {
+            result.error = loader.getLastError();
+            return result;
+        }
+        result.pages = doc->getPageCount();
+
+        const char* range = job.range.empty() ? nullptr : job.range.c_str();
+        const char* layerRange = job.layerRange.empty() ? nullptr : job.layerRange.c_str();
+
+        start = std::chrono::steady_clock::now();
+        if (extension == ".pdf") {
+            result.error = ExportHelper::exportPdfToFile(doc, output, range, layerRange, this->exportBackground,
+                                                         this->progressiveMode);
+        } else {
+            result.error = ExportHelper::exportImgToFile(doc, output, range, layerRange, this->pngDpi, this->pngWidth,
+                                                         this->pngHeight, this->exportBackground);
+        }
+        result.exportMs = millisecondsSince(start);
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    } catch (...) {
+        result.error = _("Unknown exception");
+    }
+    return result;
+}
+
+void BatchExport::report(std::ostream& out, const Job& job, const Result& result) {
+    std::ostringstream line;
+    line << "{\"line\":" << job.line;
+    line << ",\"input\":\"" << StringUtils::escapeJson(job.input) << "\"";
+    line << ",\"output\":\"" << StringUtils::escapeJson(job.output) << "\"";
+    if (result.error.empty()) {
+        line << ",\"status\":\"ok\",\"pages\":" << result.pages;
+    } else {
+        line << ",\"status\":\"error\",\"error\":\"" << StringUtils::escapeJson(result.error) << "\"";
+    }
+    line << ",\"loadMs\":" << result.loadMs << ",\"exportMs\":" << result.exportMs << "}\n";
+
+    std::lock_guard lock(reportMutex);
+    if (!result.error.empty()) {
+        this->failed = true;
+    }
+    // Flush every line: the report is usually read by another process while the batch is running
+    out << line.str() << std::flush;
+}
+
+auto BatchExport::run(std::istream& manifest, std::ostream& out) -> int {
+    auto worker = [&]() {
+        Job job;
+        while (nextJob(manifest, job)) { report(out, job, runJob(job)); }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(this->jobCount);
+    for (size_t i = 0; i < this->jobCount; i++) { threads.emplace_back(worker); }
+    for (auto& t: threads) { t.join(); }
+
+    return this->failed ? 1 : 0;
+}
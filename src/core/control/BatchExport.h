@@ -0,0 +1,94 @@
+/*
+ * Xournal++
+ *
+ * Headless conversion of many documents in a single process
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <iosfwd>   // for istream, ostream
+#include <mutex>    // for mutex
+#include <string>   // for string
+
+#include "control/jobs/BaseExportJob.h"  // for ExportBackgroundType
+
+/**
+ * @brief Batch conversion mode of the command line (--batch-export=MANIFEST)
+ *
+ * The manifest contains one job per line:
+ *     input<TAB>output[<TAB>page range[<TAB>layer range]]
+ * Empty lines and lines starting with '#' are ignored. The output format is guessed from the extension of the output
+ * (.pdf, .png or .svg), the other export settings are shared by all jobs. The manifest is read lazily, so it can be a
+ * pipe fed by another process while the conversions run.
+ *
+ * The jobs run on a pool of worker threads. Every worker loads and exports one document at a time, so at most
+ * `jobCount` documents are in memory at once.
+ *
+ * One JSON object per job is written to the report stream (JSON lines), in the order in which the jobs finish, e.g.
+ *     {"line":3,"input":"a.xopp","output":"a.pdf","status":"ok","pages":12,"loadMs":15,"exportMs":230}
+ *     {"line":4,"input":"b.xopp","output":"b.pdf","status":"error","error":"...","loadMs":1,"exportMs":0}
+ */
+class BatchExport {
+public:
+    BatchExport(ExportBackgroundType exportBackground, bool progressiveMode, int pngDpi, int pngWidth, int pngHeight,
+                size_t jobCount);
+
+public:
+    /**
+     * Runs all the jobs of the manifest and waits for their completion
+     * @return The exit code of the process: 0 if all jobs succeeded, 1 otherwise
+     */
+    int run(std::istream& manifest, std::ostream& out);
+
+private:
+    struct Job {
+        size_t line = 0;
+        std::string input;
+        std::string output;
+        std::string range;
+        std::string layerRange;
+    };
+
+    struct Result {
+        std::string error;
+        size_t pages = 0;
+        long loadMs = 0;
+        long exportMs = 0;
+    };
+
+    /**
+     * Reads the next job from the manifest. Thread safe.
+     * @return false at the end of the manifest
+     */
+    bool nextJob(std::istream& manifest, Job& job);
+
+    /**
+     * Loads and exports the document of a job. Can be called concurrently for different jobs.
+     */
+    Result runJob(const Job& job) const;
+
+    /**
+     * Writes the report line of a job. Thread safe.
+     */
+    void report(std::ostream& out, const Job& job, const Result& result);
+
+private:
+    ExportBackgroundType exportBackground;
+    bool progressiveMode;
+    int pngDpi;
+    int pngWidth;
+    int pngHeight;
+    size_t jobCount;
+
+    std::mutex manifestMutex;
+    size_t lineNumber = 0;  ///< Guarded by manifestMutex
+
+    std::mutex reportMutex;
+    bool failed = false;  ///< Guarded by reportMutex
+};
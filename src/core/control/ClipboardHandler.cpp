@@ -1,8 +1,10 @@
 #include "ClipboardHandler.h"
 
-#include <set>      // for multiset, operator!=
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <algorithm>  // for max
+#include <cmath>      // for sqrt
+#include <set>        // for multiset, operator!=
+#include <utility>    // for move
+#include <vector>     // for vector
 
 #include <cairo-svg.h>    // for cairo_svg_surface_c...
 #include <cairo.h>        // for cairo_create, cairo...
@@ -10,6 +12,7 @@
 
 #include "control/tools/EditSelection.h"          // for EditSelection
 #include "model/Element.h"                        // for Element, ELEMENT_TEXT
+#include "model/ElementContainer.h"               // for ElementContainer
 #include "model/Text.h"                           // for Text
 #include "util/Util.h"                            // for DPI_NORMALIZATION_F...
 #include "util/pixbuf-utils.h"                    // for xoj_pixbuf_get_from...
@@ -84,21 +87,44 @@ auto ElementCompareFunc(Element* a, Element* b) -> bool {
 static GdkAtom atomSvg1 = gdk_atom_intern_static_string("image/svg");
 static GdkAtom atomSvg2 = gdk_atom_intern_static_string("image/svg+xml");
 
-// The contents of the clipboard
-class ClipboardContents {
+static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
+    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * Above this number of pixels, the image flavour is rendered at a lower resolution
+ */
+constexpr double MAX_IMAGE_PIXELS = 4096.0 * 4096.0;
+
+/**
+ * The contents of the clipboard.
+ *
+ * The image flavours (PNG and SVG) are only rendered when an application asks for them, from a copy of the selected
+ * elements, and are then kept for the following requests.
+ */
+class ClipboardContents: public ElementContainer {
 public:
-    ClipboardContents(string text, GdkPixbuf* image, string svg, GString* str) {
-        this->text = std::move(text);
-        this->image = image;
-        this->svg = std::move(svg);
-        this->str = str;
+    ClipboardContents(string text, GString* str, EditSelection* selection):
+            text(std::move(text)),
+            str(str),
+            x(selection->getOriginalXOnView()),
+            y(selection->getOriginalYOnView()),
+            width(selection->getWidth()),
+            height(selection->getHeight()) {
+        // The selection may be modified or deleted long before an application asks for an image
+        for (Element* e: selection->getElements()) { this->elements.push_back(e->clone()); }
     }
 
-    ~ClipboardContents() {
-        g_object_unref(this->image);
+    ~ClipboardContents() override {
+        for (Element* e: this->elements) { delete e; }
+        if (this->image) {
+            g_object_unref(this->image);
+        }
         g_string_free(this->str, true);
     }
 
+    auto getElements() const -> const std::vector<Element*>& override { return this->elements; }
 
     static void getFunction(GtkClipboard* clipboard, GtkSelectionData* selection, guint info,
                             ClipboardContents* contents) {
@@ -109,10 +135,13 @@ public:
         } else if (target == gdk_atom_intern_static_string("image/png") ||
                    target == gdk_atom_intern_static_string("image/jpeg") ||
                    target == gdk_atom_intern_static_string("image/gif")) {
-            gtk_selection_data_set_pixbuf(selection, contents->image);
+            if (GdkPixbuf* image = contents->getImage()) {
+                gtk_selection_data_set_pixbuf(selection, image);
+            }
         } else if (atomSvg1 == target || atomSvg2 == target) {
-            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(contents->svg.c_str()),
-                                   static_cast<gint>(contents->svg.length()));
+            const string& svg = contents->getSvg();
+            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(svg.c_str()),
+                                   static_cast<gint>(svg.length()));
         } else if (atomXournal == target) {
             gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar*>(contents->str->str),
                                    static_cast<gint>(contents->str->len));
@@ -121,17 +150,90 @@ public:
 
     static void clearFunction(GtkClipboard* clipboard, ClipboardContents* contents) { delete contents; }
 
+private:
+    auto getImage() -> GdkPixbuf* {
+        if (!this->image) {
+            this->image = renderImage();
+        }
+        return this->image;
+    }
+
+    auto getSvg() -> const string& {
+        if (!this->svgRendered) {
+            this->svg = renderSvg();
+            this->svgRendered = true;
+        }
+        return this->svg;
+    }
+
+    auto renderImage() const -> GdkPixbuf* {
+        double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
+        // Large selections are rendered at a lower resolution
+        double pixels = this->width * this->height * dpiFactor * dpiFactor;
+        if (pixels > MAX_IMAGE_PIXELS) {
+            dpiFactor *= std::sqrt(MAX_IMAGE_PIXELS / pixels);
+        }
+
+        int width = std::max(1, static_cast<int>(this->width * dpiFactor));
+        int height = std::max(1, static_cast<int>(this->height * dpiFactor));
+        cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+        if (cairo_surface_status(surfacePng) != CAIRO_STATUS_SUCCESS) {
+            g_warning("Unable to create a %i x %i image of the selection", width, height);
+            cairo_surface_destroy(surfacePng);
+            return nullptr;
+        }
+        cairo_t* crPng = cairo_create(surfacePng);
+        cairo_scale(crPng, dpiFactor, dpiFactor);
+
+        cairo_translate(crPng, -this->x, -this->y);
+
+        xoj::view::ElementContainerView view(this);
+        view.draw(xoj::view::Context::createDefault(crPng));
+
+        cairo_destroy(crPng);
+
+        GdkPixbuf* image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
+
+        cairo_surface_destroy(surfacePng);
+        return image;
+    }
+
+    auto renderSvg() const -> string {
+        GString* svgString = g_string_new(nullptr);
+
+        cairo_surface_t* surfaceSVG = cairo_svg_surface_create_for_stream(
+                reinterpret_cast<cairo_write_func_t>(svgWriteFunction), svgString, this->width, this->height);
+        cairo_t* crSVG = cairo_create(surfaceSVG);
+
+        cairo_translate(crSVG, -this->x, -this->y);
+        xoj::view::ElementContainerView view(this);
+        view.draw(xoj::view::Context::createDefault(crSVG));
+
+        cairo_surface_destroy(surfaceSVG);
+        cairo_destroy(crSVG);
+
+        string svg(svgString->str, svgString->len);
+        g_string_free(svgString, true);
+        return svg;
+    }
+
 private:
     string text;
-    GdkPixbuf* image;
-    string svg;
     GString* str;
-};
 
-static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
-    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
-    return CAIRO_STATUS_SUCCESS;
-}
+    /**
+     * Copy of the selected elements, and their bounds
+     */
+    std::vector<Element*> elements;
+    double x;
+    double y;
+    double width;
+    double height;
+
+    GdkPixbuf* image = nullptr;
+    string svg;
+    bool svgRendered = false;
+};
 
 auto ClipboardHandler::copy() -> bool {
     if (!this->selection) {
@@ -168,46 +270,6 @@ auto ClipboardHandler::copy() -> bool {
         text += t->getText();
     }
 
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: PNG
-    /////////////////////////////////////////////////////////////////
-
-    double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
-
-    int width = static_cast<int>(selection->getWidth() * dpiFactor);
-    int height = static_cast<int>(selection->getHeight() * dpiFactor);
-    cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-    cairo_t* crPng = cairo_create(surfacePng);
-    cairo_scale(crPng, dpiFactor, dpiFactor);
-
-    cairo_translate(crPng, -selection->getOriginalXOnView(), -selection->getOriginalYOnView());
-
-    xoj::view::ElementContainerView view(this->selection);
-    view.draw(xoj::view::Context::createDefault(crPng));
-
-    cairo_destroy(crPng);
-
-    GdkPixbuf* image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
-
-    cairo_surface_destroy(surfacePng);
-
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: SVG
-    /////////////////////////////////////////////////////////////////
-
-    GString* svgString = g_string_sized_new(1048576);  // 1MB
-
-    cairo_surface_t* surfaceSVG =
-            cairo_svg_surface_create_for_stream(reinterpret_cast<cairo_write_func_t>(svgWriteFunction), svgString,
-                                                selection->getWidth(), selection->getHeight());
-    cairo_t* crSVG = cairo_create(surfaceSVG);
-
-    cairo_translate(crSVG, -selection->getOriginalXOnView(), -selection->getOriginalYOnView());
-    view.draw(xoj::view::Context::createDefault(crSVG));
-
-    cairo_surface_destroy(surfaceSVG);
-    cairo_destroy(crSVG);
-
     /////////////////////////////////////////////////////////////////
     // copy to clipboard
     /////////////////////////////////////////////////////////////////
@@ -228,7 +290,7 @@ auto ClipboardHandler::copy() -> bool {
 
     targets = gtk_target_table_new_from_list(list, &n_targets);
 
-    auto* contents = new ClipboardContents(text, image, svgString->str, out.getStr());
+    auto* contents = new ClipboardContents(text, out.getStr(), this->selection);
 
     gtk_clipboard_set_with_data(this->clipboard, targets, static_cast<guint>(n_targets),
                                 reinterpret_cast<GtkClipboardGetFunc>(ClipboardContents::getFunction),
@@ -238,8 +300,6 @@ auto ClipboardHandler::copy() -> bool {
     gtk_target_table_free(targets, n_targets);
     gtk_target_list_unref(list);
 
-    g_string_free(svgString, true);
-
     return true;
 }
 
@@ -278,10 +338,15 @@ void ClipboardHandler::pasteClipboardImage(GtkClipboard* clipboard, GdkPixbuf* p
 
 void ClipboardHandler::pasteClipboardContents(GtkClipboard* clipboard, GtkSelectionData* selectionData,
                                               ClipboardHandler* handler) {
-    ObjectInputStream in;
+    const gint length = gtk_selection_data_get_length(selectionData);
+    if (length <= 0) {
+        return;
+    }
 
+    // The selection data is read in place, and remains valid until this callback returns
+    ObjectInputStream in;
     if (in.read(reinterpret_cast<const char*>(gtk_selection_data_get_data(selectionData)),
-                gtk_selection_data_get_length(selectionData))) {
+                static_cast<size_t>(length))) {
         handler->listener->clipboardPasteXournal(in);
     }
 }
@@ -16,6 +16,7 @@
 #include "control/RecentManager.h"                               // for Rece...
 #include "control/ScrollHandler.h"                               // for Scro...
 #include "control/SetsquareController.h"                         // for Sets...
+#include "control/ThumbnailCache.h"                              // for Thum...
 #include "control/Tool.h"                                        // for Tool
 #include "control/ToolHandler.h"                                 // for Tool...
 #include "control/jobs/AutosaveJob.h"                            // for Auto...
@@ -138,6 +139,7 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath): gtkApp
     this->scrollHandler = new ScrollHandler(this);
 
     this->scheduler = new XournalScheduler();
+    this->thumbnailCache = std::make_unique<ThumbnailCache>();
 
     this->doc = new Document(this);
 
@@ -1040,6 +1042,10 @@ void Control::actionPerformed(ActionType type, ActionGroup group, GtkToolButton*
             this->getAudioController()->stopPlayback();
             break;
 
+        case ACTION_AUDIO_FOLLOW_PLAYBACK:
+            this->getAudioController()->setFollowPlayback(enabled);
+            break;
+
         case ACTION_ROTATION_SNAPPING:
             rotationSnappingToggle();
             break;
@@ -1485,21 +1491,32 @@ void Control::appendNewPdfPages() {
         string msg = FS(_F("No pdf pages available to append. You may need to reopen the document first."));
         XojMsgBox::showErrorToUser(getGtkWindow(), msg);
     }
-    for (size_t i = 0; i != insertCount; ++i) {
-
-        doc->lock();
-        XojPdfPageSPtr pdf = doc->getPdfPage(currentPdfPageCount + i);
-        doc->unlock();
-
-        if (pdf) {
-            auto newPage = std::make_shared<XojPage>(pdf->getWidth(), pdf->getHeight());
-            newPage->setBackgroundPdfPageNr(currentPdfPageCount + i);
-            insertPage(newPage, pageCount + i);
-        } else {
-            string msg = FS(_F("Unable to retrieve pdf page."));  // should not happen
-            XojMsgBox::showErrorToUser(getGtkWindow(), msg);
+    size_t lastInserted = npos;
+    {
+        // The views, the sidebar and the layout are only updated once all the pages are inserted
+        PageBatch batch(this);
+        for (size_t i = 0; i != insertCount; ++i) {
+
+            doc->lock();
+            XojPdfPageSPtr pdf = doc->getPdfPage(currentPdfPageCount + i);
+            doc->unlock();
+
+            if (pdf) {
+                auto newPage = std::make_shared<XojPage>(pdf->getWidth(), pdf->getHeight());
+                newPage->setBackgroundPdfPageNr(currentPdfPageCount + i);
+                insertPage(newPage, pageCount + i, false);
+                lastInserted = pageCount + i;
+            } else {
+                string msg = FS(_F("Unable to retrieve pdf page."));  // should not happen
+                XojMsgBox::showErrorToUser(getGtkWindow(), msg);
+            }
         }
     }
+
+    if (lastInserted != npos) {
+        scrollHandler->scrollToPage(lastInserted);
+        firePageSelected(lastInserted);
+    }
 }
 
 void Control::insertPage(const PageRef& page, size_t position, bool shouldScrollToPage) {
@@ -2612,11 +2629,39 @@ void Control::unblock() {
     getCursor()->setCursorBusy(false);
     disableSidebarTmp(false);
 
-    gtk_widget_hide(this->statusbar);
+    if (this->backgroundProgressCount == 0) {
+        gtk_widget_hide(this->statusbar);
+    }
 
     this->isBlocking = false;
 }
 
+void Control::showBackgroundProgress(const string& name) {
+    this->backgroundProgressCount++;
+    if (this->isBlocking) {
+        // The status bar is already used by the blocking job
+        return;
+    }
+
+    this->statusbar = this->win->get("statusbar");
+    this->lbState = GTK_LABEL(this->win->get("lbState"));
+    this->pgState = GTK_PROGRESS_BAR(this->win->get("pgState"));
+
+    gtk_label_set_text(this->lbState, name.c_str());
+    gtk_progress_bar_set_fraction(this->pgState, 0);
+    gtk_widget_show(this->statusbar);
+
+    this->maxState = 100;
+}
+
+void Control::hideBackgroundProgress() {
+    if (this->backgroundProgressCount == 0 || --this->backgroundProgressCount > 0 || this->isBlocking) {
+        return;
+    }
+
+    gtk_widget_hide(this->statusbar);
+}
+
 void Control::setMaximumState(int max) { this->maxState = max; }
 
 void Control::setCurrentState(int state) {
@@ -3229,6 +3274,8 @@ auto Control::getToolHandler() const -> ToolHandler* { return this->toolHandler;
 
 auto Control::getScheduler() const -> XournalScheduler* { return this->scheduler; }
 
+auto Control::getThumbnailCache() const -> ThumbnailCache* { return this->thumbnailCache.get(); }
+
 auto Control::getWindow() const -> MainWindow* { return this->win; }
 
 auto Control::getGtkWindow() const -> GtkWindow* { return GTK_WINDOW(this->win->getWindow()); }
@@ -62,6 +62,7 @@ class ScrollHandler;
 class SearchBar;
 class Settings;
 class TextEditor;
+class ThumbnailCache;
 class XournalScheduler;
 class ZoomControl;
 
@@ -251,10 +252,19 @@ public:
     void disableSidebarTmp(bool disabled);
 
     XournalScheduler* getScheduler() const;
+    ThumbnailCache* getThumbnailCache() const;
 
     void block(const std::string& name);
     void unblock();
 
+    /**
+     * Shows the state label and the progress bar of the status bar without blocking the UI, for long running tasks
+     * which do not modify the document (e.g. background plugin workers). The progress is reported through the
+     * ProgressListener interface. Calls must be balanced with hideBackgroundProgress().
+     */
+    void showBackgroundProgress(const std::string& name);
+    void hideBackgroundProgress();
+
     void renameLastAutosaveFile();
     void setLastAutosaveFile(fs::path newAutosaveFile);
     void deleteLastAutosaveFile(fs::path newAutosaveFile);
@@ -434,6 +444,8 @@ private:
 
     XournalScheduler* scheduler;
 
+    std::unique_ptr<ThumbnailCache> thumbnailCache;
+
     /**
      * State / Blocking attributes
      */
@@ -442,6 +454,7 @@ private:
     GtkProgressBar* pgState = nullptr;
     int maxState = 0;
     bool isBlocking;
+    int backgroundProgressCount = 0;
 
     GladeSearchpath* gladeSearchPath;
 
@@ -39,6 +39,18 @@ auto exportImg(Document* doc, const char* output, const char* range, const char*
 
     fs::path const path(output);
 
+    std::string errorMsg = exportImgToFile(doc, path, range, layerRange, pngDpi, pngWidth, pngHeight, exportBackground);
+    if (!errorMsg.empty()) {
+        g_message("Error exporting image: %s\n", errorMsg.c_str());
+    }
+
+    g_message("%s", _("Image file successfully created"));
+
+    return 0;  // no error
+}
+
+auto exportImgToFile(Document* doc, const fs::path& path, const char* range, const char* layerRange, int pngDpi,
+                     int pngWidth, int pngHeight, ExportBackgroundType exportBackground) -> std::string {
     ExportGraphicsFormat format = EXPORT_GRAPHICS_PNG;
 
     if (path.extension() == ".svg") {
@@ -70,14 +82,7 @@ auto exportImg(Document* doc, const char* output, const char* range, const char*
 
     imgExport.exportGraphics(&progress);
 
-    std::string errorMsg = imgExport.getLastErrorMsg();
-    if (!errorMsg.empty()) {
-        g_message("Error exporting image: %s\n", errorMsg.c_str());
-    }
-
-    g_message("%s", _("Image file successfully created"));
-
-    return 0;  // no error
+    return imgExport.getLastErrorMsg();
 }
 
 /**
@@ -95,11 +100,23 @@ auto exportPdf(Document* doc, const char* output, const char* range, const char*
                ExportBackgroundType exportBackground, bool progressiveMode) -> int {
 
     GFile* file = g_file_new_for_commandline_arg(output);
+    auto path = fs::u8path(g_file_peek_path(file));
+    g_object_unref(file);
+
+    std::string errorMsg = exportPdfToFile(doc, path, range, layerRange, exportBackground, progressiveMode);
+    if (!errorMsg.empty()) {
+        g_error("%s", errorMsg.c_str());
+    }
+
+    g_message("%s", _("PDF file successfully created"));
+
+    return 0;  // no error
+}
 
+auto exportPdfToFile(Document* doc, const fs::path& path, const char* range, const char* layerRange,
+                     ExportBackgroundType exportBackground, bool progressiveMode) -> std::string {
     std::unique_ptr<XojPdfExport> pdfe = XojPdfExportFactory::createExport(doc, nullptr);
     pdfe->setExportBackground(exportBackground);
-    auto path = fs::u8path(g_file_peek_path(file));
-    g_object_unref(file);
 
     bool exportSuccess = 0;  // Return of the export job
 
@@ -115,12 +132,9 @@ auto exportPdf(Document* doc, const char* output, const char* range, const char*
     }
 
     if (!exportSuccess) {
-        g_error("%s", pdfe->getLastError().c_str());
+        return pdfe->getLastError();
     }
-
-    g_message("%s", _("PDF file successfully created"));
-
-    return 0;  // no error
+    return {};
 }
 
 }  // namespace ExportHelper
@@ -11,9 +11,12 @@
 
 #pragma once
 
+#include <string>  // for string
 
 #include "control/jobs/BaseExportJob.h"  // for ExportBackgroundType
 
+#include "filesystem.h"  // for path
+
 class Document;
 
 namespace ExportHelper {
@@ -38,6 +41,15 @@ namespace ExportHelper {
 int exportImg(Document* doc, const char* output, const char* range, const char* layerRange, int pngDpi, int pngWidth,
               int pngHeight, ExportBackgroundType exportBackground);
 
+/**
+ * @brief Same as exportImg, without logging
+ * @param path Path to the output file(s)
+ *
+ * @return An empty string on success, the error message otherwise
+ */
+std::string exportImgToFile(Document* doc, const fs::path& path, const char* range, const char* layerRange, int pngDpi,
+                            int pngWidth, int pngHeight, ExportBackgroundType exportBackground);
+
 /**
  * @brief Export the input file as pdf
  * @param doc Document to export
@@ -55,5 +67,14 @@ int exportImg(Document* doc, const char* output, const char* range, const char*
 int exportPdf(Document* doc, const char* output, const char* range, const char* layerRange,
               ExportBackgroundType exportBackground, bool progressiveMode);
 
+/**
+ * @brief Same as exportPdf, without logging and without aborting on failure
+ * @param path Path to the output file
+ *
+ * @return An empty string on success, the error message otherwise
+ */
+std::string exportPdfToFile(Document* doc, const fs::path& path, const char* range, const char* layerRange,
+                            ExportBackgroundType exportBackground, bool progressiveMode);
+
 
 }  // namespace ExportHelper
@@ -11,6 +11,7 @@
 
 #include "control/settings/Settings.h"  // for Settings
 #include "pdf/base/XojPdfDocument.h"    // for XojPdfDocument
+#include "util/Tracing.h"               // for XOJ_TRACE_SCOPE, counter
 #include "util/i18n.h"                  // for _
 
 class PdfCacheEntry {
@@ -95,6 +96,7 @@ PdfCacheEntry* PdfCache::cache(XojPdfPageSPtr popplerPage, cairo_surface_t* img,
 }
 
 void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight) {
+    XOJ_TRACE_SCOPE("PdfCache::render");
     std::lock_guard<std::mutex> lock(this->renderMutex);
 
     PdfCacheEntry* cacheResult = lookup(pdfPageNo);
@@ -110,6 +112,9 @@ void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWid
         needsRefresh = (zoom > 1.0 && percentZoomChange > this->zoomRefreshThreshold);
     }
 
+    (needsRefresh ? this->misses : this->hits)++;
+    xoj::util::trace::counter("PdfCache", {{"hits", this->hits}, {"misses", this->misses}});
+
     if (needsRefresh) {
         double renderZoom = std::max(zoom, 1.0);
 
@@ -85,4 +85,10 @@ private:
     std::list<PdfCacheEntry*>::size_type size = 0;
 
     double zoomRefreshThreshold;
+
+    /**
+     * Number of renderings which could use the cache, or not. Only used for the tracing.
+     */
+    size_t hits = 0;
+    size_t misses = 0;
 };
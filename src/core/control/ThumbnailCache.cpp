@@ -0,0 +1,215 @@
+#include "ThumbnailCache.h"
+
+#include <algorithm>  // for sort
+#include <vector>     // for vector
+
+#include <gdk-pixbuf/gdk-pixbuf.h>  // for gdk_pixbuf_get_byte_length
+#include <glib.h>                   // for GChecksum, g_checksum_new
+
+#include "gui/Shadow.h"                           // for Shadow
+#include "model/BackgroundImage.h"                // for BackgroundImage
+#include "model/Document.h"                       // for Document
+#include "model/Element.h"                        // for Element, ELEMENT_STROKE
+#include "model/Layer.h"                          // for Layer
+#include "model/PageType.h"                       // for PageType
+#include "model/Stroke.h"                         // for Stroke
+#include "model/XojPage.h"                        // for XojPage
+#include "util/PathUtil.h"                        // for getCacheSubfolder
+#include "util/serializing/BinObjectEncoding.h"   // for BinObjectEncoding
+#include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
+
+/**
+ * Bump when the layout of the previews or the content of the key changes
+ */
+constexpr auto THUMBNAIL_FORMAT = "xournalpp-thumbnail-1";
+
+ThumbnailCache::ThumbnailCache(): folder(Util::getCacheSubfolder("thumbnails")) {}
+
+ThumbnailCache::~ThumbnailCache() = default;
+
+void ThumbnailCache::setPreviewZoom(double zoom) { this->previewZoom = zoom; }
+
+auto ThumbnailCache::getPreviewZoom() const -> double { return this->previewZoom; }
+
+auto ThumbnailCache::getPreviewSize(const PageRef& page, double zoom) -> std::pair<int, int> {
+    int border = Shadow::getShadowBottomRightSize() + Shadow::getShadowTopLeftSize() + 4;
+    return {static_cast<int>(page->getWidth() * zoom + border), static_cast<int>(page->getHeight() * zoom + border)};
+}
+
+/**
+ * Identifies the content of a background file without reading it. Files attached to the document (PDF or images
+ * stored in the .xopp archive) are identified by the document file.
+ * @return false if the file cannot be identified
+ */
+static auto writeFileIdentity(ObjectOutputStream& out, Document* doc, const fs::path& file) -> bool {
+    std::error_code ec;
+    fs::path identified = file;
+    if (!fs::is_regular_file(identified, ec)) {
+        identified = doc->getFilepath();
+        if (identified.empty() || !fs::is_regular_file(identified, ec)) {
+            return false;
+        }
+    }
+
+    auto size = fs::file_size(identified, ec);
+    auto time = fs::last_write_time(identified, ec);
+    if (ec) {
+        return false;
+    }
+    out.writeString(identified.u8string());
+    out.writeString(file.u8string());
+    out.writeSizeT(static_cast<size_t>(size));
+    out.writeSizeT(static_cast<size_t>(time.time_since_epoch().count()));
+    return true;
+}
+
+auto ThumbnailCache::serializeContent(Document* doc, const PageRef& page, int width, int height, double zoom)
+        -> std::optional<std::string> {
+    ObjectOutputStream out(new BinObjectEncoding());
+    out.writeString(THUMBNAIL_FORMAT);
+    out.writeInt(width);
+    out.writeInt(height);
+    out.writeDouble(zoom);
+
+    out.writeDouble(page->getWidth());
+    out.writeDouble(page->getHeight());
+    PageType bgType = page->getBackgroundType();
+    out.writeInt(static_cast<int>(bgType.format));
+    out.writeString(bgType.config);
+    out.writeSizeT(uint32_t(page->getBackgroundColor()));
+
+    if (bgType.isPdfPage()) {
+        out.writeSizeT(page->getPdfPageNr());
+        if (!writeFileIdentity(out, doc, doc->getPdfFilepath())) {
+            return std::nullopt;
+        }
+    } else if (bgType.isImagePage()) {
+        BackgroundImage& img = page->getBackgroundImage();
+        if (img.isEmpty() || !writeFileIdentity(out, doc, img.getFilepath())) {
+            return std::nullopt;
+        }
+    }
+
+    for (Layer* l: *page->getLayers()) {
+        if (!l->isVisible()) {
+            out.writeInt(0);
+            continue;
+        }
+        out.writeInt(1);
+        for (Element* e: l->getElements()) {
+            if (e->getType() == ELEMENT_STROKE && static_cast<Stroke*>(e)->getErasable() != nullptr) {
+                // Drawn differently until the erasing is finished
+                return std::nullopt;
+            }
+            e->serialize(out);
+        }
+    }
+
+    GString* data = out.getStr();
+    return std::string(data->str, data->len);
+}
+
+auto ThumbnailCache::hashContent(const std::string& content) -> std::string {
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(content.data()), static_cast<gssize>(content.size()));
+    std::string key = g_checksum_get_string(checksum);
+    g_checksum_free(checksum);
+    return key;
+}
+
+auto ThumbnailCache::getFile(const std::string& key) const -> fs::path { return this->folder / (key + ".png"); }
+
+auto ThumbnailCache::contains(const std::string& key) const -> bool {
+    std::error_code ec;
+    return fs::exists(getFile(key), ec);
+}
+
+auto ThumbnailCache::load(const std::string& key) -> cairo_surface_t* {
+    std::call_once(this->pruneFlag, [this]() { prune(); });
+
+    auto file = getFile(key);
+    std::error_code ec;
+    if (!fs::exists(file, ec)) {
+        return nullptr;
+    }
+
+    cairo_surface_t* preview = cairo_image_surface_create_from_png(file.u8string().c_str());
+    if (cairo_surface_status(preview) != CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(preview);
+        fs::remove(file, ec);
+        return nullptr;
+    }
+
+    // The modification time is used to find the least recently used previews
+    fs::last_write_time(file, fs::file_time_type::clock::now(), ec);
+    return preview;
+}
+
+void ThumbnailCache::store(const std::string& key, cairo_surface_t* preview) {
+    auto file = getFile(key);
+    auto tmpFile = fs::path(file) += ".tmp";
+
+    std::error_code ec;
+    if (cairo_surface_write_to_png(preview, tmpFile.u8string().c_str()) != CAIRO_STATUS_SUCCESS) {
+        fs::remove(tmpFile, ec);
+        return;
+    }
+    // Rename, so that an interrupted write never leaves a truncated preview
+    fs::rename(tmpFile, file, ec);
+    if (ec) {
+        fs::remove(tmpFile, ec);
+    }
+}
+
+auto ThumbnailCache::createPreviewFromBuffer(cairo_surface_t* pageBuffer, const PageRef& page, double zoom)
+        -> cairo_surface_t* {
+    auto [width, height] = getPreviewSize(page, zoom);
+    cairo_surface_t* preview = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(preview);
+
+    // Same layout as in PreviewJob
+    cairo_translate(cr, Shadow::getShadowTopLeftSize() + 2, Shadow::getShadowTopLeftSize() + 2);
+    cairo_scale(cr, zoom, zoom);
+    cairo_rectangle(cr, 0, 0, page->getWidth(), page->getHeight());
+    cairo_clip(cr);
+
+    cairo_set_source_surface(cr, pageBuffer, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    return preview;
+}
+
+void ThumbnailCache::prune() {
+    struct Entry {
+        fs::file_time_type time;
+        std::uintmax_t size;
+        fs::path path;
+    };
+    std::vector<Entry> entries;
+    std::uintmax_t total = 0;
+
+    std::error_code ec;
+    for (const auto& f: fs::directory_iterator(this->folder, ec)) {
+        if (!f.is_regular_file(ec)) {
+            continue;
+        }
+        Entry e{f.last_write_time(ec), f.file_size(ec), f.path()};
+        total += e.size;
+        entries.push_back(std::move(e));
+    }
+    if (total <= MAX_CACHE_SIZE) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    for (const Entry& e: entries) {
+        if (total <= MAX_CACHE_SIZE) {
+            break;
+        }
+        if (fs::remove(e.path, ec)) {
+            total -= e.size;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Xournal++
+ *
+ * On-disk cache of the page previews of the sidebar
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>    // for atomic
+#include <cstdint>   // for uintmax_t
+#include <mutex>     // for once_flag
+#include <optional>  // for optional
+#include <string>    // for string
+#include <utility>   // for pair
+
+#include <cairo.h>  // for cairo_surface_t
+
+#include "model/PageRef.h"  // for PageRef
+
+#include "filesystem.h"  // for path
+
+class Document;
+
+/**
+ * @brief Persistent cache of the sidebar page previews, so that they appear instantly when a document is reopened.
+ *
+ * A preview is stored as a PNG file named after a hash of everything that is drawn on the page (format, background,
+ * visible layers and the serialized elements) and of the preview size. Pages whose content did not change hit the
+ * cache, so only the modified pages are rendered again, whichever document they belong to.
+ *
+ * The cache is filled by PreviewJob, and by RenderJob from the buffer of the main view when a whole page has just been
+ * rendered there. The least recently used files are removed once the cache grows over MAX_CACHE_SIZE.
+ *
+ * All methods except setPreviewZoom() are meant to be called from the scheduler thread.
+ */
+class ThumbnailCache {
+public:
+    ThumbnailCache();
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+    ~ThumbnailCache();
+
+public:
+    /**
+     * Zoom of the page previews shown in the sidebar, or 0 if there are none. Set from the main thread.
+     */
+    void setPreviewZoom(double zoom);
+    double getPreviewZoom() const;
+
+    /**
+     * @return The size in pixels of the buffer of a page preview (see SidebarPreviewBaseEntry)
+     */
+    static std::pair<int, int> getPreviewSize(const PageRef& page, double zoom);
+
+    /**
+     * Serializes what is drawn on a page preview. The document must be locked. The cache key is then computed from
+     * the content with hashContent(), without holding the lock.
+     * @return nullopt if the content of the page cannot be cached (e.g. a stroke is being erased)
+     */
+    static std::optional<std::string> serializeContent(Document* doc, const PageRef& page, int width, int height,
+                                                       double zoom);
+    static std::string hashContent(const std::string& content);
+
+    /**
+     * @return A new surface with the cached preview, or nullptr if it is not cached
+     */
+    cairo_surface_t* load(const std::string& key);
+
+    bool contains(const std::string& key) const;
+
+    void store(const std::string& key, cairo_surface_t* preview);
+
+    /**
+     * Creates a preview from a page buffer with the device scale set to the zoom of the buffer (see RenderJob)
+     * @return A new surface of size getPreviewSize(page, zoom), with the same layout as the ones drawn by PreviewJob
+     */
+    static cairo_surface_t* createPreviewFromBuffer(cairo_surface_t* pageBuffer, const PageRef& page, double zoom);
+
+    static constexpr std::uintmax_t MAX_CACHE_SIZE = 128 * 1024 * 1024;
+
+private:
+    fs::path getFile(const std::string& key) const;
+
+    /**
+     * Removes the least recently used previews if the cache is bigger than MAX_CACHE_SIZE
+     */
+    void prune();
+
+private:
+    fs::path folder;
+    std::atomic<double> previewZoom{0};
+    std::once_flag pruneFlag;
+};
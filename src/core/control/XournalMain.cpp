@@ -3,9 +3,9 @@
 #include <algorithm>  // for copy, sort, max
 #include <array>      // for array
 #include <clocale>    // for setlocale, LC_NUMERIC
-#include <cstdio>     // for printf
 #include <cstdlib>    // for exit, size_t
 #include <exception>  // for exception
+#include <fstream>    // for ifstream
 #include <iostream>   // for operator<<, endl, basic_...
 #include <locale>     // for locale
 #include <memory>     // for unique_ptr, allocator
@@ -30,16 +30,20 @@
 #include "gui/GladeSearchpath.h"             // for GladeSearchpath
 #include "gui/MainWindow.h"                  // for MainWindow
 #include "gui/XournalView.h"                 // for XournalView
+#include "gui/widgets/FrameTimingMonitor.h"  // for FrameTimingMonitor
+#include "gui/widgets/XournalWidget.h"       // for GTK_XOURNAL
 #include "model/Document.h"                  // for Document
 #include "undo/EmergencySaveRestore.h"       // for EmergencySaveRestore
 #include "undo/UndoRedoHandler.h"            // for UndoRedoHandler
 #include "util/PathUtil.h"                   // for getConfigFolder, openFil...
 #include "util/PlaceholderString.h"          // for PlaceholderString
 #include "util/Stacktrace.h"                 // for Stacktrace
+#include "util/Tracing.h"                    // for start, stop
 #include "util/Util.h"                       // for execInUiThread
 #include "util/XojMsgBox.h"                  // for XojMsgBox
 #include "util/i18n.h"                       // for _, FS, _F
 
+#include "BatchExport.h"   // for BatchExport
 #include "Control.h"       // for Control
 #include "ExportHelper.h"  // for exportImg, exportPdf
 #include "config-dev.h"    // for ERRORLOG_DIR
@@ -291,6 +295,34 @@ auto exportPdf(const char* input, const char* output, const char* range, const c
     return ExportHelper::exportPdf(doc, output, range, layerRange, exportBackground, progressiveMode);
 }
 
+/**
+ * @brief Convert all the documents listed in a manifest, see BatchExport
+ * @param manifest Path to the manifest, or "-" to read it from the standard input
+ * @param jobs Number of documents converted concurrently. Non positive values select a default
+ *
+ * The report is written to the standard output, one JSON object per job.
+ *
+ * @return The exit code of the process: 0 on success, 1 if any job failed, 2 on failure opening the manifest.
+ *         Never negative, as GApplication would then start the user interface.
+ */
+auto batchExport(const char* manifest, int jobs, int pngDpi, int pngWidth, int pngHeight,
+                 ExportBackgroundType exportBackground, bool progressiveMode) -> int {
+    // Every export already renders its pages in parallel: by default, only overlap the loading of the documents
+    size_t jobCount = jobs > 0 ? static_cast<size_t>(jobs) : 2;
+    BatchExport batch(exportBackground, progressiveMode, pngDpi, pngWidth, pngHeight, jobCount);
+
+    if (std::string(manifest) == "-") {
+        return batch.run(std::cin, std::cout);
+    }
+
+    std::ifstream in(fs::u8path(manifest));
+    if (!in.is_open()) {
+        g_warning("%s", FS(_F("Could not open the batch manifest \"{1}\"") % manifest).c_str());
+        return 2;
+    }
+    return batch.run(in, std::cout);
+}
+
 struct XournalMainPrivate {
     XournalMainPrivate() = default;
     XournalMainPrivate(XournalMainPrivate&&) = delete;
@@ -302,6 +334,8 @@ struct XournalMainPrivate {
         g_strfreev(optFilename);
         g_free(pdfFilename);
         g_free(imgFilename);
+        g_free(batchManifest);
+        g_free(traceFile);
     }
 
     gchar** optFilename{};
@@ -317,6 +351,10 @@ struct XournalMainPrivate {
     gboolean exportNoBackground = false;
     gboolean exportNoRuling = false;
     gboolean progressiveMode = false;
+    gchar* batchManifest{};
+    int batchJobs = 0;
+    gchar* traceFile{};
+    gboolean showFrameTiming = false;
     std::unique_ptr<GladeSearchpath> gladePath;
     std::unique_ptr<Control> control;
     std::unique_ptr<MainWindow> win;
@@ -415,6 +453,10 @@ void on_open_files(GApplication*, gpointer, gint, gchar*, XMPtr) {
 }
 
 void on_startup(GApplication* application, XMPtr app_data) {
+    if (app_data->traceFile) {
+        xoj::util::trace::start(Util::fromGFilename(app_data->traceFile, false));
+    }
+
     initLocalisation();
     ensure_input_model_compatibility();
     const MigrateResult migrateResult = migrateSettings();
@@ -475,6 +517,10 @@ void on_startup(GApplication* application, XMPtr app_data) {
 
     app_data->win->show(nullptr);
 
+    if (app_data->showFrameTiming) {
+        GTK_XOURNAL(app_data->win->getXournal()->getWidget())->frameTiming->setHudVisible(true);
+    }
+
     bool opened = false;
     if (app_data->optFilename) {
         if (g_strv_length(app_data->optFilename) != 1) {
@@ -539,7 +585,6 @@ auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gi
 
     auto exec_guarded = [&](auto&& fun, auto&& s) {
         try {
-            printf("trying\n");
             return fun();
         } catch (const std::exception& e) {
             std::cerr << "Error: " << e.what() << std::endl;
@@ -583,6 +628,18 @@ auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gi
                 },
                 "exportImg");
     }
+    if (app_data->batchManifest) {
+        return exec_guarded(
+                [&] {
+                    return batchExport(app_data->batchManifest, app_data->batchJobs, app_data->exportPngDpi,
+                                       app_data->exportPngWidth, app_data->exportPngHeight,
+                                       app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
+                                       app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
+                                                                      EXPORT_BACKGROUND_ALL,
+                                       app_data->progressiveMode);
+                },
+                "batchExport");
+    }
     return -1;
 }
 
@@ -590,6 +647,10 @@ void on_shutdown(GApplication*, XMPtr app_data) {
     app_data->control->saveSettings();
     app_data->win->getXournal()->clearSelection();
     app_data->control->getScheduler()->stop();
+
+    if (app_data->traceFile && xoj::util::trace::stop()) {
+        g_message("Trace written to %s", app_data->traceFile);
+    }
 }
 
 }  // namespace
@@ -611,6 +672,13 @@ auto XournalMain::run(int argc, char** argv) -> int {
                                        "<input>", nullptr},
                           GOptionEntry{"version", 0, 0, G_OPTION_ARG_NONE, &app_data.showVersion,
                                        _("Get version of xournalpp"), nullptr},
+                          GOptionEntry{"trace", 0, 0, G_OPTION_ARG_FILENAME, &app_data.traceFile,
+                                       _("Record the timings of the rendering and of the input handling to FILE\n"
+                                         "                                 in the Chrome trace-event JSON format"),
+                                       "FILE"},
+                          GOptionEntry{"show-frame-timing", 0, 0, G_OPTION_ARG_NONE, &app_data.showFrameTiming,
+                                       _("Show the frame time and the input-to-paint latency over the pages"),
+                                       nullptr},
                           GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
     g_application_add_main_option_entries(G_APPLICATION(app), options.data());
 
@@ -664,6 +732,14 @@ auto XournalMain::run(int argc, char** argv) -> int {
                       "                                 No effect without -i/--create-img=foo.png\n"
                       "                                 Ignored if --export-png-dpi or --export-png-width is used"),
                     "N"},
+            GOptionEntry{"batch-export", 0, 0, G_OPTION_ARG_FILENAME, &app_data.batchManifest,
+                         _("Convert all the files listed in MANIFEST without opening a window\n"
+                           "                                 One line per job: IN<TAB>OUT[<TAB>RANGE[<TAB>LAYERS]]\n"
+                           "                                 Use - to read the jobs from the standard input.\n"
+                           "                                 A JSON report line is printed for every job"),
+                         "MANIFEST"},
+            GOptionEntry{"batch-jobs", 0, 0, G_OPTION_ARG_INT, &app_data.batchJobs,
+                         _("Number of files converted concurrently by --batch-export. Default is 2"), "N"},
             GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
     GOptionGroup* exportGroup = g_option_group_new("export", _("Advanced export options"),
                                                    _("Display advanced export options"), nullptr, nullptr);
@@ -3,6 +3,7 @@
 #include <cmath>    // for round
 #include <cstddef>  // for size_t
 #include <memory>   // for __shared_ptr_access, allocat...
+#include <mutex>    // for lock_guard
 #include <utility>  // for move
 #include <vector>   // for vector
 
@@ -21,6 +22,7 @@
 #include "view/View.h"
 #include "view/background/BackgroundView.h"
 
+#include "ParallelExport.h"    // for orderedFor, getThreadCount
 #include "ProgressListener.h"  // for ProgressListener
 
 using std::string;
@@ -63,7 +65,15 @@ void ImageExport::setLayerRange(const char* rangeStr) {
  * @brief Get the last error message
  * @return The last error message to show to the user
  */
-auto ImageExport::getLastErrorMsg() const -> string { return lastError; }
+auto ImageExport::getLastErrorMsg() const -> string {
+    std::lock_guard lock(lastErrorMutex);
+    return lastError;
+}
+
+void ImageExport::setLastError(std::string msg) {
+    std::lock_guard lock(lastErrorMutex);
+    this->lastError = std::move(msg);
+}
 
 /**
  * @brief Create Cairo surface for a given page
@@ -71,41 +81,43 @@ auto ImageExport::getLastErrorMsg() const -> string { return lastError; }
  * @param height the height of the page being exported
  * @param id the id of the page being exported
  * @param zoomRatio the zoom ratio for PNG exports with fixed DPI
+ * @param target Receives the created surface and context
  *
  * @return the zoom ratio of the current page if the export type is PNG, 0.0 otherwise
  *          The return value may differ from that of the parameter zoomRatio if the export has fixed page width or
  * height (in pixels). In this case, the zoomRatio (and the DPI) is page-dependent as soon as the document has pages of
  * different sizes.
  */
-auto ImageExport::createSurface(double width, double height, size_t id, double zoomRatio) -> double {
+auto ImageExport::createSurface(double width, double height, size_t id, double zoomRatio, PageSurface& target)
+        -> double {
     switch (this->format) {
         case EXPORT_GRAPHICS_PNG:
             switch (this->qualityParameter.getQualityCriterion()) {
                 case EXPORT_QUALITY_WIDTH:
                     zoomRatio = ((double)this->qualityParameter.getValue()) / width;
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->qualityParameter.getValue(),
-                                                               (int)std::round(height * zoomRatio));
+                    target.surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->qualityParameter.getValue(),
+                                                                (int)std::round(height * zoomRatio));
                     break;
                 case EXPORT_QUALITY_HEIGHT:
                     zoomRatio = ((double)this->qualityParameter.getValue()) / height;
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
-                                                               this->qualityParameter.getValue());
+                    target.surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
+                                                                this->qualityParameter.getValue());
                     break;
                 case EXPORT_QUALITY_DPI:  // Use the zoomRatio given as argument
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
-                                                               (int)std::round(height * zoomRatio));
+                    target.surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
+                                                                (int)std::round(height * zoomRatio));
                     break;
             }
-            this->cr = cairo_create(this->surface);
-            cairo_scale(this->cr, zoomRatio, zoomRatio);
+            target.cr = cairo_create(target.surface);
+            cairo_scale(target.cr, zoomRatio, zoomRatio);
             return zoomRatio;
         case EXPORT_GRAPHICS_SVG:
-            this->surface = cairo_svg_surface_create(getFilenameWithNumber(id).u8string().c_str(), width, height);
-            cairo_svg_surface_restrict_to_version(this->surface, CAIRO_SVG_VERSION_1_2);
-            this->cr = cairo_create(this->surface);
+            target.surface = cairo_svg_surface_create(getFilenameWithNumber(id).u8string().c_str(), width, height);
+            cairo_svg_surface_restrict_to_version(target.surface, CAIRO_SVG_VERSION_1_2);
+            target.cr = cairo_create(target.surface);
             break;
         default:
-            this->lastError = _("Unsupported graphics format: ") + std::to_string(this->format);
+            setLastError(_("Unsupported graphics format: ") + std::to_string(this->format));
     }
     return 0.0;
 }
@@ -113,15 +125,16 @@ auto ImageExport::createSurface(double width, double height, size_t id, double z
 /**
  * Free / store the surface
  */
-auto ImageExport::freeSurface(size_t id) -> bool {
-    cairo_destroy(this->cr);
+auto ImageExport::freeSurface(size_t id, PageSurface& target) -> bool {
+    cairo_destroy(target.cr);
 
     cairo_status_t status = CAIRO_STATUS_SUCCESS;
     if (format == EXPORT_GRAPHICS_PNG) {
         auto filepath = getFilenameWithNumber(id);
-        status = cairo_surface_write_to_png(surface, filepath.u8string().c_str());
+        status = cairo_surface_write_to_png(target.surface, filepath.u8string().c_str());
     }
-    cairo_surface_destroy(surface);
+    cairo_surface_destroy(target.surface);
+    target = PageSurface();
 
     // we ignore this problem
     return status == CAIRO_STATUS_SUCCESS;
@@ -153,46 +166,54 @@ auto ImageExport::getFilenameWithNumber(size_t no) const -> fs::path {
  * @param id The number of the page being exported
  * @param zoomRatio The zoom ratio for PNG exports with fixed DPI
  * @param format The format of the exported image
- * @param view A DocumentView for drawing the page
  */
-void ImageExport::exportImagePage(size_t pageId, size_t id, double zoomRatio, ExportGraphicsFormat format,
-                                  DocumentView& view) {
+void ImageExport::exportImagePage(size_t pageId, size_t id, double zoomRatio, ExportGraphicsFormat format) {
     doc->lock();
     PageRef page = doc->getPage(pageId);
     doc->unlock();
 
-    zoomRatio = createSurface(page->getWidth(), page->getHeight(), id, zoomRatio);
+    PageSurface target;
+    zoomRatio = createSurface(page->getWidth(), page->getHeight(), id, zoomRatio, target);
 
-    cairo_status_t state = cairo_surface_status(this->surface);
-    if (state != CAIRO_STATUS_SUCCESS) {
-        this->lastError = _("Error save image #1");
+    if (target.surface == nullptr) {
+        // Unsupported format, the error is already set
+        return;
+    }
+    if (cairo_surface_status(target.surface) != CAIRO_STATUS_SUCCESS) {
+        setLastError(_("Error save image #1"));
+        cairo_destroy(target.cr);
+        cairo_surface_destroy(target.surface);
         return;
     }
 
     if (page->getBackgroundType().isPdfPage() && (exportBackground != EXPORT_BACKGROUND_NONE)) {
         // Handle the pdf page separately, to call renderForPrinting for better quality.
         auto pgNo = page->getPdfPageNr();
+
+        // The page is also fetched and released under the lock: both access the shared Poppler document
+        std::lock_guard lock(pdfRenderMutex);
         XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
         if (!popplerPage) {
-            this->lastError = _("Error while exporting the pdf background: I cannot find the pdf page number ");
-            this->lastError += std::to_string(pgNo);
+            setLastError(_("Error while exporting the pdf background: I cannot find the pdf page number ") +
+                         std::to_string(pgNo));
         } else {
-            popplerPage->renderForPrinting(cr);
+            popplerPage->renderForPrinting(target.cr);
         }
     }
 
+    DocumentView view;
     if (layerRange) {
-        view.drawLayersOfPage(*layerRange, page, this->cr, true /* dont render eraseable */,
+        view.drawLayersOfPage(*layerRange, page, target.cr, true /* dont render eraseable */,
                               true /* don't rerender the pdf background */, exportBackground == EXPORT_BACKGROUND_NONE,
                               exportBackground <= EXPORT_BACKGROUND_UNRULED);
     } else {
-        view.drawPage(page, this->cr, true /* dont render eraseable */, true /* don't rerender the pdf background */,
+        view.drawPage(page, target.cr, true /* dont render eraseable */, true /* don't rerender the pdf background */,
                       exportBackground == EXPORT_BACKGROUND_NONE, exportBackground <= EXPORT_BACKGROUND_UNRULED);
     }
 
-    if (!freeSurface(id)) {
+    if (!freeSurface(id, target)) {
         // could not create this file...
-        this->lastError = _("Error save image #2");
+        setLastError(_("Error save image #2"));
         return;
     }
 }
@@ -227,21 +248,22 @@ void ImageExport::exportGraphics(ProgressListener* stateListener) {
         zoomRatio = ((double)this->qualityParameter.getValue()) / Util::DPI_NORMALIZATION_FACTOR;
     }
 
-    DocumentView view;
-    int current = 0;
-
+    std::vector<size_t> pages;
     for (size_t i = 0; i < count; i++) {
-        auto id = i + 1;
-        if (onePage) {
-            id = SINGLE_PAGE;
-        }
-
         if (selectedPages[i]) {
-            stateListener->setCurrentState(current++);
-
-            exportImagePage(i, id, zoomRatio, format, view);  // Todo(narrowing): remove cast
+            pages.push_back(i);
         }
     }
+
+    // Every page is rendered and written (PNG encoding included) by a worker thread. The progress is reported in
+    // order from this thread.
+    ParallelExport::orderedFor(
+            pages.size(), 2 * ParallelExport::getThreadCount(),
+            [&](size_t n) {
+                auto id = onePage ? SINGLE_PAGE : pages[n] + 1;
+                exportImagePage(pages[n], id, zoomRatio, format);
+            },
+            [&](size_t n) { stateListener->setCurrentState(static_cast<int>(n)); });
 }
 
 RasterImageQualityParameter::RasterImageQualityParameter() = default;
@@ -12,6 +12,8 @@
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex
 #include <string>   // for string
 
 #include <cairo.h>  // for cairo_surface_t, cairo_t
@@ -23,7 +25,6 @@
 
 class Document;
 class ProgressListener;
-class DocumentView;
 
 enum ExportGraphicsFormat { EXPORT_GRAPHICS_UNDEFINED, EXPORT_GRAPHICS_PDF, EXPORT_GRAPHICS_PNG, EXPORT_GRAPHICS_SVG };
 
@@ -80,7 +81,8 @@ public:
 
     /**
      * @brief Create one Graphics file per page
-     * @param stateListener A listener to track the progress
+     * The pages are rendered and encoded concurrently, see ParallelExport
+     * @param stateListener A listener to track the progress. Only called from the calling thread.
      */
     void exportGraphics(ProgressListener* stateListener);
 
@@ -104,23 +106,32 @@ public:
     void setLayerRange(const char* str);
 
 private:
+    /**
+     * Surface and context of a page being exported. Every page has its own, so that pages can be exported concurrently.
+     */
+    struct PageSurface {
+        cairo_surface_t* surface = nullptr;
+        cairo_t* cr = nullptr;
+    };
+
     /**
      * @brief Create Cairo surface for a given page
      * @param width the width of the page being exported
      * @param height the height of the page being exported
      * @param id the id of the page being exported
      * @param zoomRatio the zoom ratio for PNG exports with fixed DPI
+     * @param target Receives the created surface and context
      *
      * @return the zoom ratio of the current page if the export type is PNG, 0.0 otherwise
      *          The return value may differ from that of the parameter zoomRatio
      *          if the export has fixed page width or height (in pixels)
      */
-    double createSurface(double width, double height, size_t id, double zoomRatio);
+    double createSurface(double width, double height, size_t id, double zoomRatio, PageSurface& target);
 
     /**
      * Free / store the surface
      */
-    bool freeSurface(size_t id);
+    bool freeSurface(size_t id, PageSurface& target);
 
     /**
      * @brief Get a filename with a (page) number appended
@@ -137,9 +148,15 @@ private:
      * @param id The number of the page being exported
      * @param zoomRatio The zoom ratio for PNG exports with fixed DPI
      * @param format The format of the exported image
-     * @param view A DocumentView for drawing the page
+     *
+     * Thread safe: may be called concurrently for different pages
      */
-    void exportImagePage(size_t pageId, size_t id, double zoomRatio, ExportGraphicsFormat format, DocumentView& view);
+    void exportImagePage(size_t pageId, size_t id, double zoomRatio, ExportGraphicsFormat format);
+
+    /**
+     * @brief Set the error message to show to the user. Thread safe.
+     */
+    void setLastError(std::string msg);
 
     static constexpr size_t SINGLE_PAGE = size_t(-1);
 
@@ -180,17 +197,18 @@ public:
     RasterImageQualityParameter qualityParameter = RasterImageQualityParameter();
 
     /**
-     * Export surface
+     * The last error message to show to the user
      */
-    cairo_surface_t* surface = nullptr;
+    std::string lastError;
 
     /**
-     * Cairo context
+     * Guards lastError while the pages are exported
      */
-    cairo_t* cr = nullptr;
+    mutable std::mutex lastErrorMutex;
 
     /**
-     * The last error message to show to the user
+     * Poppler does not support accessing the same document concurrently: guards the lookup, rendering and release
+     * of the background pages
      */
-    std::string lastError;
+    std::mutex pdfRenderMutex;
 };
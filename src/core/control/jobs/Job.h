@@ -13,7 +13,7 @@
 
 #include <atomic>
 
-enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE };
+enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE, JOB_TYPE_SEARCH_INDEX };
 
 /**
  * A manually ref-counted class representing an asynchronous job to be used with
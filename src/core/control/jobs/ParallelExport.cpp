@@ -0,0 +1,98 @@
+#include "ParallelExport.h"
+
+#include <algorithm>           // for max, min
+#include <condition_variable>  // for condition_variable
+#include <exception>           // for exception_ptr, current_exception
+#include <mutex>               // for mutex, unique_lock
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+#include "view/TextLayoutCache.h"  // for TextLayoutCache
+
+auto ParallelExport::getThreadCount() -> size_t {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+void ParallelExport::orderedFor(size_t count, size_t window, const std::function<void(size_t)>& produce,
+                                const std::function<void(size_t)>& consume) {
+    size_t threadCount = std::min(getThreadCount(), count);
+    if (threadCount <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            produce(i);
+            consume(i);
+        }
+        return;
+    }
+    window = std::max(window, threadCount);
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    size_t nextToProduce = 0;
+    size_t nextToConsume = 0;
+    std::vector<char> produced(count, false);
+    std::exception_ptr error;
+
+    auto worker = [&]() {
+        // The thread exits with the loop, its Pango layouts must not stay in the caches of the text elements
+        xoj::view::TextLayoutCache::disableOnThisThread();
+
+        std::unique_lock lock(mutex);
+        while (true) {
+            cond.wait(lock, [&]() {
+                return error || nextToProduce >= count || nextToProduce < nextToConsume + window;
+            });
+            if (error || nextToProduce >= count) {
+                return;
+            }
+            size_t i = nextToProduce++;
+            lock.unlock();
+
+            std::exception_ptr e;
+            try {
+                produce(i);
+            } catch (...) {
+                e = std::current_exception();
+            }
+
+            lock.lock();
+            if (e && !error) {
+                error = e;
+            }
+            produced[i] = true;
+            cond.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (size_t t = 0; t < threadCount; t++) { threads.emplace_back(worker); }
+
+    {
+        std::unique_lock lock(mutex);
+        while (nextToConsume < count) {
+            cond.wait(lock, [&]() { return error || produced[nextToConsume]; });
+            if (error) {
+                break;
+            }
+            lock.unlock();
+            try {
+                consume(nextToConsume);
+            } catch (...) {
+                lock.lock();
+                error = std::current_exception();
+                break;
+            }
+            lock.lock();
+            nextToConsume++;
+            cond.notify_all();
+        }
+        // Wake up the workers waiting for the window to move on an error
+        cond.notify_all();
+    }
+
+    for (auto& t: threads) { t.join(); }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,37 @@
+/*
+ * Xournal++
+ *
+ * Helpers to render the pages of an export concurrently
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+
+namespace ParallelExport {
+
+/**
+ * @return The number of threads used to render the pages of an export (at least 1)
+ */
+auto getThreadCount() -> size_t;
+
+/**
+ * @brief Runs produce(i) for every i in [0, count) on a pool of worker threads, and consume(i) on the calling thread
+ * in increasing order of i, as soon as produce(0), ..., produce(i) have returned.
+ *
+ * At most `window` items are produced ahead of the last consumed one, which bounds the memory used by the results
+ * waiting to be consumed. With a single thread, this is the plain serial loop.
+ *
+ * produce() must be safe to call concurrently for different indices. An exception thrown by produce() or consume()
+ * stops the loop and is rethrown on the calling thread once all workers are done.
+ */
+void orderedFor(size_t count, size_t window, const std::function<void(size_t)>& produce,
+                const std::function<void(size_t)>& consume);
+
+}  // namespace ParallelExport
@@ -1,13 +1,16 @@
 #include "PreviewJob.h"
 
-#include <memory>  // for __s...
-#include <mutex>   // for mutex
-#include <vector>  // for vector
+#include <memory>    // for __s...
+#include <mutex>     // for mutex
+#include <optional>  // for optional
+#include <string>    // for string
+#include <vector>    // for vector
 
 #include <glib-object.h>  // for g_o...
 #include <gtk/gtk.h>      // for Gtk...
 
 #include "control/Control.h"                                      // for Con...
+#include "control/ThumbnailCache.h"                               // for Thu...
 #include "control/jobs/Job.h"                                     // for JOB...
 #include "gui/Shadow.h"                                           // for Shadow
 #include "gui/sidebar/previews/base/SidebarPreviewBase.h"         // for Sid...
@@ -17,6 +20,7 @@
 #include "model/Layer.h"                                          // for Layer
 #include "model/PageRef.h"                                        // for Pag...
 #include "model/XojPage.h"                                        // for Xoj...
+#include "util/Tracing.h"                                         // for XOJ...
 #include "util/Util.h"                                            // for exe...
 #include "view/DocumentView.h"                                    // for Doc...
 #include "view/LayerView.h"                                       // for Lay...
@@ -67,6 +71,43 @@ void PreviewJob::finishPaint() {
     this->sidebarPreview->drawingMutex.unlock();
 }
 
+auto PreviewJob::serializeCacheContent() -> std::optional<std::string> {
+    if (this->sidebarPreview->getRenderType() != RENDER_TYPE_PAGE_PREVIEW) {
+        return std::nullopt;
+    }
+    Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
+    return ThumbnailCache::serializeContent(doc, this->sidebarPreview->page, cairo_image_surface_get_width(crBuffer),
+                                            cairo_image_surface_get_height(crBuffer), zoom);
+}
+
+auto PreviewJob::loadFromCache() -> bool {
+    Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
+    doc->lock();
+    auto content = serializeCacheContent();
+    doc->unlock();
+    if (!content) {
+        return false;
+    }
+
+    // Hashed without the lock, the page can be large
+    std::string key = ThumbnailCache::hashContent(*content);
+    cairo_surface_t* cached = this->sidebarPreview->sidebar->getControl()->getThumbnailCache()->load(key);
+    if (cached == nullptr) {
+        return false;
+    }
+    if (cairo_image_surface_get_width(cached) != cairo_image_surface_get_width(crBuffer) ||
+        cairo_image_surface_get_height(cached) != cairo_image_surface_get_height(crBuffer)) {
+        cairo_surface_destroy(cached);
+        return false;
+    }
+
+    cairo_destroy(cr2);
+    cr2 = nullptr;
+    cairo_surface_destroy(crBuffer);
+    crBuffer = cached;
+    return true;
+}
+
 void PreviewJob::drawPage() {
     PageRef page = this->sidebarPreview->page;
     Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
@@ -77,6 +118,9 @@ void PreviewJob::drawPage() {
 
     doc->lock();
 
+    // Serialized with the document locked, so that it matches what is drawn
+    this->cacheContent = serializeCacheContent();
+
     // getLayer is not defined for page preview
     if (type != RENDER_TYPE_PAGE_PREVIEW) {
         layer = (dynamic_cast<SidebarPreviewLayerEntry*>(this->sidebarPreview))->getLayer();
@@ -132,13 +176,23 @@ void PreviewJob::clipToPage() {
 }
 
 void PreviewJob::run() {
+    XOJ_TRACE_SCOPE("PreviewJob::run");
     if (this->sidebarPreview == nullptr) {
         return;
     }
 
     initGraphics();
+    if (loadFromCache()) {
+        finishPaint();
+        return;
+    }
+
     drawBorder();
     clipToPage();
     drawPage();
+    if (this->cacheContent) {
+        std::string key = ThumbnailCache::hashContent(*this->cacheContent);
+        this->sidebarPreview->sidebar->getControl()->getThumbnailCache()->store(key, crBuffer);
+    }
     finishPaint();
 }
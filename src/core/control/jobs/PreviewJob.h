@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <optional>  // for optional
+#include <string>    // for string
+
 #include <cairo.h>  // for cairo_surface_t, cairo_t
 
 #include "Job.h"  // for Job, JobType
@@ -42,6 +45,17 @@ private:
     void finishPaint();
     void drawPage();
 
+    /**
+     * Replaces the buffer by the preview of the ThumbnailCache, if the page is cached
+     */
+    bool loadFromCache();
+
+    /**
+     * @return The content of the preview, to be hashed into its ThumbnailCache key with ThumbnailCache::hashContent()
+     * after unlocking the document, or nullopt if it cannot be cached. The document must be locked.
+     */
+    std::optional<std::string> serializeCacheContent();
+
 private:
     /**
      * Graphics buffer
@@ -58,6 +72,11 @@ private:
      */
     double zoom = 0;
 
+    /**
+     * Serialized content of the rendered preview, see serializeCacheContent()
+     */
+    std::optional<std::string> cacheContent;
+
     /**
      * Sidebar preview
      */
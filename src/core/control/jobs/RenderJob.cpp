@@ -1,24 +1,34 @@
 #include "RenderJob.h"
 
-#include <cmath>    // for ceil, floor
-#include <mutex>    // for mutex
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <cmath>     // for ceil, floor
+#include <mutex>     // for mutex
+#include <optional>  // for optional
+#include <string>    // for string
+#include <utility>   // for move
+#include <vector>    // for vector
 
 #include <cairo.h>  // for cairo_create, cairo_destroy, cairo_...
 #include "gui/widgets/XournalWidget.h"  // for gtk_xournal_repaint_area
 
-#include "control/Control.h"          // for Control
-#include "control/ToolEnums.h"        // for TOOL_PLAY_OBJECT
-#include "control/ToolHandler.h"      // for ToolHandler
-#include "control/jobs/Job.h"         // for JOB_TYPE_RENDER, JobType
-#include "gui/PageView.h"             // for XojPageView
-#include "gui/XournalView.h"          // for XournalView
-#include "model/Document.h"           // for Document
-#include "util/Rectangle.h"           // for Rectangle
-#include "util/Util.h"                // for execInUiThread
-#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr, CairoSPtr
-#include "view/DocumentView.h"        // for DocumentView
+#include "control/Control.h"                // for Control
+#include "control/ThumbnailCache.h"         // for ThumbnailCache
+#include "control/ToolEnums.h"              // for TOOL_PLAY_OBJECT
+#include "control/ToolHandler.h"            // for ToolHandler
+#include "control/jobs/Job.h"               // for JOB_TYPE_RENDER, JobType
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "control/settings/Settings.h"      // for Settings
+#include "gui/PageView.h"                   // for XojPageView
+#include "gui/XournalView.h"                // for XournalView
+#include "model/Document.h"                 // for Document
+#include "model/PageRef.h"                  // for PageRef
+#include "util/DirtyRegion.h"               // for DirtyRegion
+#include "util/Rectangle.h"                 // for Rectangle
+#include "util/Tracing.h"                   // for XOJ_TRACE_SCOPE, counter
+#include "util/Util.h"                      // for execInUiThread
+#include "util/raii/CairoWrappers.h"        // for CairoSurfaceSPtr, CairoSPtr
+#include "view/DebugShowRepaintBounds.h"    // for IF_DEBUG_REPAINT
+#include "view/DocumentView.h"              // for DocumentView
+#include "view/ResolutionPyramid.h"         // for ResolutionPyramid
 
 using xoj::util::Rectangle;
 
@@ -26,7 +36,8 @@ RenderJob::RenderJob(XojPageView* view): view(view) {}
 
 auto RenderJob::getSource() -> void* { return this->view; }
 
-void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
+void RenderJob::rerenderRegion(const xoj::util::DirtyRegion& region) {
+    XOJ_TRACE_SCOPE("RenderJob::rerenderRegion");
     const double ratio = view->xournal->getZoom() * this->view->xournal->getDpiScaleFactor();
 
     /**
@@ -37,38 +48,92 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
      **/
     constexpr int RENDER_PADDING = 1;
 
-    const auto rx = rect.x - RENDER_PADDING;
-    const auto ry = rect.y - RENDER_PADDING;
-    const auto rwidth = rect.width + 2 * RENDER_PADDING;
-    const auto rheight = rect.height + 2 * RENDER_PADDING;
-
-    const auto x = std::floor(rx * ratio);
-    const auto y = std::floor(ry * ratio);
-    const auto width = static_cast<int>(std::ceil((rx + rwidth) * ratio) - x);
-    const auto height = static_cast<int>(std::ceil((ry + rheight) * ratio) - y);
-
-    xoj::util::CairoSurfaceSPtr rectBuffer(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
-                                           xoj::util::adopt);
+    std::vector<Rectangle<double>> rects;
+    rects.reserve(region.getRects().size());
+    for (const auto& r: region.getRects()) {
+        rects.emplace_back(r.x - RENDER_PADDING, r.y - RENDER_PADDING, r.width + 2 * RENDER_PADDING,
+                           r.height + 2 * RENDER_PADDING);
+    }
 
-    renderToBuffer(rectBuffer.get(), ratio, x, y);
+    /*
+     * Each rectangle is rendered into its own buffer: a buffer covering their bounding box could be as large as the
+     * whole page at a high zoom, while the rectangles are small.
+     */
+    std::vector<xoj::util::CairoSurfaceSPtr> buffers;
+    std::vector<BufferPart> parts;
+    buffers.reserve(rects.size());
+    parts.reserve(rects.size());
+    for (const auto& r: rects) {
+        const auto x = std::floor(r.x * ratio);
+        const auto y = std::floor(r.y * ratio);
+        const auto width = static_cast<int>(std::ceil((r.x + r.width) * ratio) - x);
+        const auto height = static_cast<int>(std::ceil((r.y + r.height) * ratio) - y);
+        buffers.emplace_back(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height), xoj::util::adopt);
+        parts.push_back({buffers.back().get(), x, y, &r});
+    }
 
-    cairo_surface_set_device_scale(rectBuffer.get(), ratio, ratio);
-    cairo_surface_set_device_offset(rectBuffer.get(), -x, -y);
+    renderToBuffers(parts, ratio, this->view->xournal->getControl()->getSettings()->isLayerRasterCacheEnabled());
 
     std::lock_guard lock(this->view->drawingMutex);
     xoj::util::CairoSPtr crPageBuffer(cairo_create(view->crBuffer.get()), xoj::util::adopt);
 
     cairo_set_operator(crPageBuffer.get(), CAIRO_OPERATOR_SOURCE);
-    cairo_set_source_surface(crPageBuffer.get(), rectBuffer.get(), 0, 0);
-    cairo_rectangle(crPageBuffer.get(), rx, ry, rwidth, rheight);
-    cairo_fill(crPageBuffer.get());
+    for (const BufferPart& part: parts) {
+        cairo_surface_set_device_scale(part.buffer, ratio, ratio);
+        cairo_surface_set_device_offset(part.buffer, -part.x, -part.y);
+        cairo_set_source_surface(crPageBuffer.get(), part.buffer, 0, 0);
+        cairo_rectangle(crPageBuffer.get(), part.clip->x, part.clip->y, part.clip->width, part.clip->height);
+        cairo_fill(crPageBuffer.get());
+    }
+
+    for (const auto& r: rects) { this->view->pyramid.update(view->crBuffer.get(), r); }
+
+    xoj::util::trace::counter("Rerender overdraw", {{"ratio", region.getOverdrawRatio()},
+                                                    {"rectangles", static_cast<double>(rects.size())}});
+    IF_DEBUG_REPAINT(g_message("DBG:RenderJob::rerenderRegion: %zu rectangles, overdraw ratio %.2f", rects.size(),
+                               region.getOverdrawRatio()););
+}
+
+auto RenderJob::needsCoarsePass(double ratio) const -> bool {
+    std::lock_guard lock(this->view->drawingMutex);
+    if (!this->view->crBuffer) {
+        // Nothing to upscale in the meantime: render at full resolution right away
+        return false;
+    }
+    double scaleX = 0;
+    double scaleY = 0;
+    cairo_surface_get_device_scale(this->view->crBuffer.get(), &scaleX, &scaleY);
+    return scaleX < ratio / 2;
+}
+
+void RenderJob::renderPage(int width, int height, double ratio, int pendingWidth) {
+    XOJ_TRACE_SCOPE("RenderJob::renderPage");
+    xoj::util::CairoSurfaceSPtr newBuffer(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+                                          xoj::util::adopt);
+
+    renderToBuffers({{newBuffer.get(), 0, 0, nullptr}}, ratio, false);
+
+    cairo_surface_set_device_scale(newBuffer.get(), ratio, ratio);
+
+    xoj::view::ResolutionPyramid pyramid;
+    pyramid.rebuild(newBuffer.get());
+
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        std::swap(this->view->crBuffer, newBuffer);
+        std::swap(this->view->pyramid, pyramid);
+        this->view->pendingRenderWidth = pendingWidth;
+    }
+    repaintPage();
 }
 
 void RenderJob::run() {
+    XOJ_TRACE_SCOPE("RenderJob::run");
     this->view->repaintRectMutex.lock();
 
     bool rerenderComplete = this->view->rerenderComplete;
-    auto rerenderRects = std::move(this->view->rerenderRects);
+    xoj::util::DirtyRegion region = this->view->rerenderRegion;
+    this->view->rerenderRegion.clear();
 
     this->view->rerenderComplete = false;
 
@@ -81,23 +146,75 @@ void RenderJob::run() {
         const int dispHeight = this->view->getDisplayHeight() * dpiScaleFactor;
         const double ratio = this->view->xournal->getZoom() * dpiScaleFactor;
 
-        xoj::util::CairoSurfaceSPtr newBuffer(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, dispWidth, dispHeight),
-                                              xoj::util::adopt);
+        if (needsCoarsePass(ratio)) {
+            /*
+             * The page would be very blurry: show it at half the resolution first, and refine it once the other pages
+             * got their coarse pass. The refinement uses the zoom at the time it runs, so that a zoom change in the
+             * meantime cancels it.
+             */
+            renderPage((dispWidth + 1) / 2, (dispHeight + 1) / 2, ratio / 2, dispWidth);
+            {
+                std::lock_guard lock(this->view->repaintRectMutex);
+                this->view->rerenderComplete = true;
+            }
+            this->view->xournal->getControl()->getScheduler()->addRerenderPage(this->view);
+            return;
+        }
+
+        renderPage(dispWidth, dispHeight, ratio);
+        // Not after the partial rerenders, which are frequent while editing: the key costs as much as the whole page
+        offerThumbnail();
+    } else if (!region.empty()) {
+        rerenderRegion(region);
+        for (Rectangle<double> const& rect: region.getRects()) {
+            repaintPageArea(rect.x, rect.y, rect.x + rect.width, rect.y + rect.height);
+        }
+    }
+}
 
-        renderToBuffer(newBuffer.get(), ratio, 0, 0);
+void RenderJob::offerThumbnail() const {
+    ThumbnailCache* cache = this->view->xournal->getControl()->getThumbnailCache();
+    const double previewZoom = cache->getPreviewZoom();
+    if (previewZoom <= 0 || this->view->xournal->getControl()->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT) {
+        return;
+    }
 
-        cairo_surface_set_device_scale(newBuffer.get(), ratio, ratio);
+    {
+        // Only an up-to-date buffer is worth caching
+        std::lock_guard lock(this->view->repaintRectMutex);
+        if (this->view->rerenderComplete || !this->view->rerenderRegion.empty()) {
+            return;
+        }
+    }
 
-        {
-            std::lock_guard lock(this->view->drawingMutex);
-            std::swap(this->view->crBuffer, newBuffer);
+    std::optional<std::string> content;
+    xoj::util::CairoSurfaceSPtr preview;
+    {
+        std::lock_guard<Document> docLock(*this->view->xournal->getDocument());
+        const PageRef& page = this->view->page;
+        auto [width, height] = ThumbnailCache::getPreviewSize(page, previewZoom);
+        content = ThumbnailCache::serializeContent(this->view->xournal->getDocument(), page, width, height,
+                                                   previewZoom);
+        if (!content) {
+            return;
         }
-        repaintPage();
-    } else {
-        for (Rectangle<double> const& rect: rerenderRects) {
-            rerenderRectangle(rect);
-            repaintPageArea(rect.x, rect.y, rect.x + rect.width, rect.y + rect.height);
+
+        std::lock_guard lock(this->view->drawingMutex);
+        cairo_surface_t* buffer = this->view->crBuffer.get();
+        double scaleX = 0;
+        double scaleY = 0;
+        cairo_surface_get_device_scale(buffer, &scaleX, &scaleY);
+        if (scaleX < previewZoom) {
+            // Downscaling only, upscaling would give a blurry preview
+            return;
         }
+        preview.reset(ThumbnailCache::createPreviewFromBuffer(buffer, page, previewZoom), xoj::util::adopt);
+    }
+
+    // The hash and the file lookup do not need the document lock, which the main thread may be waiting for
+    std::string key = ThumbnailCache::hashContent(*content);
+    if (!cache->contains(key)) {
+        cache->store(key, preview.get());
     }
 }
 
@@ -116,19 +233,34 @@ void RenderJob::repaintPageArea(double x1, double y1, double x2, double y2) cons
     repaintWidgetArea(view->xournal->getWidget(), x + std::floor(zoom * x1), y + std::floor(zoom * y1), x + std::ceil(zoom * x2), y + std::ceil(zoom * y2));
 }
 
-void RenderJob::renderToBuffer(cairo_surface_t* buffer, double ratio, double x, double y) const {
-    xoj::util::CairoSPtr crRect(cairo_create(buffer), xoj::util::adopt);
-
-    cairo_translate(crRect.get(), -x, -y);
-    cairo_scale(crRect.get(), ratio, ratio);
+void RenderJob::renderToBuffers(const std::vector<BufferPart>& parts, double ratio, bool useLayerCache) const {
+    const bool markAudioStroke =
+            this->view->getXournal()->getControl()->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT;
 
     DocumentView localView;
-    localView.setMarkAudioStroke(this->view->getXournal()->getControl()->getToolHandler()->getToolType() ==
-                                 TOOL_PLAY_OBJECT);
+    localView.setMarkAudioStroke(markAudioStroke);
     localView.setPdfCache(this->view->xournal->getCache());
+    localView.setRulingCache(this->view->xournal->getRulingCache());
 
     std::lock_guard<Document> lock(*this->view->xournal->getDocument());
-    localView.drawPage(this->view->page, crRect.get(), false);
+    for (const BufferPart& part: parts) {
+        xoj::util::CairoSPtr crRect(cairo_create(part.buffer), xoj::util::adopt);
+
+        cairo_translate(crRect.get(), -part.x, -part.y);
+        cairo_scale(crRect.get(), ratio, ratio);
+
+        if (part.clip) {
+            cairo_rectangle(crRect.get(), part.clip->x, part.clip->y, part.clip->width, part.clip->height);
+            cairo_clip(crRect.get());
+        }
+
+        if (useLayerCache) {
+            this->view->layerRasterCache.draw(this->view->page, crRect.get(), ratio, this->view->xournal->getCache(),
+                                              this->view->xournal->getRulingCache(), markAudioStroke);
+        } else {
+            localView.drawPage(this->view->page, crRect.get(), false);
+        }
+    }
 }
 
 auto RenderJob::getType() -> JobType { return JOB_TYPE_RENDER; }
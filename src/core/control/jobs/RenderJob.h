@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <vector>  // for vector
+
 #include <cairo.h>    // for cairo_surface_t
 #include <gtk/gtk.h>  // for GtkWidget
 
@@ -18,6 +20,7 @@
 
 class XojPageView;
 namespace xoj::util {
+class DirtyRegion;
 template <class T>
 class Rectangle;
 }  // namespace xoj::util
@@ -41,9 +44,47 @@ private:
 
     void repaintPageArea(double x1, double y1, double x2, double y2) const;
 
-    void rerenderRectangle(xoj::util::Rectangle<double> const& rect);
+    /**
+     * Rerenders the parts of the page buffer covered by the region, with the document locked once
+     */
+    void rerenderRegion(const xoj::util::DirtyRegion& region);
+
+    /**
+     * Renders the whole page into a new buffer, which replaces the page buffer
+     * @param ratio Pixels per page coordinate unit
+     * @param pendingWidth Width of the full-resolution render queued after this coarse pass, or 0
+     */
+    void renderPage(int width, int height, double ratio, int pendingWidth = 0);
+
+    /**
+     * @return true if the page buffer has less than half the resolution to render. A missing buffer is rendered at
+     * full resolution directly.
+     */
+    bool needsCoarsePass(double ratio) const;
+
+    /**
+     * A buffer to render a part of the page into
+     */
+    struct BufferPart {
+        cairo_surface_t* buffer;
+        /// Position of the buffer on the page, in device pixels
+        double x;
+        double y;
+        /// The part of the page to render, in page coordinates, or nullptr for the whole page
+        const xoj::util::Rectangle<double>* clip;
+    };
+
+    /**
+     * Renders the parts with the document locked once
+     * @param useLayerCache true to composite the cached rasters of the layers which are not edited
+     */
+    void renderToBuffers(const std::vector<BufferPart>& parts, double ratio, bool useLayerCache) const;
 
-    void renderToBuffer(cairo_surface_t* buffer, double ratio, double x, double y) const;
+    /**
+     * Stores a preview of the freshly rendered page in the ThumbnailCache, so that the sidebar does not need to render
+     * it again. Only worth it after a full render: computing the key serializes the whole page.
+     */
+    void offerThumbnail() const;
 
 private:
     XojPageView* view;
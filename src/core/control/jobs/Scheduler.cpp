@@ -4,6 +4,7 @@
 #include <cinttypes>  // for PRId64, uint64_t
 
 #include "control/jobs/Job.h"  // for Job, JOB_TYPE_RENDER
+#include "util/Tracing.h"      // for counter, isEnabled
 
 #include "config-debug.h"  // for DEBUG_SHEDULER
 
@@ -70,6 +71,7 @@ void Scheduler::addJob(Job* job, JobPriority priority) {
 
         job->ref();
         this->jobQueue[priority]->push_back(job);
+        traceQueueLengthsUnlocked();
     }
 
     SDEBUG("add job: %" PRId64 "; type: %" PRId64, (uint64_t)job, (uint64_t)job->getType());
@@ -107,6 +109,16 @@ auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> J
     return nullptr;
 }
 
+void Scheduler::traceQueueLengthsUnlocked() const {
+    if (!xoj::util::trace::isEnabled()) {
+        return;
+    }
+    xoj::util::trace::counter("Scheduler queues", {{"urgent", this->queueUrgent.size()},
+                                                   {"high", this->queueHigh.size()},
+                                                   {"low", this->queueLow.size()},
+                                                   {"none", this->queueNone.size()}});
+}
+
 /**
  * Locks the complete scheduler
  */
@@ -217,6 +229,7 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
             job = scheduler->getNextJobUnlocked(onlyNonRenderJobs, &hasOnlyRenderJobs);
             if (job != nullptr) {
                 hasOnlyRenderJobs = false;
+                scheduler->traceQueueLengthsUnlocked();
             }
 
             SDEBUG("get job: %" PRId64, (uint64_t)job);
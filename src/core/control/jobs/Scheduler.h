@@ -106,6 +106,11 @@ private:
     static gpointer jobThreadCallback(Scheduler* scheduler);
     Job* getNextJobUnlocked(bool onlyNotRender = false, bool* hasRenderJobs = nullptr);
 
+    /**
+     * Records the number of jobs in each queue, if the tracing is on. The job queue must be locked.
+     */
+    void traceQueueLengthsUnlocked() const;
+
     static bool jobRenderThreadTimer(Scheduler* scheduler);
 
 protected:
@@ -0,0 +1,50 @@
+#include "SearchIndexJob.h"
+
+#include <optional>  // for optional
+
+#include "control/Control.h"                // for Control
+#include "control/jobs/Job.h"               // for JOB_TYPE_SEARCH_INDEX, JobType
+#include "control/jobs/Scheduler.h"         // for JOB_PRIORITY_NONE
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "model/Document.h"                 // for Document
+#include "model/SearchIndex.h"              // for SearchIndex
+
+/// Number of PDF pages indexed by one job
+constexpr int PAGES_PER_RUN = 8;
+
+SearchIndexJob::SearchIndexJob(Control* control): control(control) {}
+
+SearchIndexJob::~SearchIndexJob() = default;
+
+void SearchIndexJob::run() {
+    Document* doc = control->getDocument();
+    SearchIndex& index = doc->getSearchIndex();
+    for (int i = 0; i < PAGES_PER_RUN && !this->finished; i++) {
+        // Only pick the page under the document lock, the text extraction can take long
+        doc->lock();
+        std::optional<SearchIndex::PdfPageTask> task = index.nextPdfPageToIndex();
+        doc->unlock();
+
+        if (!task) {
+            this->finished = true;
+            break;
+        }
+        index.indexPdfPage(*task);
+    }
+
+    callAfterRun();
+}
+
+void SearchIndexJob::afterRun() {
+    if (this->finished) {
+        control->getDocument()->getSearchIndex().indexingFinished();
+        return;
+    }
+
+    // Continue with the next pages, other jobs can run in between
+    auto* job = new SearchIndexJob(control);
+    control->getScheduler()->addJob(job, JOB_PRIORITY_NONE);
+    job->unref();
+}
+
+auto SearchIndexJob::getType() -> JobType { return JOB_TYPE_SEARCH_INDEX; }
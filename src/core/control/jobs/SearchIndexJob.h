@@ -0,0 +1,38 @@
+/*
+ * Xournal++
+ *
+ * Builds the full-text index of the PDF background in the background
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "Job.h"  // for Job, JobType
+
+class Control;
+
+/**
+ * Extracts the text of a few PDF pages into the SearchIndex of the document, then schedules the next chunk with the
+ * lowest priority, so that rendering jobs are not delayed by the indexing of large documents.
+ */
+class SearchIndexJob: public Job {
+public:
+    explicit SearchIndexJob(Control* control);
+
+protected:
+    ~SearchIndexJob() override;
+
+public:
+    void run() override;
+    void afterRun() override;
+
+    JobType getType() override;
+
+private:
+    Control* control = nullptr;
+    bool finished = false;
+};
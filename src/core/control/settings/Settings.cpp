@@ -178,6 +178,7 @@ void Settings::loadDefault() {
     this->preloadPagesBefore = 3U;
     this->preloadPagesAfter = 5U;
     this->eagerPageCleanup = true;
+    this->layerRasterCacheEnabled = false;
 
     this->selectionBorderColor = Colors::red;
     this->selectionMarkerColor = Colors::xopp_cornflowerblue;
@@ -487,6 +488,8 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->preloadPagesAfter = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("eagerPageCleanup")) == 0) {
         this->eagerPageCleanup = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("layerRasterCacheEnabled")) == 0) {
+        this->layerRasterCacheEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionBorderColor")) == 0) {
         this->selectionBorderColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionMarkerColor")) == 0) {
@@ -1010,6 +1013,8 @@ void Settings::save() {
     SAVE_UINT_PROP(preloadPagesBefore);
     SAVE_UINT_PROP(preloadPagesAfter);
     SAVE_BOOL_PROP(eagerPageCleanup);
+    SAVE_BOOL_PROP(layerRasterCacheEnabled);
+    ATTACH_COMMENT("Cache the layers which are not edited as images, to speed up the rerendering of edited pages.");
 
     SAVE_STRING_PROP(pageTemplate);
     ATTACH_COMMENT("Config for new pages");
@@ -1928,6 +1933,16 @@ void Settings::setEagerPageCleanup(bool b) {
     save();
 }
 
+auto Settings::isLayerRasterCacheEnabled() const -> bool { return this->layerRasterCacheEnabled; }
+
+void Settings::setLayerRasterCacheEnabled(bool enabled) {
+    if (this->layerRasterCacheEnabled == enabled) {
+        return;
+    }
+    this->layerRasterCacheEnabled = enabled;
+    save();
+}
+
 auto Settings::getBorderColor() const -> Color { return this->selectionBorderColor; }
 
 void Settings::setBorderColor(Color color) {
@@ -375,6 +375,9 @@ public:
     bool isEagerPageCleanup() const;
     void setEagerPageCleanup(bool b);
 
+    bool isLayerRasterCacheEnabled() const;
+    void setLayerRasterCacheEnabled(bool enabled);
+
     std::string const& getPageTemplate() const;
     void setPageTemplate(const std::string& pageTemplate);
 
@@ -1059,6 +1062,11 @@ private:
      */
     bool eagerPageCleanup{};
 
+    /**
+     * Whether the background and the layers other than the selected one are cached as rasters while a page is edited
+     */
+    bool layerRasterCacheEnabled{};
+
     /**
      * Stabilizer related settings
      */
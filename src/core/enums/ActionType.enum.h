@@ -185,6 +185,7 @@ enum ActionType {
     ACTION_AUDIO_STOP_PLAYBACK,
     ACTION_AUDIO_SEEK_FORWARDS,
     ACTION_AUDIO_SEEK_BACKWARDS,
+    ACTION_AUDIO_FOLLOW_PLAYBACK,
     ACTION_SET_PAIRS_OFFSET,
     ACTION_TOGGLE_PAIRS_PARITY,
     ACTION_SET_COLUMNS,
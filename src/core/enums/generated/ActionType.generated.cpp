@@ -532,6 +532,10 @@ auto ActionType_fromString(const string& value) -> ActionType {
         return ACTION_AUDIO_SEEK_BACKWARDS;
     }
 
+    if (value == "ACTION_AUDIO_FOLLOW_PLAYBACK") {
+        return ACTION_AUDIO_FOLLOW_PLAYBACK;
+    }
+
     if (value == "ACTION_SET_PAIRS_OFFSET") {
         return ACTION_SET_PAIRS_OFFSET;
     }
@@ -1186,6 +1190,10 @@ auto ActionType_toString(ActionType value) -> string {
         return "ACTION_AUDIO_SEEK_BACKWARDS";
     }
 
+    if (value == ACTION_AUDIO_FOLLOW_PLAYBACK) {
+        return "ACTION_AUDIO_FOLLOW_PLAYBACK";
+    }
+
     if (value == ACTION_SET_PAIRS_OFFSET) {
         return "ACTION_SET_PAIRS_OFFSET";
     }
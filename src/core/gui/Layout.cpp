@@ -1,11 +1,12 @@
 #include "Layout.h"
 
-#include <algorithm>    // for max, lower_bound, transform
+#include <algorithm>    // for max, lower_bound, upper_bound, transform
 #include <cmath>        // for abs
 #include <iterator>     // for begin, end, distance
 #include <numeric>      // for accumulate
 #include <optional>     // for optional
 #include <type_traits>  // for make_signed_t, remove_referen...
+#include <utility>      // for pair
 
 #include <glib-object.h>  // for G_CALLBACK, g_signal_connect
 
@@ -89,49 +90,21 @@ void Layout::checkScroll(GtkAdjustment* adjustment, double& lastScroll) {
 void Layout::updateVisibility() {
     Rectangle visRect = getVisibleRect();
 
-    // step through every possible page position and update using p->setIsVisible()
-    // Using initial grid aprox speeds things up by a factor of 5.  See previous git check-in for specifics.
-    int x1 = 0;
-    int y1 = 0;
-
     // Data to select page based on visibility
     std::optional<size_t> mostPageNr;
     double mostPagePercent = 0;
 
-    for (size_t row = 0; row < this->rowYStart.size(); ++row) {
-        auto y2 = as_signed_strict(this->rowYStart[row]);
-        for (size_t col = 0; col < this->colXStart.size(); ++col) {
-            auto x2 = as_signed_strict(this->colXStart[col]);
-            auto optionalPage = this->mapper.at({col, row});
-            if (optionalPage)  // a page exists at this grid location
-            {
-                XojPageView* pageView = this->view->viewPages[*optionalPage];
-
-
-                // check if grid location is visible as an aprox for page visiblity:
-                if (!(visRect.x > x2 || visRect.x + visRect.width < x1)  // visrect not outside current row/col
-                    && !(visRect.y > y2 || visRect.y + visRect.height < y1)) {
-                    // now use exact check of page itself:
-                    // visrect not outside current page dimensions:
-                    auto const& pageRect = pageView->getRect();
-                    if (auto intersection = pageRect.intersects(visRect); intersection) {
-                        pageView->setIsVisible(true);
-                        // Set the selected page
-                        double percent = intersection->area() / pageRect.area();
-
-                        if (percent > mostPagePercent) {
-                            mostPageNr = *optionalPage;
-                            mostPagePercent = percent;
-                        }
-                    }
-                } else {
-                    pageView->setIsVisible(false);
-                }
+    for (size_t pageNr: updateLivePages()) {
+        auto const& pageRect = this->view->viewPages[pageNr]->getRect();
+        if (auto intersection = pageRect.intersects(visRect); intersection) {
+            // Set the selected page
+            double percent = intersection->area() / pageRect.area();
+
+            if (percent > mostPagePercent) {
+                mostPageNr = pageNr;
+                mostPagePercent = percent;
             }
-            x1 = x2;
         }
-        y1 = y2;
-        x1 = 0;
     }
 
     if (mostPageNr) {
@@ -139,6 +112,51 @@ void Layout::updateVisibility() {
     }
 }
 
+auto Layout::updateLivePages() -> std::vector<size_t> {
+    Rectangle visRect = getVisibleRect();
+    auto visible = getPagesInRect(visRect);
+
+    // The pages up to one screen away from the visible area are kept live, so that they are ready when scrolling
+    Rectangle liveRect(visRect.x - visRect.width, visRect.y - visRect.height, 3 * visRect.width, 3 * visRect.height);
+    auto live = getPagesInRect(liveRect);
+
+    this->view->updateLivePages(visible, live);
+    return visible;
+}
+
+/**
+ * @return The range [first, last) of the grid cells overlapping [from, to]
+ * @param ends End of each cell, in increasing order. The first cell starts at 0.
+ */
+static auto getGridRange(const std::vector<unsigned>& ends, double from, double to) -> std::pair<size_t, size_t> {
+    auto first = std::upper_bound(ends.begin(), ends.end(), from);
+    // The cell containing `to` is the last one to overlap
+    auto last = std::upper_bound(ends.begin(), ends.end(), to);
+    if (last != ends.end()) {
+        ++last;
+    }
+    return {static_cast<size_t>(std::distance(ends.begin(), first)),
+            static_cast<size_t>(std::distance(ends.begin(), last))};
+}
+
+auto Layout::getPagesInRect(const Rectangle<double>& rect) const -> std::vector<size_t> {
+    std::vector<size_t> pages;
+    const auto [firstRow, lastRow] = getGridRange(this->rowYStart, rect.y, rect.y + rect.height);
+    const auto [firstCol, lastCol] = getGridRange(this->colXStart, rect.x, rect.x + rect.width);
+
+    for (size_t row = firstRow; row < lastRow; ++row) {
+        for (size_t col = firstCol; col < lastCol; ++col) {
+            auto optionalPage = this->mapper.at({col, row});
+            // The grid may be out of date while pages are inserted or deleted
+            if (optionalPage && *optionalPage < this->view->viewPages.size() &&
+                this->view->viewPages[*optionalPage]->getRect().intersects(rect)) {
+                pages.push_back(*optionalPage);
+            }
+        }
+    }
+    return pages;
+}
+
 auto Layout::getVisibleRect() -> Rectangle<double> {
     return Rectangle(gtk_adjustment_get_value(scrollHandling->getHorizontal()),
                      gtk_adjustment_get_value(scrollHandling->getVertical()),
@@ -305,6 +323,8 @@ void Layout::layoutPages(int width, int height) {
                        return strict_cast<std::remove_reference_t<decltype(heightRow)>>(
                                (totalHeight += heightRow + XOURNAL_PADDING_BETWEEN));
                    });
+
+    updateLivePages();
 }
 
 
@@ -108,6 +108,12 @@ public:
      */
     void updateVisibility();
 
+    /**
+     * Returns the indices of the pages intersecting the given rectangle, in layout coordinates.
+     * Only the grid cells overlapping the rectangle are looked at.
+     */
+    std::vector<size_t> getPagesInRect(const xoj::util::Rectangle<double>& rect) const;
+
     /**
      * Return the pageview containing co-ordinates.
      */
@@ -150,6 +156,12 @@ protected:
 private:
     void recalculate_int() const;
 
+    /**
+     * Updates which pages are visible and which ones are live, i.e. in or near the visible area
+     * @return The visible pages
+     */
+    std::vector<size_t> updateLivePages();
+
     void maybeAddLastPage(Layout* layout);
 
     // Todo(Fabian): move to ScrollHandling also it must not depend on Layout
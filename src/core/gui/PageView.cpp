@@ -19,6 +19,7 @@
 #include <gtk/gtk.h>         // for GtkWidget, gtk_co...
 
 #include "control/AudioController.h"                // for AudioController
+#include "control/AudioFollowHighlight.h"           // for AudioFollowHighlight
 #include "control/Control.h"                        // for Control
 #include "control/ScrollHandler.h"                  // for ScrollHandler
 #include "control/layer/LayerController.h"          // for LayerControl
@@ -74,6 +75,7 @@
 #include "util/serdesstream.h"                      // for serdes_stream
 #include "util/gtk4_helper.h"                       // for gtk_box_append
 #include "view/DebugShowRepaintBounds.h"            // for IF_DEBUG_REPAINT
+#include "view/overlays/AudioFollowHighlightView.h"
 #include "view/overlays/OverlayView.h"              // for OverlayView, Tool...
 #include "view/overlays/PdfElementSelectionView.h"  // for PdfElementSelecti...
 #include "view/overlays/SearchResultView.h"         // for SearchResultView
@@ -95,8 +97,6 @@ XojPageView::XojPageView(XournalView* xournal, const PageRef& page):
         page(page),
         xournal(xournal),
         settings(xournal->getControl()->getSettings()),
-        eraser(new EraseHandler(xournal->getControl()->getUndoRedoHandler(), xournal->getControl()->getDocument(),
-                                this->page, xournal->getControl()->getToolHandler(), this)),
         oldtext(nullptr) {
     this->registerToHandler(this->page);
 }
@@ -131,6 +131,38 @@ void XojPageView::setIsVisible(bool visible) {
     }
 }
 
+void XojPageView::setLive(bool live) {
+    if (live == this->live) {
+        return;
+    }
+    this->live = live;
+
+    if (live) {
+        auto view = std::make_unique<xoj::view::AudioFollowHighlightView>(
+                xournal->getControl()->getAudioController()->getFollowHighlight(), this->page.get(), this,
+                settings->getSelectionColor());
+        this->audioFollowHighlightView = view.get();
+        this->overlayViews.emplace_back(std::move(view));
+    } else {
+        auto it = std::find_if(this->overlayViews.begin(), this->overlayViews.end(),
+                               [&](const auto& v) { return v.get() == this->audioFollowHighlightView; });
+        if (it != this->overlayViews.end()) {
+            this->overlayViews.erase(it);
+        }
+        this->audioFollowHighlightView = nullptr;
+    }
+}
+
+auto XojPageView::isLive() const -> bool { return this->live; }
+
+auto XojPageView::discardIfNotLive() -> bool {
+    if (this->live) {
+        return false;
+    }
+    deleteViewBuffer();
+    return true;
+}
+
 auto XojPageView::getLastVisibleTime() -> int {
     if (!this->crBuffer) {
         return -1;
@@ -142,6 +174,9 @@ auto XojPageView::getLastVisibleTime() -> int {
 void XojPageView::deleteViewBuffer() {
     std::lock_guard lock(this->drawingMutex);
     this->crBuffer.reset();
+    this->pyramid.clear();
+    this->pendingRenderWidth = 0;
+    this->layerRasterCache.clear();
 }
 
 auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
@@ -391,6 +426,10 @@ auto XojPageView::onButtonPressEvent(const PositionInputData& pos) -> bool {
         }
         this->inputHandler->onButtonPressEvent(pos, zoom);
     } else if (h->getToolType() == TOOL_ERASER) {
+        if (!this->eraser) {
+            this->eraser = new EraseHandler(control->getUndoRedoHandler(), control->getDocument(), this->page,
+                                            control->getToolHandler(), this);
+        }
         this->eraser->erase(x, y);
         this->inEraser = true;
     } else if (h->getToolType() == TOOL_VERTICAL_SPACE) {
@@ -817,6 +856,7 @@ auto XojPageView::onKeyReleaseEvent(GdkEventKey* event) -> bool {
 }
 
 void XojPageView::rerenderPage() {
+    this->layerRasterCache.clear();
     this->rerenderComplete = true;
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
@@ -837,6 +877,9 @@ void XojPageView::drawAndDeleteToolView(xoj::view::ToolView* v, const Range& rg)
         std::lock_guard lock(this->drawingMutex);
         xoj::util::CairoSPtr cr(cairo_create(this->crBuffer.get()), xoj::util::adopt);
         v->drawWithoutDrawingAids(cr.get());
+        if (!rg.empty()) {
+            this->pyramid.update(this->crBuffer.get(), Rectangle<double>(rg));
+        }
     }
     this->deleteOverlayView(v, rg);
 }
@@ -866,28 +909,19 @@ double XojPageView::getWidth() const { return page->getWidth(); }
 double XojPageView::getHeight() const { return page->getHeight(); }
 
 void XojPageView::rerenderRect(double x, double y, double width, double height) {
+    auto rect = Rectangle<double>{x, y, width, height};
+    this->layerRasterCache.invalidate(this->page, rect);
+
     if (this->rerenderComplete) {
         return;
     }
 
-    auto rect = Rectangle<double>{x, y, width, height};
-
-    this->repaintRectMutex.lock();
-
-    for (auto&& r: this->rerenderRects) {
-        // its faster to redraw only one rect than repaint twice the same area
-        // so loop through the rectangles to be redrawn, if new rectangle
-        // intersects any of them, replace it by the union with the new one
-        if (r.intersects(rect)) {
-            r.unite(rect);
-            this->repaintRectMutex.unlock();
-            return;
-        }
+    {
+        // Rerendering a few larger rectangles in one go is faster than many small ones: the region merges them
+        std::lock_guard lock(this->repaintRectMutex);
+        this->rerenderRegion.add(rect);
     }
 
-    this->rerenderRects.push_back(rect);
-    this->repaintRectMutex.unlock();
-
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
 
@@ -1059,12 +1093,17 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
         int dispWidth = getDisplayWidth();
         cairo_scale(cr, zoom, zoom);
 
-        double width = cairo_image_surface_get_width(this->crBuffer.get());
+        // While the coarse pass of a render is shown, the full-resolution pass is already queued
+        double width = this->pendingRenderWidth > 0 ? this->pendingRenderWidth :
+                                                      cairo_image_surface_get_width(this->crBuffer.get());
 
         if (width / xournal->getDpiScaleFactor() != dispWidth) {
             rerenderPage();
         }
-        cairo_set_source_surface(cr, this->crBuffer.get(), 0, 0);
+
+        // After zooming out, a downscaled copy of the buffer is faster to paint and does not alias
+        cairo_surface_t* source = this->pyramid.getLevel(zoom * xournal->getDpiScaleFactor());
+        cairo_set_source_surface(cr, source ? source : this->crBuffer.get(), 0, 0);
 
         if (rect) {
             cairo_rectangle(cr, rect->x, rect->y, rect->width, rect->height);
@@ -1192,31 +1231,81 @@ auto XojPageView::getRect() const -> Rectangle<double> {
     return Rectangle<double>(getX(), getY(), getDisplayWidth(), getDisplayHeight());
 }
 
-void XojPageView::rectChanged(Rectangle<double>& rect) { rerenderRect(rect.x, rect.y, rect.width, rect.height); }
+void XojPageView::rectChanged(Rectangle<double>& rect) {
+    if (discardIfNotLive()) {
+        return;
+    }
+    rerenderRect(rect.x, rect.y, rect.width, rect.height);
+}
 
-void XojPageView::rangeChanged(Range& range) { rerenderRange(range); }
+void XojPageView::rangeChanged(Range& range) {
+    if (discardIfNotLive()) {
+        return;
+    }
+    rerenderRange(range);
+}
 
-void XojPageView::pageChanged() { rerenderPage(); }
+void XojPageView::pageChanged() {
+    if (discardIfNotLive()) {
+        return;
+    }
+    rerenderPage();
+}
 
 void XojPageView::elementChanged(Element* elem) {
+    if (discardIfNotLive()) {
+        return;
+    }
     /*
      * The input handlers issue an elementChanged event when creating an element.
-     * There is however no need to redraw the element in this case: the element was already painted to the buffer via a
-     * call to drawAndDeleteToolView
-     * There are a couple of exceptions:
-     *  * if the added element is not on the top-most layer, a rerendering is required to draw it under the upper layers
-     *  * if the added element overflows out of the visible part of the page, the ToolView may not have drawn to the
-     *    page buffer the part outside the visible area. Rerendering as well
+     * There is however no need to rerender the area in this case: the element was already painted to the buffer via a
+     * call to drawAndDeleteToolView, and compositeNewElement() only refreshes the downscaled copies of the buffer.
+     * A rerendering is still required if the added element is not on the top-most layer (to draw it under the upper
+     * layers), or if the ToolView could not paint all of it.
      */
-    const bool noRerender = inputHandler && elem == inputHandler->getStroke() &&
-                            page->getSelectedLayerId() == page->getLayerCount() &&
-                            getVisiblePart().contains(elem->boundingRect());
-    if (!noRerender) {
+    const bool isNewTopElement = inputHandler && elem == inputHandler->getStroke() &&
+                                 page->getSelectedLayerId() == page->getLayerCount();
+    if (isNewTopElement && compositeNewElement(elem)) {
+        // The element is already in the buffer, but not in the cached rasters
+        this->layerRasterCache.invalidate(this->page, elem->boundingRect());
+    } else {
         rerenderElement(elem);
     }
 }
 
+/**
+ * The filled highlighters are painted through a Mask which only covers the visible part (see
+ * BaseStrokeToolView::createMask)
+ */
+static auto isPaintedOnVisiblePartOnly(const Element* elem) -> bool {
+    const auto* s = dynamic_cast<const Stroke*>(elem);
+    return s && s->getToolType() == StrokeTool::HIGHLIGHTER && s->getFill() != -1;
+}
+
+auto XojPageView::compositeNewElement(const Element* elem) -> bool {
+    const auto& elements = page->getSelectedLayer()->getElements();
+    if (elements.empty() || elements.back() != elem) {
+        // Something lies on top of it
+        return false;
+    }
+
+    const Rectangle<double> bbox = elem->boundingRect();
+    if (isPaintedOnVisiblePartOnly(elem) && !getVisiblePart().contains(bbox)) {
+        // Painting the rest onto the buffer would blend the filling twice along the border of the visible part
+        return false;
+    }
+
+    std::lock_guard lock(this->drawingMutex);
+    if (this->crBuffer) {
+        this->pyramid.update(this->crBuffer.get(), bbox);
+    }
+    return true;
+}
+
 void XojPageView::elementsChanged(const std::vector<Element*>& elements, const Range& range) {
+    if (discardIfNotLive()) {
+        return;
+    }
     if (!range.empty()) {
         rerenderRange(range);
     }
@@ -23,9 +23,12 @@
 
 #include "model/PageListener.h"       // for PageListener
 #include "model/PageRef.h"            // for PageRef
+#include "util/DirtyRegion.h"         // for DirtyRegion
 #include "util/Rectangle.h"           // for Rectangle
 #include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+#include "view/LayerRasterCache.h"    // for LayerRasterCache
 #include "view/Repaintable.h"         // for Repaintable
+#include "view/ResolutionPyramid.h"   // for ResolutionPyramid
 
 #include "Layout.h"            // for Layout
 #include "LegacyRedrawable.h"  // for LegacyRedrawable
@@ -90,6 +93,20 @@ public:
 
     void setIsVisible(bool visible);
 
+    /**
+     * Only the pages in and near the viewport are live. The other pages do not follow the changes of their content:
+     * they discard their buffer instead, and render it again when they are painted. They do not follow the audio
+     * playback either.
+     */
+    void setLive(bool live);
+    bool isLive() const;
+
+    /**
+     * Discards the buffer of a page which is not live
+     * @return true if the page is not live, i.e. it must not be rendered
+     */
+    bool discardIfNotLive();
+
     bool isSelected() const;
 
     void endText();
@@ -241,6 +258,16 @@ private:
 
     void deleteView(xoj::view::OverlayView* v);
 
+    /**
+     * @brief Completes the painting of an element the input handler just added on top of the page.
+     *
+     * The input handler's view already painted the whole element onto the buffer (the strokes are kept on a TiledMask
+     * which covers the whole page), so only the downscaled copies of the buffer need to be refreshed.
+     * @return false if the area needs to be rerendered instead: if something lies on top of the element, or if it is a
+     * filled highlighter which overflows the visible part (its view only paints the visible part).
+     */
+    bool compositeNewElement(const Element* elem);
+
 private:
     PageRef page;
     XournalView* xournal = nullptr;
@@ -267,9 +294,32 @@ private:
 
     bool selected = false;
 
+    bool live = false;
+
+    /**
+     * Highlight of the audio playback, only present while the page is live. Owned by overlayViews.
+     */
+    xoj::view::OverlayView* audioFollowHighlightView = nullptr;
+
     xoj::util::CairoSurfaceSPtr crBuffer;
     std::mutex drawingMutex;
 
+    /**
+     * Downscaled copies of crBuffer, painted while zooming out. Guarded by drawingMutex.
+     */
+    xoj::view::ResolutionPyramid pyramid;
+
+    /**
+     * Width in pixels of the full-resolution render queued by RenderJob while crBuffer holds its coarse pass, or 0.
+     * Guarded by drawingMutex.
+     */
+    int pendingRenderWidth = 0;
+
+    /**
+     * Rasters of the layers which are not edited, used by RenderJob when rerendering a part of the page
+     */
+    xoj::view::LayerRasterCache layerRasterCache;
+
     bool inEraser = false;
 
     /**
@@ -288,7 +338,10 @@ private:
     long int lastVisibleTime = -1;
 
     std::mutex repaintRectMutex;
-    std::vector<xoj::util::Rectangle<double>> rerenderRects;
+    /**
+     * Parts of the page to rerender, guarded by repaintRectMutex
+     */
+    xoj::util::DirtyRegion rerenderRegion;
     bool rerenderComplete = false;
 
     int dispX{};  // position on display - set in Layout::layoutPages
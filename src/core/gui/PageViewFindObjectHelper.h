@@ -15,9 +15,11 @@
 
 #include <limits>
 #include <optional>
+#include <vector>
 
 #include "control/AudioController.h"
 #include "control/tools/EditSelection.h"
+#include "model/AudioIndex.h"
 #include "util/PathUtil.h"
 
 #include "XournalView.h"
@@ -55,13 +57,15 @@ public:
     }
 
 protected:
-    bool checkLayer(Layer* l) {
+    virtual bool checkLayer(Layer* l) { return checkElements(l->getElements()); }
+
+    bool checkElements(const std::vector<Element*>& elements) {
         /* Search for Element whose bounding box center is closest to the place (x,y) where the object is searched for.
          * Only those strokes are taken into account that pass the appropriate checkElement test.
          */
         bool found = false;
         double minDistSq = std::numeric_limits<double>::max();
-        for (Element* e: l->getElements()) {
+        for (Element* e: elements) {
             const double eX = e->getX() + e->getElementWidth() / 2.0;
             const double eY = e->getY() + e->getElementHeight() / 2.0;
             const double dx = eX - this->x;
@@ -153,17 +157,27 @@ public:
     bool at(double x, double y, bool multiLayer = false) override { return BaseSelectObject::at(x, y, multiLayer); }
 
 protected:
-    bool checkElement(Element* e) override {
-        if (e->getType() != ELEMENT_STROKE && e->getType() != ELEMENT_TEXT) {
-            return false;
+    bool checkLayer(Layer* l) override {
+        // Only the elements linked to a recording can be played: get them from the index instead of testing them all
+        std::vector<Element*> linked;
+        for (auto const& entry: getAudioIndex().findOnPage(view->getPage())) {
+            if (entry.layer == l) {
+                linked.push_back(entry.element);
+            }
         }
+        return checkElements(linked);
+    }
 
-        AudioElement* s = (AudioElement*)e;
+    bool checkElement(Element* e) override {
+        auto* s = static_cast<AudioElement*>(e);  // Only the elements of the index are checked
         double tmpGap = 0;
-        if ((s->intersects(x, y, 15, &tmpGap))) {
-            size_t ts = s->getTimestamp();
+        if (s->intersects(x, y, 15, &tmpGap)) {
+            auto recording = getAudioIndex().find(e);
+            if (!recording) {
+                return false;
+            }
 
-            if (auto fn = s->getAudioFilename(); !fn.empty()) {
+            if (auto [fn, ts] = *recording; !fn.empty()) {
                 if (!fn.has_parent_path() || fs::weakly_canonical(fn.parent_path()) == "/") {
                     auto const& path = view->settings->getAudioFolder();
                     // Assume path exists
@@ -177,4 +191,7 @@ protected:
         }
         return false;
     }
+
+private:
+    AudioIndex& getAudioIndex() const { return view->getXournal()->getControl()->getDocument()->getAudioIndex(); }
 };
@@ -1,18 +1,25 @@
 #include "SearchBar.h"
 
-#include <string>  // for allocator, string
+#include <algorithm>  // for find
+#include <numeric>    // for accumulate
+#include <string>     // for allocator, string
+#include <vector>     // for vector
 
 #include <gdk/gdk.h>         // for GdkEventKey, GDK_SHIFT_MASK
 #include <gdk/gdkkeysyms.h>  // for GDK_KEY_Return
 #include <glib-object.h>     // for G_CALLBACK, g_signal_connect
 #include <glib.h>            // for g_free, g_strdup_printf
 
-#include "control/Control.h"         // for Control
-#include "control/ScrollHandler.h"   // for ScrollHandler
-#include "gui/MainWindow.h"          // for MainWindow
-#include "model/Document.h"          // for Document
-#include "util/PlaceholderString.h"  // for PlaceholderString
-#include "util/i18n.h"               // for _, FC, _F
+#include "control/Control.h"                // for Control
+#include "control/ScrollHandler.h"          // for ScrollHandler
+#include "control/jobs/Scheduler.h"         // for JOB_PRIORITY_NONE
+#include "control/jobs/SearchIndexJob.h"    // for SearchIndexJob
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "gui/MainWindow.h"                 // for MainWindow
+#include "model/Document.h"                 // for Document
+#include "model/SearchIndex.h"              // for SearchIndex
+#include "util/PlaceholderString.h"         // for PlaceholderString
+#include "util/i18n.h"                      // for _, FC, NG_F
 
 SearchBar::SearchBar(Control* control): control(control) {
     MainWindow* win = control->getWindow();
@@ -68,16 +75,26 @@ void SearchBar::search(const char* text) {
 
     if (*text != 0) {
         found = searchTextonCurrentPage(text, &occurrences, nullptr);
-        if (found) {
-            if (occurrences == 1) {
-                gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text found on this page"));
-            } else {
-                char* msg = g_strdup_printf(_("Text %zu times found on this page"), occurrences);
-                gtk_label_set_text(GTK_LABEL(lbSearchState), msg);
-                g_free(msg);
-            }
+        std::optional<size_t> total = countMatchesInDocument(text);
+        if (found && total) {
+            gtk_label_set_text(GTK_LABEL(lbSearchState),
+                               FC(NG_F("{1} of {2} match in the document is on this page",
+                                       "{1} of {2} matches in the document are on this page", *total) %
+                                  occurrences % *total));
+        } else if (found) {
+            gtk_label_set_text(GTK_LABEL(lbSearchState),
+                               FC(NG_F("Text found {1} time on this page", "Text found {1} times on this page",
+                                       occurrences) %
+                                  occurrences));
+        } else if (total.value_or(0) > 0) {
+            found = true;
+            gtk_label_set_text(GTK_LABEL(lbSearchState),
+                               FC(NG_F("Text found {1} time in the document", "Text found {1} times in the document",
+                                       *total) %
+                                  *total));
         } else {
-            gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found"));
+            gtk_label_set_text(GTK_LABEL(lbSearchState),
+                               total ? _("Text not found") : _("Text not found on this page"));
         }
     } else {
         searchTextonCurrentPage("", nullptr, nullptr);
@@ -91,6 +108,18 @@ void SearchBar::search(const char* text) {
     }
 }
 
+auto SearchBar::countMatchesInDocument(const char* text) const -> std::optional<size_t> {
+    Document* doc = control->getDocument();
+    doc->lock();
+    std::vector<size_t> matches = doc->getSearchIndex().countMatches(text);
+    doc->unlock();
+
+    if (std::find(matches.begin(), matches.end(), SearchIndex::UNKNOWN) != matches.end()) {
+        return std::nullopt;
+    }
+    return std::accumulate(matches.begin(), matches.end(), size_t{0});
+}
+
 void SearchBar::searchTextChangedCallback(GtkEntry* entry, SearchBar* searchBar) {
     const char* text = gtk_entry_get_text(entry);
     searchBar->search(text);
@@ -118,16 +147,26 @@ void SearchBar::search(Fun next) const {
     double yOfUpperMostMatch = 0;
     size_t occurrences = 0;
 
-    // Search backwards through the pages, wrapping around if needed.
+    // The index tells which pages contain matches: only those are searched for the match positions
+    Document* doc = control->getDocument();
+    doc->lock();
+    std::vector<size_t> matches = doc->getSearchIndex().countMatches(text);
+    doc->unlock();
+
+    // Search through the pages, wrapping around if needed.
     for (size_t searchedPage = next(currentPage); searchedPage != currentPage; searchedPage = next(searchedPage)) {
+        // Pages which are not indexed yet (SearchIndex::UNKNOWN) are searched directly
+        if (searchedPage < matches.size() && matches[searchedPage] == 0) {
+            continue;
+        }
 
         bool found = control->searchTextOnPage(text, searchedPage, &occurrences, &yOfUpperMostMatch);
         if (found) {
             control->getScrollHandler()->scrollToPage(searchedPage, yOfUpperMostMatch);
-            gtk_label_set_text(
-                    GTK_LABEL(lbSearchState),
-                    (occurrences == 1 ? FC(_F("Text found once on page {1}") % (searchedPage + 1)) :
-                                        FC(_F("Text found {1} times on page {2}") % occurrences % (searchedPage + 1))));
+            gtk_label_set_text(GTK_LABEL(lbSearchState),
+                               FC(NG_F("Text found {1} time on page {2}", "Text found {1} times on page {2}",
+                                       occurrences) %
+                                  occurrences % (searchedPage + 1)));
             return;
         }
     }
@@ -152,6 +191,13 @@ void SearchBar::showSearchBar(bool show) {
     GtkWidget* searchBar = win->get("searchBar");
 
     if (show) {
+        // Index the text of the PDF background while the user types
+        if (control->getDocument()->getSearchIndex().startIndexing()) {
+            auto* job = new SearchIndexJob(control);
+            control->getScheduler()->addJob(job, JOB_PRIORITY_NONE);
+            job->unref();
+        }
+
         GtkWidget* searchTextField = win->get("searchTextField");
         gtk_widget_grab_focus(searchTextField);
         gtk_widget_show_all(searchBar);
@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <cstddef>   // for size_t
+#include <optional>  // for optional
+
 #include <gtk/gtk.h>             // for GtkButton, GtkEntry
 #include <gtk/gtkcssprovider.h>  // for GtkCssProvider
 
@@ -53,6 +56,12 @@ private:
     void searchPrevious() const;
 
     void search(const char* text);
+
+    /**
+     * @return The number of matches in the whole document according to the search index, or nothing if the PDF
+     * background is not completely indexed yet
+     */
+    std::optional<size_t> countMatchesInDocument(const char* text) const;
     bool searchTextonCurrentPage(const char* text, size_t* occurrences, double* yOfUpperMostMatch);
 
 private:
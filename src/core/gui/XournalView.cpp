@@ -1,10 +1,13 @@
 #include "XournalView.h"
 
-#include <algorithm>  // for max, min
-#include <cmath>      // for lround
-#include <iterator>   // for begin
-#include <memory>     // for unique_ptr, make_unique
-#include <optional>   // for optional
+#include <algorithm>      // for max, min, find, remove, transform
+#include <cmath>          // for lround
+#include <cstddef>        // for ptrdiff_t
+#include <iterator>       // for begin, back_inserter
+#include <memory>         // for unique_ptr, make_unique
+#include <optional>       // for optional
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
 
 #include <gdk/gdk.h>         // for GdkEventKey, GDK_SHIF...
 #include <gdk/gdkkeysyms.h>  // for GDK_KEY_Page_Down
@@ -39,6 +42,7 @@
 #include "util/Point.h"                          // for Point
 #include "util/Rectangle.h"                      // for Rectangle
 #include "util/Util.h"                           // for npos
+#include "view/background/RulingTileCache.h"     // for RulingTileCache
 
 #include "Layout.h"           // for Layout
 #include "PageView.h"         // for XojPageView
@@ -56,7 +60,7 @@ std::pair<size_t, size_t> XournalView::preloadPageBounds(size_t page, size_t max
 }
 
 XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* scrollHandling):
-        scrollHandling(scrollHandling), control(control) {
+        scrollHandling(scrollHandling), control(control), rulingCache(std::make_unique<xoj::view::RulingTileCache>()) {
     Document* doc = control->getDocument();
     doc->lock();
     if (doc->getPdfPageCount() != 0) {
@@ -91,6 +95,8 @@ XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* sc
 XournalView::~XournalView() {
     g_source_remove(this->cleanupTimeout);
 
+    this->visiblePages.clear();
+    this->livePages.clear();
     for (auto&& page: viewPages) {
         delete page;
     }
@@ -129,12 +135,55 @@ auto XournalView::cleanupBufferCache() -> void {
         auto&& page = this->viewPages[i];
         const size_t pageNum = i + 1;
         const bool isPreload = pagesLower <= pageNum && pageNum <= pagesUpper;
-        if (!isPreload && page->getLastVisibleTime() > 0 && page->getBufferPixels() > 0) {
+        // A page which was never visible (e.g. preloaded) has no last visible time
+        if (!isPreload && page->getLastVisibleTime() != 0 && page->getBufferPixels() > 0) {
             page->deleteViewBuffer();
         }
     }
 }
 
+void XournalView::updateLivePages(const std::vector<size_t>& visible, const std::vector<size_t>& live) {
+    auto toViews = [&](const std::vector<size_t>& pages) {
+        std::vector<XojPageView*> views;
+        views.reserve(pages.size());
+        std::transform(pages.begin(), pages.end(), std::back_inserter(views),
+                       [&](size_t p) { return this->viewPages[p]; });
+        return views;
+    };
+    auto contains = [](const std::vector<XojPageView*>& views, XojPageView* v) {
+        return std::find(views.begin(), views.end(), v) != views.end();
+    };
+
+    auto newVisible = toViews(visible);
+    for (XojPageView* v: this->visiblePages) {
+        if (!contains(newVisible, v)) {
+            v->setIsVisible(false);
+        }
+    }
+    for (XojPageView* v: newVisible) {
+        v->setIsVisible(true);
+    }
+
+    auto newLive = toViews(live);
+    for (XojPageView* v: this->livePages) {
+        if (!contains(newLive, v)) {
+            v->setLive(false);
+        }
+    }
+    for (XojPageView* v: newLive) {
+        v->setLive(true);
+    }
+
+    this->visiblePages = std::move(newVisible);
+    this->livePages = std::move(newLive);
+}
+
+void XournalView::removeFromLivePages(XojPageView* view) {
+    this->visiblePages.erase(std::remove(this->visiblePages.begin(), this->visiblePages.end(), view),
+                             this->visiblePages.end());
+    this->livePages.erase(std::remove(this->livePages.begin(), this->livePages.end(), view), this->livePages.end());
+}
+
 auto XournalView::getCurrentPage() const -> size_t { return currentPage; }
 
 const int scrollKeySize = 30;
@@ -542,7 +591,7 @@ void XournalView::pageSizeChanged(size_t page) {
 }
 
 void XournalView::pageChanged(size_t page) {
-    if (page != npos && page < this->viewPages.size()) {
+    if (page != npos && page < this->viewPages.size() && !this->viewPages[page]->discardIfNotLive()) {
         this->viewPages[page]->rerenderPage();
     }
 }
@@ -550,6 +599,7 @@ void XournalView::pageChanged(size_t page) {
 void XournalView::pageDeleted(size_t page) {
     size_t currentPage = control->getCurrentPageNo();
 
+    removeFromLivePages(this->viewPages[page]);
     delete this->viewPages[page];
     viewPages.erase(begin(viewPages) + page);
 
@@ -569,6 +619,8 @@ auto XournalView::getTextEditor() const -> TextEditor* {
 
 auto XournalView::getCache() const -> PdfCache* { return this->cache.get(); }
 
+auto XournalView::getRulingCache() const -> xoj::view::RulingTileCache* { return this->rulingCache.get(); }
+
 void XournalView::pageInserted(size_t page) {
     Document* doc = control->getDocument();
     doc->lock();
@@ -583,6 +635,41 @@ void XournalView::pageInserted(size_t page) {
     layout->updateVisibility();
 }
 
+void XournalView::pagesChanged(size_t firstPage) {
+    firstPage = std::min(firstPage, this->viewPages.size());
+
+    // Keep the views of the pages which are still in the document, and only create the missing ones
+    std::unordered_map<const XojPage*, XojPageView*> oldViews;
+    for (auto it = begin(viewPages) + static_cast<std::ptrdiff_t>(firstPage); it != end(viewPages); ++it) {
+        oldViews.emplace((*it)->getPage().get(), *it);
+    }
+    viewPages.resize(firstPage);
+
+    Document* doc = control->getDocument();
+    doc->lock();
+    size_t len = doc->getPageCount();
+    for (size_t i = firstPage; i < len; i++) {
+        PageRef page = doc->getPage(i);
+        if (auto it = oldViews.find(page.get()); it != oldViews.end()) {
+            viewPages.push_back(it->second);
+            oldViews.erase(it);
+        } else {
+            viewPages.push_back(new XojPageView(this, page));
+        }
+    }
+    doc->unlock();
+
+    for (auto& [page, view]: oldViews) {
+        removeFromLivePages(view);
+        delete view;
+    }
+
+    layoutPages();
+    // check which pages are visible and select the most visible page
+    Layout* layout = gtk_xournal_get_layout(this->widget);
+    layout->updateVisibility();
+}
+
 auto XournalView::getZoom() const -> double { return control->getZoomControl()->getZoom(); }
 
 auto XournalView::getDpiScaleFactor() const -> int { return gtk_widget_get_scale_factor(widget); }
@@ -727,6 +814,8 @@ void XournalView::documentChanged(DocumentChangeType type) {
 
     clearSelection();
 
+    this->visiblePages.clear();
+    this->livePages.clear();
     for (auto&& page: viewPages) {
         delete page;
     }
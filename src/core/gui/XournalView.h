@@ -32,6 +32,9 @@ class Document;
 class EditSelection;
 class XojPageView;
 class PdfCache;
+namespace xoj::view {
+class RulingTileCache;
+};
 class RepaintHandler;
 class ScrollHandling;
 class TextEditor;
@@ -99,6 +102,7 @@ public:
     int getDpiScaleFactor() const;
     Document* getDocument() const;
     PdfCache* getCache() const;
+    xoj::view::RulingTileCache* getRulingCache() const;
     RepaintHandler* getRepaintHandler() const;
     GtkWidget* getWidget() const;
     XournalppCursor* getCursor() const;
@@ -133,6 +137,7 @@ public:
     void pageChanged(size_t page) override;
     void pageInserted(size_t page) override;
     void pageDeleted(size_t page) override;
+    void pagesChanged(size_t firstPage) override;
     void documentChanged(DocumentChangeType type) override;
 
 public:
@@ -152,6 +157,16 @@ private:
 
     void cleanupBufferCache();
 
+    /**
+     * Called by the Layout with the indices of the pages in the visible area and of the pages near it
+     */
+    void updateLivePages(const std::vector<size_t>& visible, const std::vector<size_t>& live);
+
+    /**
+     * Forgets a page view which is about to be deleted
+     */
+    void removeFromLivePages(XojPageView* view);
+
     static void staticLayoutPages(GtkWidget* widget, GtkAllocation* allocation, void* data);
 
 private:
@@ -165,6 +180,12 @@ private:
 
     std::vector<XojPageView*> viewPages;
 
+    /**
+     * The visible and the live pages (see XojPageView::setLive()), as of the last call to updateLivePages()
+     */
+    std::vector<XojPageView*> visiblePages;
+    std::vector<XojPageView*> livePages;
+
     Control* control = nullptr;
 
     size_t currentPage = 0;
@@ -172,6 +193,8 @@ private:
 
     std::unique_ptr<PdfCache> cache;
 
+    std::unique_ptr<xoj::view::RulingTileCache> rulingCache;
+
     /**
      * Handler for rerendering pages / repainting pages
      */
@@ -38,6 +38,8 @@ void AbstractInputHandler::block(bool block) {
 
 auto AbstractInputHandler::isBlocked() const -> bool { return this->blocked; }
 
+auto AbstractInputHandler::isInputRunning() const -> bool { return this->inputRunning; }
+
 auto AbstractInputHandler::handle(InputEvent const& event) -> bool {
     if (!this->blocked) {
         this->inputContext->getXournal()->view->getCursor()->setInputDeviceClass(event.deviceClass);
@@ -38,6 +38,7 @@ public:
 
     void block(bool block);
     bool isBlocked() const;
+    bool isInputRunning() const;
     virtual void onBlock();
     virtual void onUnblock();
     bool handle(InputEvent const& event);
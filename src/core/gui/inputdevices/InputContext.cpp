@@ -6,6 +6,7 @@
 
 #include <cassert>  // for assert
 #include <cstddef>  // for NULL
+#include <utility>  // for swap
 #include <vector>   // for vector
 
 #include <glib-object.h>  // for g_signal_hand...
@@ -21,6 +22,8 @@
 #include "gui/inputdevices/StylusInputHandler.h"        // for StylusInputHa...
 #include "gui/inputdevices/TouchDrawingInputHandler.h"  // for TouchDrawingI...
 #include "gui/inputdevices/TouchInputHandler.h"         // for TouchInputHan...
+#include "gui/widgets/FrameTimingMonitor.h"             // for FrameTimingMonitor
+#include "util/Tracing.h"                               // for XOJ_TRACE_SCOPE
 
 #include "InputEvents.h"   // for InputEvent
 #include "config-debug.h"  // for DEBUG_INPUT
@@ -46,6 +49,10 @@ InputContext::InputContext(XournalView* view, ScrollHandling* scrollHandling) {
 InputContext::~InputContext() {
     // Destructor is called in xournal_widget_dispose, so it can still accept events
     g_signal_handler_disconnect(this->widget, signal_id);
+    if (this->tickCallbackId) {
+        gtk_widget_remove_tick_callback(this->widget, this->tickCallbackId);
+    }
+    for (GdkEvent* e: this->pendingMotionEvents) { gdk_event_free(e); }
 
     delete this->stylusHandler;
     this->stylusHandler = nullptr;
@@ -86,10 +93,77 @@ void InputContext::connect(GtkWidget* pWidget) {
 }
 
 auto InputContext::eventCallback(GtkWidget* widget, GdkEvent* event, InputContext* self) -> bool {
+    GdkModifierType state{};
+    if (gdk_event_get_event_type(event) == GDK_MOTION_NOTIFY && gdk_event_get_state(event, &state) &&
+        (state & (GDK_BUTTON1_MASK | GDK_BUTTON2_MASK | GDK_BUTTON3_MASK)) && gtk_widget_get_mapped(widget) &&
+        self->canDeferMotionEvent(event)) {
+        // A tablet sends far more motion events than there are frames: collect them until the next frame.
+        // They are not compressed (see XournalView::onRealized), so that every point ends up in the stroke.
+        self->pendingMotionEvents.push_back(gdk_event_copy(event));
+        self->getXournal()->frameTiming->inputHandled();
+        if (!self->tickCallbackId) {
+            self->tickCallbackId =
+                    gtk_widget_add_tick_callback(widget, reinterpret_cast<GtkTickCallback>(onFrameTick), self, nullptr);
+        }
+        // What handle() returns for this event
+        return false;
+    }
+
+    // Any other event is handled after the motion events received before it
+    self->handlePendingMotionEvents();
     return self->handle(event);
 }
 
+auto InputContext::onFrameTick(GtkWidget* widget, GdkFrameClock* clock, InputContext* self) -> gboolean {
+    self->tickCallbackId = 0;
+    self->handlePendingMotionEvents();
+    return G_SOURCE_REMOVE;
+}
+
+auto InputContext::canDeferMotionEvent(GdkEvent* event) -> bool {
+    if (this->geometryToolInputHandler) {
+        // The geometry tools handle some of the drags themselves
+        return false;
+    }
+    GdkDevice* device = gdk_event_get_source_device(event);
+    if (device == nullptr) {
+        return false;
+    }
+
+    AbstractInputHandler* handler = nullptr;
+    switch (InputEvents::translateDeviceType(device, this->getSettings())) {
+        case INPUT_DEVICE_PEN:
+        case INPUT_DEVICE_ERASER:
+            handler = this->stylusHandler;
+            break;
+        case INPUT_DEVICE_MOUSE:
+            handler = this->mouseHandler;
+            break;
+        default:
+            return false;
+    }
+    return !handler->isBlocked() && handler->isInputRunning();
+}
+
+void InputContext::handlePendingMotionEvents() {
+    if (this->pendingMotionEvents.empty()) {
+        return;
+    }
+    XOJ_TRACE_SCOPE("InputContext::handlePendingMotionEvents");
+
+    std::vector<GdkEvent*> events;
+    std::swap(events, this->pendingMotionEvents);
+
+    gtk_xournal_begin_repaint_batch(this->widget);
+    for (GdkEvent* e: events) {
+        handle(e);
+        gdk_event_free(e);
+    }
+    gtk_xournal_end_repaint_batch(this->widget);
+}
+
 auto InputContext::handle(GdkEvent* sourceEvent) -> bool {
+    XOJ_TRACE_SCOPE("InputContext::handle");
     printDebug(sourceEvent);
 
     GdkDevice* sourceDevice = gdk_event_get_source_device(sourceEvent);
@@ -97,6 +171,8 @@ auto InputContext::handle(GdkEvent* sourceEvent) -> bool {
         return false;
     }
 
+    this->getXournal()->frameTiming->inputHandled();
+
     InputEvent event = InputEvents::translateEvent(sourceEvent, this->getSettings());
 
     // Add the device to the list of known devices if it is currently unknown
@@ -15,9 +15,10 @@
 #include <memory>  // for unique_ptr
 #include <set>     // for set
 #include <string>  // for string
+#include <vector>  // for vector
 
 #include <gdk/gdk.h>  // for GdkEvent, GdkModifierType
-#include <glib.h>     // for gulong
+#include <glib.h>     // for gulong, guint, gboolean
 #include <gtk/gtk.h>  // for GtkWidget
 
 #include "gui/widgets/XournalWidget.h"  // for GtkXournal
@@ -52,6 +53,13 @@ private:
 
     std::set<std::string> knownDevices;
 
+    /**
+     * Motion events received since the last frame, while a button was pressed. They are handled together at the
+     * beginning of the next frame.
+     */
+    std::vector<GdkEvent*> pendingMotionEvents;
+    guint tickCallbackId = 0;
+
 public:
     enum DeviceType {
         MOUSE,
@@ -80,6 +88,22 @@ private:
      */
     bool handle(GdkEvent* event);
 
+    /**
+     * Called by the frame clock at the beginning of a frame
+     */
+    static gboolean onFrameTick(GtkWidget* widget, GdkFrameClock* clock, InputContext* self);
+
+    /**
+     * Handles the pending motion events in one batch, which is then repainted once
+     */
+    void handlePendingMotionEvents();
+
+    /**
+     * @return true if the drag motion event can wait for the next frame: it goes to the stylus or mouse handler while
+     * its action runs. Their handle() returns false for motion events, which the event callback can return right away.
+     */
+    bool canDeferMotionEvent(GdkEvent* event);
+
     /**
      * Print debug output
      */
@@ -169,3 +169,5 @@ auto SidebarPreviewBaseEntry::getWidth() -> int { return getWidgetWidth(); }
 auto SidebarPreviewBaseEntry::getHeight() -> int { return getWidgetHeight(); }
 
 auto SidebarPreviewBaseEntry::getWidget() -> GtkWidget* { return this->widget; }
+
+auto SidebarPreviewBaseEntry::getPage() const -> const PageRef& { return this->page; }
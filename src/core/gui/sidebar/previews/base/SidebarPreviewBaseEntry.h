@@ -49,6 +49,11 @@ public:
     virtual int getWidth();
     virtual int getHeight();
 
+    /**
+     * @return The page which is represented
+     */
+    const PageRef& getPage() const;
+
     virtual void setSelected(bool selected);
 
     virtual void repaint();
@@ -84,7 +89,7 @@ protected:
     SidebarPreviewBase* sidebar;
 
     /**
-     * The page which is representated
+     * The page which is represented
      */
     PageRef page;
 
@@ -1,18 +1,22 @@
 #include "SidebarPreviewPages.h"
 
-#include <algorithm>  // for max
-#include <map>        // for map
-#include <memory>     // for uniqu...
-#include <utility>    // for pair
+#include <algorithm>      // for max, min
+#include <cstddef>        // for ptrdiff_t
+#include <map>            // for map
+#include <memory>         // for uniqu...
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair, move
 
 #include <glib-object.h>  // for g_obj...
 
 #include "control/Control.h"                                    // for Control
 #include "control/ScrollHandler.h"                              // for Scrol...
+#include "control/ThumbnailCache.h"                             // for Thumb...
 #include "gui/GladeGui.h"                                       // for GladeGui
 #include "gui/sidebar/previews/base/SidebarPreviewBaseEntry.h"  // for Sideb...
 #include "gui/sidebar/previews/base/SidebarToolbar.h"           // for Sideb...
 #include "model/Document.h"                                     // for Document
+#include "model/DocumentHandler.h"                              // for DocumentHandler
 #include "model/PageRef.h"                                      // for PageRef
 #include "model/XojPage.h"                                      // for XojPage
 #include "undo/CopyUndoAction.h"                                // for CopyU...
@@ -60,9 +64,14 @@ SidebarPreviewPages::SidebarPreviewPages(Control* control, GladeGui* gui, Sideba
     }
     g_assert(this->contextMenuMoveDown != nullptr);
     g_assert(this->contextMenuMoveUp != nullptr);
+
+    // Let the main view fill the thumbnail cache with previews of the right size
+    control->getThumbnailCache()->setPreviewZoom(getZoom());
 }
 
 SidebarPreviewPages::~SidebarPreviewPages() {
+    this->control->getThumbnailCache()->setPreviewZoom(0);
+
     for (const auto& signalTuple: this->contextMenuSignals) {
         GtkWidget* const widget = std::get<0>(signalTuple);
         const guint handlerId = std::get<1>(signalTuple);
@@ -116,8 +125,11 @@ void SidebarPreviewPages::actionPerformed(SidebarActions action) {
             UndoRedoHandler* undo = control->getUndoRedoHandler();
             undo->addUndoAction(std::make_unique<SwapUndoAction>(page - 1, true, swappedPage, otherPage));
 
-            control->firePageDeleted(page);
-            control->firePageInserted(page - 1);
+            {
+                DocumentHandler::PageBatch batch(control);
+                control->firePageDeleted(page);
+                control->firePageInserted(page - 1);
+            }
             control->firePageSelected(page - 1);
 
             control->getScrollHandler()->scrollToPage(page - 1);
@@ -148,8 +160,11 @@ void SidebarPreviewPages::actionPerformed(SidebarActions action) {
             UndoRedoHandler* undo = control->getUndoRedoHandler();
             undo->addUndoAction(std::make_unique<SwapUndoAction>(page, false, swappedPage, otherPage));
 
-            control->firePageDeleted(page);
-            control->firePageInserted(page + 1);
+            {
+                DocumentHandler::PageBatch batch(control);
+                control->firePageDeleted(page);
+                control->firePageInserted(page + 1);
+            }
             control->firePageSelected(page + 1);
 
             control->getScrollHandler()->scrollToPage(page + 1);
@@ -241,6 +256,39 @@ void SidebarPreviewPages::pageInserted(size_t page) {
     layout();
 }
 
+void SidebarPreviewPages::pagesChanged(size_t firstPage) {
+    firstPage = std::min(firstPage, this->previews.size());
+
+    // Keep the previews of the pages which are still in the document, and only create the missing ones
+    std::unordered_map<const XojPage*, std::unique_ptr<SidebarPreviewBaseEntry>> oldPreviews;
+    for (auto it = this->previews.begin() + static_cast<std::ptrdiff_t>(firstPage); it != this->previews.end(); ++it) {
+        const XojPage* page = (*it)->getPage().get();
+        oldPreviews.emplace(page, std::move(*it));
+    }
+    this->previews.resize(firstPage);
+
+    Document* doc = control->getDocument();
+    doc->lock();
+    size_t len = doc->getPageCount();
+    for (size_t i = firstPage; i < len; i++) {
+        PageRef page = doc->getPage(i);
+        if (auto it = oldPreviews.find(page.get()); it != oldPreviews.end()) {
+            this->previews.emplace_back(std::move(it->second));
+            oldPreviews.erase(it);
+        } else {
+            auto p = std::make_unique<SidebarPreviewPageEntry>(this, page);
+            gtk_layout_put(GTK_LAYOUT(this->iconViewPreview), p->getWidget(), 0, 0);
+            this->previews.emplace_back(std::move(p));
+        }
+    }
+    doc->unlock();
+
+    // Unselect page, to prevent double selection displaying
+    unselectPage();
+
+    layout();
+}
+
 /**
  * Unselect the last selected page, if any
  */
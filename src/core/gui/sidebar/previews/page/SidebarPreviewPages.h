@@ -70,6 +70,7 @@ public:
     void pageSelected(size_t page) override;
     void pageInserted(size_t page) override;
     void pageDeleted(size_t page) override;
+    void pagesChanged(size_t firstPage) override;
 
 private:
     /**
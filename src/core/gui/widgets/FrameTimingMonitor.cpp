@@ -0,0 +1,151 @@
+#include "FrameTimingMonitor.h"
+
+#include <algorithm>  // for max
+#include <cmath>      // for ceil, floor
+#include <iomanip>    // for setprecision
+#include <locale>     // for locale
+#include <sstream>    // for ostringstream
+
+#include <pango/pangocairo.h>  // for pango_cairo_create_layout, pango_cairo_show_layout
+
+#include "util/Tracing.h"           // for now, counter, isEnabled
+#include "util/raii/GObjectSPtr.h"  // for GObjectSPtr
+
+/**
+ * Interval between two updates of the HUD, in milliseconds
+ */
+constexpr guint HUD_REFRESH_INTERVAL = 500;
+
+/**
+ * An input event which is not painted within this delay, in microseconds, did not require any repaint
+ */
+constexpr int64_t MAX_LATENCY = 1000000;
+
+constexpr double HUD_PADDING = 6;
+constexpr double HUD_MARGIN = 8;
+
+FrameTimingMonitor::FrameTimingMonitor(GtkWidget* widget): widget(widget) {}
+
+FrameTimingMonitor::~FrameTimingMonitor() { setHudVisible(false); }
+
+void FrameTimingMonitor::setHudVisible(bool visible) {
+    if (visible == this->hudVisible) {
+        return;
+    }
+    this->hudVisible = visible;
+
+    if (visible) {
+        this->refreshTimeoutId = g_timeout_add(HUD_REFRESH_INTERVAL, reinterpret_cast<GSourceFunc>(refreshHud), this);
+        refreshHud(this);
+    } else {
+        g_source_remove(this->refreshTimeoutId);
+        this->refreshTimeoutId = 0;
+        this->hudText.clear();
+    }
+    gtk_widget_queue_draw(this->widget);
+}
+
+auto FrameTimingMonitor::isHudVisible() const -> bool { return this->hudVisible; }
+
+auto FrameTimingMonitor::isActive() const -> bool { return this->hudVisible || xoj::util::trace::isEnabled(); }
+
+void FrameTimingMonitor::inputHandled() {
+    if (isActive() && this->pendingInput < 0) {
+        this->pendingInput = xoj::util::trace::now();
+    }
+}
+
+void FrameTimingMonitor::frameDrawn(int64_t start, double x1, double y1, double x2, double y2) {
+    if (!isActive()) {
+        this->pendingInput = -1;
+        return;
+    }
+
+    const GdkRectangle& hud = this->hudArea;
+    if (x1 >= hud.x && y1 >= hud.y && x2 <= hud.x + hud.width && y2 <= hud.y + hud.height) {
+        // Only the HUD was refreshed
+        return;
+    }
+
+    const int64_t end = xoj::util::trace::now();
+    const int64_t frameTime = end - start;
+    this->frameCount++;
+    this->totalFrameTime += frameTime;
+    this->maxFrameTime = std::max(this->maxFrameTime, frameTime);
+    xoj::util::trace::counter("Frame time (ms)", {{"frame", static_cast<double>(frameTime) / 1000}});
+
+    if (this->pendingInput >= 0) {
+        const int64_t latency = end - this->pendingInput;
+        this->pendingInput = -1;
+        if (latency <= MAX_LATENCY) {
+            this->maxLatency = std::max(this->maxLatency, latency);
+            xoj::util::trace::counter("Input to paint latency (ms)",
+                                      {{"latency", static_cast<double>(latency) / 1000}});
+        }
+    }
+}
+
+auto FrameTimingMonitor::refreshHud(FrameTimingMonitor* self) -> gboolean {
+    std::ostringstream text;
+    text.imbue(std::locale::classic());
+    text << std::fixed << std::setprecision(1);
+    text << "Frame time: ";
+    if (self->frameCount > 0) {
+        text << static_cast<double>(self->totalFrameTime) / self->frameCount / 1000 << " ms avg, "
+             << static_cast<double>(self->maxFrameTime) / 1000 << " ms max";
+    } else {
+        text << "-";
+    }
+    text << "\nInput to paint: ";
+    if (self->maxLatency >= 0) {
+        text << static_cast<double>(self->maxLatency) / 1000 << " ms max";
+    } else {
+        text << "-";
+    }
+    self->hudText = text.str();
+
+    self->frameCount = 0;
+    self->totalFrameTime = 0;
+    self->maxFrameTime = 0;
+    self->maxLatency = -1;
+
+    const GdkRectangle& hud = self->hudArea;
+    if (hud.width > 0 && hud.height > 0) {
+        gtk_widget_queue_draw_area(self->widget, hud.x, hud.y, hud.width, hud.height);
+    }
+    return true;
+}
+
+void FrameTimingMonitor::drawHud(cairo_t* cr, double x, double y) {
+    if (!this->hudVisible) {
+        return;
+    }
+
+    xoj::util::GObjectSPtr<PangoLayout> layout(pango_cairo_create_layout(cr), xoj::util::adopt);
+    PangoFontDescription* desc = pango_font_description_from_string("Monospace 9");
+    pango_layout_set_font_description(layout.get(), desc);
+    pango_font_description_free(desc);
+    pango_layout_set_text(layout.get(), this->hudText.c_str(), -1);
+
+    int textWidth = 0;
+    int textHeight = 0;
+    pango_layout_get_pixel_size(layout.get(), &textWidth, &textHeight);
+
+    // The HUD keeps its size while the text changes, so that it is always redrawn entirely
+    const double left = x + HUD_MARGIN;
+    const double top = y + HUD_MARGIN;
+    const double width = std::max(static_cast<double>(this->hudArea.width), textWidth + 2 * HUD_PADDING);
+    const double height = std::max(static_cast<double>(this->hudArea.height), textHeight + 2 * HUD_PADDING);
+    this->hudArea = {static_cast<int>(std::floor(left)), static_cast<int>(std::floor(top)),
+                     static_cast<int>(std::ceil(width)), static_cast<int>(std::ceil(height))};
+
+    cairo_save(cr);
+    cairo_rectangle(cr, left, top, width, height);
+    cairo_set_source_rgba(cr, 0, 0, 0, 0.7);
+    cairo_fill(cr);
+
+    cairo_move_to(cr, left + HUD_PADDING, top + HUD_PADDING);
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    pango_cairo_show_layout(cr, layout.get());
+    cairo_restore(cr);
+}
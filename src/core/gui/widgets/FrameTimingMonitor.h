@@ -0,0 +1,90 @@
+/*
+ * Xournal++
+ *
+ * Frame time and input-to-paint latency of the main view
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>  // for int64_t
+#include <string>   // for string
+
+#include <cairo.h>    // for cairo_t
+#include <gdk/gdk.h>  // for GdkRectangle
+#include <glib.h>     // for gboolean, guint
+#include <gtk/gtk.h>  // for GtkWidget
+
+/**
+ * @brief Measures how long the main view takes to draw a frame, and how long it takes for an input event to be painted.
+ *
+ * The measures are recorded as counters when the tracing is on (see util/Tracing.h) and, if the HUD is visible, shown
+ * in the top-left corner of the view. Everything happens in the main thread.
+ */
+class FrameTimingMonitor {
+public:
+    explicit FrameTimingMonitor(GtkWidget* widget);
+    FrameTimingMonitor(const FrameTimingMonitor&) = delete;
+    FrameTimingMonitor& operator=(const FrameTimingMonitor&) = delete;
+    ~FrameTimingMonitor();
+
+public:
+    void setHudVisible(bool visible);
+    bool isHudVisible() const;
+
+    /**
+     * An input event was handled: the next frame is expected to paint its result
+     */
+    void inputHandled();
+
+    /**
+     * A frame was drawn
+     * @param start Time at which the drawing started (see xoj::util::trace::now())
+     * @param x1, y1, x2, y2 Extents of the region which was drawn, in widget coordinates
+     */
+    void frameDrawn(int64_t start, double x1, double y1, double x2, double y2);
+
+    /**
+     * Draws the HUD, if it is visible
+     * @param x, y Top-left corner of the visible part of the widget
+     */
+    void drawHud(cairo_t* cr, double x, double y);
+
+private:
+    bool isActive() const;
+
+    /**
+     * Updates the text of the HUD with the measures since the last update
+     */
+    static gboolean refreshHud(FrameTimingMonitor* self);
+
+private:
+    GtkWidget* widget;
+
+    bool hudVisible = false;
+    guint refreshTimeoutId = 0;
+
+    /**
+     * Time of the oldest input event which was not painted yet, or -1
+     */
+    int64_t pendingInput = -1;
+
+    /**
+     * Measures since the last update of the HUD, in microseconds
+     */
+    int frameCount = 0;
+    int64_t totalFrameTime = 0;
+    int64_t maxFrameTime = 0;
+    int64_t maxLatency = -1;
+
+    std::string hudText;
+
+    /**
+     * Where the HUD was last drawn, in widget coordinates
+     */
+    GdkRectangle hudArea{};
+};
@@ -2,6 +2,7 @@
 
 #include <algorithm>  // for max
 #include <cmath>      // for NAN
+#include <cstdint>    // for int64_t
 #include <optional>   // for optional
 #include <vector>     // for vector
 
@@ -20,7 +21,9 @@
 #include "gui/scroll/ScrollHandling.h"      // for ScrollHandling
 #include "util/Color.h"                     // for cairo_set_source_rgbi
 #include "util/Rectangle.h"                 // for Rectangle
+#include "util/Tracing.h"                   // for XOJ_TRACE_SCOPE, now
 
+#include "FrameTimingMonitor.h"  // for FrameTimingMonitor
 
 using xoj::util::Rectangle;
 
@@ -71,6 +74,7 @@ auto gtk_xournal_new(XournalView* view, InputContext* inputContext) -> GtkWidget
     xoj->layout = new Layout(view, inputContext->getScrollHandling());
     xoj->selection = nullptr;
     xoj->input = inputContext;
+    xoj->frameTiming = new FrameTimingMonitor(GTK_WIDGET(xoj));
 
     xoj->input->connect(GTK_WIDGET(xoj));
 
@@ -228,6 +232,18 @@ void gtk_xournal_repaint_area(GtkWidget* widget, int x1, int y1, int x2, int y2)
     g_return_if_fail(widget != nullptr);
     g_return_if_fail(GTK_IS_XOURNAL(widget));
 
+    GtkXournal* xournal = GTK_XOURNAL(widget);
+    if (xournal->repaintBatchDepth > 0) {
+        GdkRectangle area = {x1, y1, x2 - x1, y2 - y1};
+        GdkRectangle& batchArea = xournal->repaintBatchArea;
+        if (batchArea.width > 0 && batchArea.height > 0) {
+            gdk_rectangle_union(&batchArea, &area, &batchArea);
+        } else {
+            batchArea = area;
+        }
+        return;
+    }
+
     if (x2 < 0 || y2 < 0) {
         return;  // outside visible area
     }
@@ -242,10 +258,37 @@ void gtk_xournal_repaint_area(GtkWidget* widget, int x1, int y1, int x2, int y2)
     gtk_widget_queue_draw_area(widget, x1, y1, x2 - x1, y2 - y1);
 }
 
+void gtk_xournal_begin_repaint_batch(GtkWidget* widget) {
+    g_return_if_fail(widget != nullptr);
+    g_return_if_fail(GTK_IS_XOURNAL(widget));
+
+    GTK_XOURNAL(widget)->repaintBatchDepth++;
+}
+
+void gtk_xournal_end_repaint_batch(GtkWidget* widget) {
+    g_return_if_fail(widget != nullptr);
+    g_return_if_fail(GTK_IS_XOURNAL(widget));
+
+    GtkXournal* xournal = GTK_XOURNAL(widget);
+    g_return_if_fail(xournal->repaintBatchDepth > 0);
+    if (--xournal->repaintBatchDepth > 0) {
+        return;
+    }
+
+    GdkRectangle area = xournal->repaintBatchArea;
+    xournal->repaintBatchArea = {};
+    if (area.width > 0 && area.height > 0) {
+        gtk_xournal_repaint_area(widget, area.x, area.y, area.x + area.width, area.y + area.height);
+    }
+}
+
 static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
     g_return_val_if_fail(widget != nullptr, false);
     g_return_val_if_fail(GTK_IS_XOURNAL(widget), false);
 
+    XOJ_TRACE_SCOPE("gtk_xournal_draw");
+    const int64_t frameStart = xoj::util::trace::now();
+
     GtkXournal* xournal = GTK_XOURNAL(widget);
 
     double x1 = NAN, x2 = NAN, y1 = NAN, y2 = NAN;
@@ -260,16 +303,14 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
     // Add a padding for the shadow of the pages
     Rectangle clippingRect(x1 - 10, y1 - 10, x2 - x1 + 20, y2 - y1 + 20);
 
-    for (auto&& pv: xournal->view->getViewPages()) {
+    const auto& viewPages = xournal->view->getViewPages();
+    for (size_t pageNr: xournal->layout->getPagesInRect(clippingRect)) {
+        XojPageView* pv = viewPages[pageNr];
         int px = pv->getX();
         int py = pv->getY();
         int pw = pv->getDisplayWidth();
         int ph = pv->getDisplayHeight();
 
-        if (!clippingRect.intersects(pv->getRect())) {
-            continue;
-        }
-
         gtk_xournal_draw_shadow(xournal, cr, px, py, pw, ph, pv->isSelected());
 
         cairo_save(cr);
@@ -290,6 +331,10 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
         cairo_restore(cr);
     }
 
+    xournal->frameTiming->frameDrawn(frameStart, x1, y1, x2, y2);
+    xournal->frameTiming->drawHud(cr, gtk_adjustment_get_value(xournal->scrollHandling->getHorizontal()),
+                                  gtk_adjustment_get_value(xournal->scrollHandling->getVertical()));
+
     return true;
 }
 
@@ -306,4 +351,7 @@ static void gtk_xournal_dispose(GObject* object) {
 
     delete xournal->input;
     xournal->input = nullptr;
+
+    delete xournal->frameTiming;
+    xournal->frameTiming = nullptr;
 }
@@ -31,6 +31,7 @@ G_BEGIN_DECLS
 #define GTK_IS_XOURNAL(obj) G_TYPE_CHECK_INSTANCE_TYPE(obj, gtk_xournal_get_type())
 
 class EditSelection;
+class FrameTimingMonitor;
 class Layout;
 class XojPageView;
 class ScrollHandling;
@@ -67,6 +68,18 @@ struct _GtkXournal {
      * Input handling
      */
     InputContext* input = nullptr;
+
+    /**
+     * Frame time and input-to-paint latency
+     */
+    FrameTimingMonitor* frameTiming = nullptr;
+
+    /**
+     * Number of nested repaint batches (see gtk_xournal_begin_repaint_batch()), and the area repainted in the current
+     * batch so far
+     */
+    int repaintBatchDepth = 0;
+    GdkRectangle repaintBatchArea{};
 };
 
 struct _GtkXournalClass {
@@ -83,6 +96,13 @@ void gtk_xournal_scroll_relative(GtkWidget* widget, double x, double y);
 
 void gtk_xournal_repaint_area(GtkWidget* widget, int x1, int y1, int x2, int y2);
 
+/**
+ * Starts a repaint batch: until the matching gtk_xournal_end_repaint_batch(), the areas given to
+ * gtk_xournal_repaint_area() are merged, and queued for redrawing once at the end of the batch. Batches can be nested.
+ */
+void gtk_xournal_begin_repaint_batch(GtkWidget* widget);
+void gtk_xournal_end_repaint_batch(GtkWidget* widget);
+
 xoj::util::Rectangle<double>* gtk_xournal_get_visible_area(GtkWidget* widget, const XojPageView* p);
 
 G_END_DECLS
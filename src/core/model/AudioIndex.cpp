@@ -0,0 +1,155 @@
+#include "AudioIndex.h"
+
+#include "model/AudioElement.h"  // for AudioElement
+#include "model/Document.h"      // for Document
+#include "model/Element.h"       // for Element, ELEMENT_STROKE, ELEMENT_TEXT
+#include "model/Layer.h"         // for Layer
+#include "model/XojPage.h"       // for XojPage
+
+AudioIndex::AudioIndex(Document* doc): doc(doc) {}
+
+AudioIndex::~AudioIndex() = default;
+
+auto AudioIndex::keyOf(const fs::path& audioFile) -> std::string { return audioFile.filename().u8string(); }
+
+void AudioIndex::clear() {
+    this->timelines.clear();
+    this->byElement.clear();
+    this->pages.clear();
+}
+
+auto AudioIndex::isUpToDate(PageState& state) -> bool {
+    auto* layers = state.page->getLayers();
+    if (layers->size() != state.layerRevisions.size()) {
+        return false;
+    }
+    auto it = state.layerRevisions.begin();
+    for (Layer* l: *layers) {
+        if (it->first != l || it->second != l->getRevision()) {
+            return false;
+        }
+        ++it;
+    }
+    return true;
+}
+
+void AudioIndex::removePage(PageState& state) {
+    for (const Element* e: state.elements) {
+        auto it = this->byElement.find(e);
+        if (it == this->byElement.end()) {
+            continue;
+        }
+        auto timeline = this->timelines.find(it->second.first);
+        timeline->second.erase(it->second.second);
+        if (timeline->second.empty()) {
+            this->timelines.erase(timeline);
+        }
+        this->byElement.erase(it);
+    }
+    state.elements.clear();
+    state.layerRevisions.clear();
+}
+
+void AudioIndex::scanPage(PageState& state) {
+    for (Layer* l: *state.page->getLayers()) {
+        state.layerRevisions.emplace_back(l, l->getRevision());
+        for (Element* e: l->getElements()) {
+            if (e->getType() != ELEMENT_STROKE && e->getType() != ELEMENT_TEXT) {
+                continue;
+            }
+            auto* a = dynamic_cast<AudioElement*>(e);
+            if (a->getAudioFilename().empty()) {
+                continue;
+            }
+
+            auto key = keyOf(a->getAudioFilename());
+            auto it = this->timelines[key].emplace(a->getTimestamp(), AudioIndexEntry{state.page, l, a});
+            this->byElement.emplace(e, std::make_pair(std::move(key), it));
+            state.elements.push_back(e);
+        }
+    }
+}
+
+void AudioIndex::update() {
+    this->epoch++;
+
+    std::vector<PageState*> outdated;
+    size_t pageCount = this->doc->getPageCount();
+    for (size_t i = 0; i < pageCount; i++) {
+        PageRef page = this->doc->getPage(i);
+        auto& state = this->pages[page.get()];
+        if (!state.page) {
+            state.page = std::move(page);
+            outdated.push_back(&state);
+        } else if (!isUpToDate(state)) {
+            outdated.push_back(&state);
+        }
+        state.epoch = this->epoch;
+    }
+
+    // Drop the pages which were removed from the document
+    if (this->pages.size() != pageCount) {
+        for (auto it = this->pages.begin(); it != this->pages.end();) {
+            if (it->second.epoch != this->epoch) {
+                removePage(it->second);
+                it = this->pages.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Remove all stale entries before rescanning: a deleted element's address may have been reused on another page
+    for (PageState* state: outdated) { removePage(*state); }
+    for (PageState* state: outdated) { scanPage(*state); }
+}
+
+auto AudioIndex::findInRange(const fs::path& audioFile, size_t begin, size_t end) -> std::vector<AudioIndexEntry> {
+    update();
+
+    std::vector<AudioIndexEntry> result;
+    auto timeline = this->timelines.find(keyOf(audioFile));
+    if (timeline == this->timelines.end() || begin >= end) {
+        return result;
+    }
+
+    auto first = timeline->second.lower_bound(begin);
+    auto last = timeline->second.lower_bound(end);
+    for (auto it = first; it != last; ++it) {
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+auto AudioIndex::findOnPage(const PageRef& page) -> std::vector<AudioIndexEntry> {
+    update();
+
+    std::vector<AudioIndexEntry> result;
+    auto state = this->pages.find(page.get());
+    if (state == this->pages.end()) {
+        return result;
+    }
+    result.reserve(state->second.elements.size());
+    for (const Element* e: state->second.elements) {
+        if (auto it = this->byElement.find(e); it != this->byElement.end()) {
+            result.push_back(it->second.second->second);
+        }
+    }
+    return result;
+}
+
+auto AudioIndex::find(const Element* e) -> std::optional<std::pair<fs::path, size_t>> {
+    update();
+
+    auto it = this->byElement.find(e);
+    if (it == this->byElement.end()) {
+        return std::nullopt;
+    }
+    const AudioElement* a = it->second.second->second.element;
+    return std::make_pair(a->getAudioFilename(), a->getTimestamp());
+}
+
+auto AudioIndex::size() -> size_t {
+    update();
+    return this->byElement.size();
+}
@@ -0,0 +1,114 @@
+/*
+ * Xournal++
+ *
+ * Index from audio recordings and timestamps to the elements written at that time
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t
+#include <map>            // for map, multimap
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+#include <vector>         // for vector
+
+#include "PageRef.h"     // for PageRef
+#include "filesystem.h"  // for path
+
+class AudioElement;
+class Document;
+class Element;
+class Layer;
+class XojPage;
+
+struct AudioIndexEntry {
+    PageRef page;
+    Layer* layer;
+    AudioElement* element;
+};
+
+/**
+ * @brief Per-document index (audio file, timestamp) -> elements and back.
+ *
+ * The index is kept up to date lazily: update() compares the revision of every layer with the one seen during the
+ * last scan and only rescans pages that changed (elements inserted, deleted, undone or redone, layers added or
+ * removed, pages inserted or deleted). Queries call update() first, so the results always match the document.
+ *
+ * Recordings are identified by their file name only: the elements store either a bare file name or an absolute path
+ * into the audio folder, and recording names are unique time stamps.
+ *
+ * The document must not be modified while the index is in use (lock it or stay on the main thread).
+ */
+class AudioIndex {
+public:
+    explicit AudioIndex(Document* doc);
+    AudioIndex(const AudioIndex&) = delete;
+    AudioIndex& operator=(const AudioIndex&) = delete;
+    ~AudioIndex();
+
+public:
+    /**
+     * Rescans the pages that changed since the last call
+     */
+    void update();
+
+    /**
+     * Drops all cached data. The next query rebuilds the whole index.
+     */
+    void clear();
+
+    /**
+     * @return All elements recorded with audioFile whose timestamp lies in [begin, end), sorted by timestamp
+     */
+    std::vector<AudioIndexEntry> findInRange(const fs::path& audioFile, size_t begin, size_t end);
+
+    /**
+     * @return All elements of the page which are linked to a recording
+     */
+    std::vector<AudioIndexEntry> findOnPage(const PageRef& page);
+
+    /**
+     * @return The recording and the offset (in ms) the element was written at, if it is linked to a recording
+     */
+    std::optional<std::pair<fs::path, size_t>> find(const Element* e);
+
+    /**
+     * @return The number of indexed elements
+     */
+    size_t size();
+
+private:
+    using Timeline = std::multimap<size_t, AudioIndexEntry>;
+
+    struct PageState {
+        PageRef page;
+        std::vector<std::pair<const Layer*, uint64_t>> layerRevisions;
+        std::vector<const Element*> elements;
+        uint64_t epoch = 0;
+    };
+
+    static std::string keyOf(const fs::path& audioFile);
+
+    bool isUpToDate(PageState& state);
+    void removePage(PageState& state);
+    void scanPage(PageState& state);
+
+private:
+    Document* doc;
+
+    /// One timeline per recording, keyed by file name
+    std::map<std::string, Timeline> timelines;
+    /// Reverse index: element -> its position in the timeline
+    std::unordered_map<const Element*, std::pair<std::string, Timeline::iterator>> byElement;
+
+    std::unordered_map<const XojPage*, PageState> pages;
+    uint64_t epoch = 0;
+};
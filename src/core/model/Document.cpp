@@ -16,11 +16,16 @@
 #include "util/Util.h"                        // for npos
 #include "util/i18n.h"                        // for FS, _F
 
+#include "AudioIndex.h"       // for AudioIndex
 #include "LinkDestination.h"  // for XojLinkDest, DOCUMENT_L...
+#include "SearchIndex.h"      // for SearchIndex
 #include "XojPage.h"          // for XojPage
 #include "filesystem.h"       // for path
 
-Document::Document(DocumentHandler* handler): handler(handler) {}
+Document::Document(DocumentHandler* handler):
+        handler(handler),
+        audioIndex(std::make_unique<AudioIndex>(this)),
+        searchIndex(std::make_unique<SearchIndex>(this)) {}
 
 Document::~Document() {
     clearDocument(true);
@@ -98,6 +103,8 @@ void Document::clearDocument(bool destroy) {
     this->pages.clear();
     this->pageIndex.reset();
     freeTreeContentModel();
+    this->searchIndex->clear();
+    this->audioIndex->clear();
 
     this->filepath = fs::path{};
     this->pdfFilepath = fs::path{};
@@ -170,6 +177,10 @@ void Document::setPreview(cairo_surface_t* preview) {
     }
 }
 
+auto Document::getAudioIndex() -> AudioIndex& { return *this->audioIndex; }
+
+auto Document::getSearchIndex() -> SearchIndex& { return *this->searchIndex; }
+
 auto Document::getEvMetadataFilename() const -> fs::path {
     if (!this->filepath.empty()) {
         return this->filepath;
@@ -317,6 +328,8 @@ auto Document::readPdf(const fs::path& filename, bool initPages, bool attachToDo
     this->pdfFilepath = filename;
     this->attachPdf = attachToDocument;
     lastError = "";
+    this->searchIndex->clear();
+    this->audioIndex->clear();
 
     if (initPages) {
         this->pages.clear();
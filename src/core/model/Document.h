@@ -30,6 +30,8 @@
 #include "PageRef.h"     // for PageRef
 #include "filesystem.h"  // for path
 
+class AudioIndex;
+class SearchIndex;
 class DocumentHandler;
 class XojPdfBookmarkIterator;
 
@@ -91,6 +93,16 @@ public:
     cairo_surface_t* getPreview() const;
     void setPreview(cairo_surface_t* preview);
 
+    /**
+     * @return The index of the elements linked to audio recordings. It is updated lazily on every query.
+     */
+    AudioIndex& getAudioIndex();
+
+    /**
+     * @return The full-text index of the PDF background and of the text elements
+     */
+    SearchIndex& getSearchIndex();
+
     void lock();
     void unlock();
     bool tryLock();
@@ -157,6 +169,16 @@ private:
      */
     cairo_surface_t* preview = nullptr;
 
+    /**
+     * Index of the audio-linked elements, see getAudioIndex()
+     */
+    std::unique_ptr<AudioIndex> audioIndex;
+
+    /**
+     * Full-text index, see getSearchIndex()
+     */
+    std::unique_ptr<SearchIndex> searchIndex;
+
     /**
      * The lock of the document
      */
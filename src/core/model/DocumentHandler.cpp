@@ -1,6 +1,9 @@
 #include "DocumentHandler.h"
 
+#include <algorithm>  // for min
+
 #include "model/DocumentChangeType.h"  // for DocumentChangeType
+#include "util/Util.h"                 // for npos
 
 #include "DocumentListener.h"  // for DocumentListener
 
@@ -21,13 +24,38 @@ void DocumentHandler::firePageChanged(size_t page) {
 }
 
 void DocumentHandler::firePageInserted(size_t page) {
+    if (this->batchDepth > 0) {
+        this->batchFirstPage = std::min(this->batchFirstPage, page);
+        return;
+    }
     for (DocumentListener* dl: this->listener) { dl->pageInserted(page); }
 }
 
 void DocumentHandler::firePageDeleted(size_t page) {
+    if (this->batchDepth > 0) {
+        this->batchFirstPage = std::min(this->batchFirstPage, page);
+        return;
+    }
     for (DocumentListener* dl: this->listener) { dl->pageDeleted(page); }
 }
 
 void DocumentHandler::firePageSelected(size_t page) {
     for (DocumentListener* dl: this->listener) { dl->pageSelected(page); }
 }
+
+void DocumentHandler::beginPageBatch() {
+    if (this->batchDepth++ == 0) {
+        this->batchFirstPage = npos;
+    }
+}
+
+void DocumentHandler::endPageBatch() {
+    if (--this->batchDepth > 0 || this->batchFirstPage == npos) {
+        return;
+    }
+    for (DocumentListener* dl: this->listener) { dl->pagesChanged(this->batchFirstPage); }
+}
+
+DocumentHandler::PageBatch::PageBatch(DocumentHandler* handler): handler(handler) { handler->beginPageBatch(); }
+
+DocumentHandler::PageBatch::~PageBatch() { this->handler->endPageBatch(); }
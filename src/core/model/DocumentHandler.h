@@ -33,6 +33,28 @@ public:
     // void firePageLoaded(PageRef page);
     void firePageSelected(size_t page);
 
+    /**
+     * Starts a batch of page insertions, deletions and moves. Until the matching endPageBatch(), firePageInserted() and
+     * firePageDeleted() only record which pages changed; endPageBatch() then notifies the listeners once, with
+     * DocumentListener::pagesChanged(). The batches can be nested: only the outermost one notifies the listeners.
+     */
+    void beginPageBatch();
+    void endPageBatch();
+
+    /**
+     * A page batch (see beginPageBatch()) lasting as long as this object
+     */
+    class PageBatch {
+    public:
+        explicit PageBatch(DocumentHandler* handler);
+        PageBatch(const PageBatch&) = delete;
+        PageBatch& operator=(const PageBatch&) = delete;
+        ~PageBatch();
+
+    private:
+        DocumentHandler* handler;
+    };
+
 private:
     void addListener(DocumentListener* l);
     void removeListener(DocumentListener* l);
@@ -40,5 +62,15 @@ private:
 private:
     std::list<DocumentListener*> listener;
 
+    /**
+     * Number of nested page batches currently open
+     */
+    int batchDepth = 0;
+
+    /**
+     * Smallest index of a page inserted or deleted in the current batch, or npos
+     */
+    size_t batchFirstPage = 0;
+
     friend class DocumentListener;
 };
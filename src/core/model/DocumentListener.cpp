@@ -29,4 +29,6 @@ void DocumentListener::pageInserted(size_t page) {}
 
 void DocumentListener::pageDeleted(size_t page) {}
 
+void DocumentListener::pagesChanged(size_t firstPage) {}
+
 void DocumentListener::pageSelected(size_t page) {}
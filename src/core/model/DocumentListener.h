@@ -31,6 +31,12 @@ public:
     virtual void pageChanged(size_t page);
     virtual void pageInserted(size_t page);
     virtual void pageDeleted(size_t page);
+
+    /**
+     * Pages were inserted, deleted or moved within a page batch (see DocumentHandler::beginPageBatch()). The pages
+     * before firstPage are unchanged; the pages from firstPage on have to be matched again against the document.
+     */
+    virtual void pagesChanged(size_t firstPage);
     virtual void pageSelected(size_t page);
 
 private:
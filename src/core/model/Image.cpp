@@ -1,13 +1,17 @@
 #include "Image.h"
 
-#include <algorithm>  // for min
-#include <array>      // for array
-#include <utility>    // for move, pair
+#include <algorithm>    // for min
+#include <array>        // for array
+#include <memory>       // for shared_ptr, make_shared
+#include <mutex>        // for lock_guard
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <utility>      // for move, pair
 
 #include <cairo.h>        // for cairo_surface_destroy
 #include <gdk/gdk.h>      // for gdk_cairo_set_sourc...
 #include <glib-object.h>  // for g_object_unref
-#include <glib.h>         // for g_assert, guchar
+#include <glib.h>         // for g_assert, guchar, GChecksum
 
 #include "model/Element.h"                        // for Element, ELEMENT_IMAGE
 #include "util/Rectangle.h"                       // for Rectangle
@@ -40,7 +44,10 @@ auto Image::clone() const -> Element* {
     img->height = this->height;
     img->data = this->data;
 
-    img->image = cairo_surface_reference(this->image);
+    {
+        std::lock_guard lock(this->imageMutex);
+        img->image = cairo_surface_reference(this->image);
+    }
     img->snappedBounds = this->snappedBounds;
     img->sizeCalculated = this->sizeCalculated;
 
@@ -64,7 +71,7 @@ void Image::setImage(std::string&& data) {
         cairo_surface_destroy(this->image);
         this->image = nullptr;
     }
-    this->data = std::move(data);
+    this->data = std::make_shared<const std::string>(std::move(data));
 
     if (this->format) {
         gdk_pixbuf_format_free(this->format);
@@ -74,10 +81,10 @@ void Image::setImage(std::string&& data) {
     // FIXME: awful hack to try to parse the format
     std::array<char*, 4096> buffer{};
     GdkPixbufLoader* loader = gdk_pixbuf_loader_new();
-    size_t remaining = this->data.size();
+    size_t remaining = this->data->size();
     while (remaining > 0) {
         size_t readLen = std::min(remaining, buffer.size());
-        if (!gdk_pixbuf_loader_write(loader, reinterpret_cast<const guchar*>(this->data.c_str()), readLen, nullptr))
+        if (!gdk_pixbuf_loader_write(loader, reinterpret_cast<const guchar*>(this->data->c_str()), readLen, nullptr))
             break;
         remaining -= readLen;
 
@@ -125,14 +132,45 @@ void Image::setImage(cairo_surface_t* image) {
     };
     cairo_surface_write_to_png_stream(image, writeFunc, &closure_);
 
-    data = std::move(closure_.buffer);
+    data = std::make_shared<const std::string>(std::move(closure_.buffer));
+}
+
+/**
+ * Attaches the original encoded bytes to the surface, so that the PDF and SVG exports embed them unchanged instead of
+ * re-encoding the decoded pixels (cairo's PDF backend only uses the JPEG data, the SVG backend also uses PNG data).
+ * The bytes are not copied: the surface keeps a reference on the data of the Image, as it may outlive the element.
+ * The unique ID, the SHA-256 of the content, lets cairo store identical images only once per exported document.
+ */
+static void attachMimeData(cairo_surface_t* surface, const std::shared_ptr<const std::string>& data) {
+    auto attach = [surface](const char* mimeType, std::shared_ptr<const std::string> bytes) {
+        auto* ref = new std::shared_ptr<const std::string>(std::move(bytes));
+        cairo_surface_set_mime_data(
+                surface, mimeType, reinterpret_cast<const unsigned char*>((*ref)->data()), (*ref)->size(),
+                [](void* p) { delete static_cast<std::shared_ptr<const std::string>*>(p); }, ref);
+    };
+
+    constexpr std::string_view JPEG_MAGIC("\xFF\xD8\xFF", 3);
+    constexpr std::string_view PNG_MAGIC("\x89PNG\r\n\x1A\n", 8);
+    std::string_view view(*data);
+    if (view.substr(0, JPEG_MAGIC.size()) == JPEG_MAGIC) {
+        attach(CAIRO_MIME_TYPE_JPEG, data);
+    } else if (view.substr(0, PNG_MAGIC.size()) == PNG_MAGIC) {
+        attach(CAIRO_MIME_TYPE_PNG, data);
+    }
+
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(data->data()), static_cast<gssize>(data->size()));
+    attach(CAIRO_MIME_TYPE_UNIQUE_ID, std::make_shared<const std::string>(std::string("xournalpp-image-") +
+                                                                          g_checksum_get_string(checksum)));
+    g_checksum_free(checksum);
 }
 
 auto Image::getImage() const -> cairo_surface_t* {
-    g_assert(data.length() > 0 && "image has no data, cannot render it!");
+    g_assert(hasData() && "image has no data, cannot render it!");
+    std::lock_guard lock(this->imageMutex);
     if (this->image == nullptr) {
         GdkPixbufLoader* loader = gdk_pixbuf_loader_new();
-        gdk_pixbuf_loader_write(loader, reinterpret_cast<const guchar*>(this->data.c_str()), this->data.length(),
+        gdk_pixbuf_loader_write(loader, reinterpret_cast<const guchar*>(this->data->c_str()), this->data->length(),
                                 nullptr);
         bool success = gdk_pixbuf_loader_close(loader, nullptr);
         g_assert(success && "errors in loading image data!");
@@ -154,6 +192,8 @@ auto Image::getImage() const -> cairo_surface_t* {
         cairo_paint(cr);
         cairo_destroy(cr);
 
+        attachMimeData(this->image, this->data);
+
         g_object_unref(loader);
     }
 
@@ -184,7 +224,7 @@ void Image::serialize(ObjectOutputStream& out) const {
     out.writeDouble(this->width);
     out.writeDouble(this->height);
 
-    out.writeImage(this->data);
+    out.writeImage(this->data ? std::string_view(*this->data) : std::string_view());
 
     out.endObject();
 }
@@ -202,7 +242,7 @@ void Image::readSerialized(ObjectInputStream& in) {
         this->image = nullptr;
     }
 
-    this->data = in.readImage();
+    this->data = std::make_shared<const std::string>(in.readImage());
 
     in.endObject();
     this->calcSize();
@@ -213,11 +253,13 @@ void Image::calcSize() const {
     this->sizeCalculated = true;
 }
 
-bool Image::hasData() const { return !this->data.empty(); }
+bool Image::hasData() const { return this->data && !this->data->empty(); }
 
-const unsigned char* Image::getRawData() const { return reinterpret_cast<const unsigned char*>(this->data.data()); }
+const unsigned char* Image::getRawData() const {
+    return this->data ? reinterpret_cast<const unsigned char*>(this->data->data()) : nullptr;
+}
 
-size_t Image::getRawDataLength() const { return this->data.size(); }
+size_t Image::getRawDataLength() const { return this->data ? this->data->size() : 0; }
 
 std::pair<int, int> Image::getImageSize() const { return this->imageSize; }
 
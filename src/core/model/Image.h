@@ -12,6 +12,8 @@
 #pragma once
 
 #include <cstddef>      // for size_t
+#include <memory>       // for shared_ptr
+#include <mutex>        // for mutex
 #include <string>       // for string
 #include <string_view>  // for string_view
 #include <utility>      // for pair, make_pair
@@ -54,6 +56,7 @@ public:
     /// Returns the internal surface that contains the rendered image data.
     ///
     /// Note that the image is rendered lazily by default; call this method to render it.
+    /// Can be called from any thread (e.g. by the workers of the parallel exports).
     cairo_surface_t* getImage() const;
 
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
@@ -97,9 +100,13 @@ private:
     /// Temporary surface used as a render buffer.
     mutable cairo_surface_t* image = nullptr;
 
+    /// Guards the lazy rendering of image in getImage()
+    mutable std::mutex imageMutex;
+
     /// Image format information.
     mutable GdkPixbufFormat* format = nullptr;
     mutable std::pair<int, int> imageSize = {-1, -1};
 
-    std::string data;
+    /// Encoded image data, shared with the clones and with the mime data of the rendered surface
+    std::shared_ptr<const std::string> data;
 };
@@ -1,11 +1,17 @@
 #include "Layer.h"
 
+#include <atomic>  // for atomic
+
 #include <glib.h>  // for g_warning
 
 #include "model/Element.h"    // for Element, Element::Index, Element::Inval...
 #include "util/Stacktrace.h"  // for Stacktrace
 
-Layer::Layer() = default;
+namespace {
+std::atomic<uint64_t> lastRevision{0};
+}
+
+Layer::Layer() { bumpRevision(); }
 
 Layer::~Layer() {
     for (Element* e: this->elements) { delete e; }
@@ -39,6 +45,7 @@ void Layer::addElement(Element* e) {
     }
 
     this->elements.push_back(e);
+    bumpRevision();
 }
 
 void Layer::insertElement(Element* e, Element::Index pos) {
@@ -68,6 +75,7 @@ void Layer::insertElement(Element* e, Element::Index pos) {
     } else {
         this->elements.insert(this->elements.begin() + pos, e);
     }
+    bumpRevision();
 }
 
 auto Layer::indexOf(Element* e) const -> Element::Index {
@@ -84,6 +92,7 @@ auto Layer::removeElement(Element* e, bool free) -> Element::Index {
     for (unsigned int i = 0; i < this->elements.size(); i++) {
         if (e == this->elements[i]) {
             this->elements.erase(this->elements.begin() + i);
+            bumpRevision();
 
             if (free) {
                 delete e;
@@ -97,7 +106,10 @@ auto Layer::removeElement(Element* e, bool free) -> Element::Index {
     return Element::InvalidIndex;
 }
 
-void Layer::clearNoFree() { this->elements.clear(); }
+void Layer::clearNoFree() {
+    this->elements.clear();
+    bumpRevision();
+}
 
 auto Layer::isAnnotated() const -> bool { return !this->elements.empty(); }
 
@@ -118,3 +130,7 @@ auto Layer::hasName() const -> bool { return name.has_value(); }
 auto Layer::getName() const -> std::string { return name.value_or(""); }
 
 void Layer::setName(const std::string& newName) { this->name = newName; }
+
+auto Layer::getRevision() const -> uint64_t { return this->revision; }
+
+void Layer::bumpRevision() { this->revision = ++lastRevision; }
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <cstddef>   // for size_t
+#include <cstdint>   // for uint64_t
 #include <optional>  // for optional
 #include <string>    // for string
 #include <vector>    // for vector
@@ -98,9 +99,20 @@ public:
      */
     void setName(const std::string& newName);
 
+    /**
+     * Returns a number that changes whenever an Element is added to or removed from this Layer.
+     * Revisions are unique across all layers, so (layer, revision) pairs never collide even if a Layer is reallocated.
+     */
+    uint64_t getRevision() const;
+
+private:
+    void bumpRevision();
+
 private:
     std::vector<Element*> elements;
 
+    uint64_t revision = 0;
+
     bool visible = true;
 
     optional<std::string> name;
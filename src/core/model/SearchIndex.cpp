@@ -0,0 +1,159 @@
+#include "SearchIndex.h"
+
+#include <algorithm>  // for replace
+#include <utility>    // for move
+
+#include "model/Document.h"       // for Document
+#include "model/Element.h"        // for Element, ELEMENT_TEXT
+#include "model/Layer.h"          // for Layer
+#include "model/Text.h"           // for Text
+#include "model/XojPage.h"        // for XojPage
+#include "pdf/base/XojPdfPage.h"  // for XojPdfPage
+#include "util/StringUtils.h"     // for StringUtils
+#include "util/Util.h"            // for npos
+
+SearchIndex::SearchIndex(Document* doc): doc(doc) {}
+
+SearchIndex::~SearchIndex() = default;
+
+void SearchIndex::clear() {
+    {
+        std::lock_guard lock(this->pdfTextMutex);
+        this->pdfText.clear();
+        this->nextPdfPage = 0;
+        this->generation++;
+    }
+    this->pages.clear();
+}
+
+auto SearchIndex::startIndexing() -> bool {
+    if (this->indexing) {
+        return false;
+    }
+    this->indexing = true;
+    return true;
+}
+
+void SearchIndex::indexingFinished() { this->indexing = false; }
+
+auto SearchIndex::countOccurrences(const std::string& text, const std::string& pattern) -> size_t {
+    // Same semantics as TextView::findText: overlapping matches are counted
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) { count++; }
+    return count;
+}
+
+auto SearchIndex::nextPdfPageToIndex() -> std::optional<PdfPageTask> {
+    std::lock_guard lock(this->pdfTextMutex);
+    size_t count = this->doc->getPdfPageCount();
+    this->pdfText.resize(count);
+    while (this->nextPdfPage < count && this->pdfText[this->nextPdfPage]) { this->nextPdfPage++; }
+    if (this->nextPdfPage >= count) {
+        return std::nullopt;
+    }
+
+    size_t pdfPage = this->nextPdfPage++;
+    return PdfPageTask{pdfPage, this->doc->getPdfPage(pdfPage), this->generation};
+}
+
+void SearchIndex::indexPdfPage(const PdfPageTask& task) {
+    // In lower case and with line breaks replaced by spaces
+    std::string text;
+    if (task.page) {
+        text = StringUtils::toLowerCase(task.page->getText());
+        std::replace(text.begin(), text.end(), '\n', ' ');
+    }
+
+    std::lock_guard lock(this->pdfTextMutex);
+    if (task.generation != this->generation || task.pdfPage >= this->pdfText.size()) {
+        // Another PDF background was loaded in the meantime
+        return;
+    }
+    this->pdfText[task.pdfPage] = std::move(text);
+}
+
+auto SearchIndex::countPdfMatches(size_t pdfPage, const std::string& pattern) -> size_t {
+    std::lock_guard lock(this->pdfTextMutex);
+    if (pdfPage >= this->doc->getPdfPageCount()) {
+        return 0;
+    }
+    if (pdfPage >= this->pdfText.size() || !this->pdfText[pdfPage]) {
+        return UNKNOWN;
+    }
+    return countOccurrences(*this->pdfText[pdfPage], pattern);
+}
+
+void SearchIndex::updatePage(XojPage* page, PageState& state) {
+    auto* layers = page->getLayers();
+    bool upToDate = layers->size() == state.layers.size();
+    for (size_t i = 0; upToDate && i < layers->size(); i++) {
+        Layer* l = (*layers)[i];
+        upToDate = state.layers[i].layer == l && state.layers[i].revision == l->getRevision() &&
+                   state.layers[i].visible == l->isVisible();
+    }
+
+    if (!upToDate) {
+        // Elements were inserted or removed: re-read the whole page
+        state.layers.clear();
+        state.texts.clear();
+        for (Layer* l: *layers) {
+            state.layers.push_back({l, l->getRevision(), l->isVisible()});
+            if (!l->isVisible()) {
+                continue;
+            }
+            for (Element* e: l->getElements()) {
+                if (e->getType() == ELEMENT_TEXT) {
+                    auto* t = static_cast<Text*>(e);
+                    state.texts.push_back({t, t->getTextRevision(), StringUtils::toLowerCase(t->getText())});
+                }
+            }
+        }
+        return;
+    }
+
+    // Same elements: only re-read the edited texts
+    for (TextState& t: state.texts) {
+        if (t.revision != t.text->getTextRevision()) {
+            t.revision = t.text->getTextRevision();
+            t.lowerCaseText = StringUtils::toLowerCase(t.text->getText());
+        }
+    }
+}
+
+auto SearchIndex::countMatches(const std::string& pattern) -> std::vector<size_t> {
+    std::string lowerCasePattern = StringUtils::toLowerCase(pattern);
+    size_t pageCount = this->doc->getPageCount();
+    std::vector<size_t> counts(pageCount, 0);
+    if (lowerCasePattern.empty()) {
+        return counts;
+    }
+
+    this->epoch++;
+    for (size_t i = 0; i < pageCount; i++) {
+        PageRef page = this->doc->getPage(i);
+        PageState& state = this->pages[page.get()];
+        state.epoch = this->epoch;
+        updatePage(page.get(), state);
+
+        if (auto pdfPage = page->getPdfPageNr(); pdfPage != npos) {
+            counts[i] = countPdfMatches(pdfPage, lowerCasePattern);
+            if (counts[i] == UNKNOWN) {
+                continue;
+            }
+        }
+        for (const TextState& t: state.texts) { counts[i] += countOccurrences(t.lowerCaseText, lowerCasePattern); }
+    }
+
+    // Forget the pages which were removed from the document
+    if (this->pages.size() != pageCount) {
+        for (auto it = this->pages.begin(); it != this->pages.end();) {
+            if (it->second.epoch != this->epoch) {
+                it = this->pages.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    return counts;
+}
@@ -0,0 +1,132 @@
+/*
+ * Xournal++
+ *
+ * Full-text index of the PDF background and the text elements of a document
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t
+#include <limits>         // for numeric_limits
+#include <mutex>          // for mutex
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include "pdf/base/XojPdfPage.h"  // for XojPdfPageSPtr
+
+class Document;
+class Layer;
+class Text;
+class XojPage;
+
+/**
+ * @brief Per-document full-text index used to find the pages matching a search without rendering or laying out text.
+ *
+ * The text of the PDF pages is extracted once in the background (see SearchIndexJob) and kept in lower case. The text
+ * elements are indexed lazily per page: countMatches() compares the revisions of the layers (elements inserted,
+ * deleted, undone or redone), their visibility and the text revision of every Text element (edits) with the ones seen
+ * during the last query, and only re-reads the pages which changed.
+ *
+ * The counts are computed on the extracted text. They can slightly differ from the highlighted matches (e.g. for
+ * words hyphenated or split over several lines in the PDF).
+ *
+ * The document must not be modified during countMatches() (lock it or stay on the main thread).
+ */
+class SearchIndex {
+public:
+    explicit SearchIndex(Document* doc);
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+    ~SearchIndex();
+
+public:
+    /**
+     * Drops all cached data, e.g. because another PDF background has been loaded
+     */
+    void clear();
+
+    /// A PDF page whose text is to be extracted by indexPdfPage()
+    struct PdfPageTask {
+        size_t pdfPage;
+        XojPdfPageSPtr page;
+        /// Value of SearchIndex::generation when the task was created, to drop the text if clear() is called meanwhile
+        uint64_t generation;
+    };
+
+    /**
+     * Picks the next PDF page which is not indexed yet. The document must be locked.
+     * Can be called from any thread.
+     * @return std::nullopt if all PDF pages are indexed
+     */
+    std::optional<PdfPageTask> nextPdfPageToIndex();
+
+    /**
+     * Extracts the text of the page and stores it in the index. Does not need the document lock: the extraction can
+     * take long on large pages and would block the main thread otherwise.
+     * Can be called from any thread.
+     */
+    void indexPdfPage(const PdfPageTask& task);
+
+    /// Match count of the pages whose PDF background is not indexed yet
+    static constexpr size_t UNKNOWN = std::numeric_limits<size_t>::max();
+
+    /**
+     * @return The number of case-insensitive matches of pattern on every page of the document (PDF background and
+     * text elements on visible layers), or UNKNOWN for the pages whose PDF background is not indexed yet.
+     */
+    std::vector<size_t> countMatches(const std::string& pattern);
+
+    /**
+     * Marks the background indexing as started
+     * @return false if it is already running
+     */
+    bool startIndexing();
+    void indexingFinished();
+
+private:
+    struct LayerState {
+        const Layer* layer;
+        uint64_t revision;
+        bool visible;
+    };
+
+    struct TextState {
+        const Text* text;
+        uint64_t revision;
+        std::string lowerCaseText;
+    };
+
+    struct PageState {
+        std::vector<LayerState> layers;
+        std::vector<TextState> texts;
+        uint64_t epoch = 0;
+    };
+
+    /// @return The number of matches of the lower case pattern in the PDF page, or UNKNOWN if it is not indexed yet
+    size_t countPdfMatches(size_t pdfPage, const std::string& pattern);
+    void updatePage(XojPage* page, PageState& state);
+
+    static size_t countOccurrences(const std::string& text, const std::string& pattern);
+
+private:
+    Document* doc;
+
+    /// Guards pdfText, nextPdfPage and generation, which are also accessed by the background indexing
+    std::mutex pdfTextMutex;
+    std::vector<std::optional<std::string>> pdfText;
+    size_t nextPdfPage = 0;
+    uint64_t generation = 0;
+
+    std::unordered_map<const XojPage*, PageState> pages;
+    uint64_t epoch = 0;
+
+    bool indexing = false;
+};
@@ -154,11 +154,7 @@ void TexImage::readSerialized(ObjectInputStream& in) {
 
     freeImageAndPdf();
 
-    char* data = nullptr;
-    int len = 0;
-    in.readData(reinterpret_cast<void**>(&data), &len);
-
-    this->loadData(std::string(data, len), nullptr);
+    this->loadData(std::string(in.readDataView(1)), nullptr);
 
     in.endObject();
     this->calcSize();
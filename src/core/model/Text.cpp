@@ -1,5 +1,6 @@
 #include "Text.h"
 
+#include <memory>   // for make_unique
 #include <utility>  // for move
 
 #include <glib.h>  // for g_warning
@@ -11,11 +12,12 @@
 #include "util/Stacktrace.h"                      // for Stacktrace
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
 #include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
+#include "view/TextLayoutCache.h"                 // for TextLayoutCache
 #include "view/TextView.h"                        // for TextView
 
 using xoj::util::Rectangle;
 
-Text::Text(): AudioElement(ELEMENT_TEXT) {
+Text::Text(): AudioElement(ELEMENT_TEXT), layoutCache(std::make_unique<xoj::view::TextLayoutCache>()) {
     this->font.setName("Sans");
     this->font.setSize(12);
 }
@@ -49,8 +51,13 @@ auto Text::getFontName() const -> std::string { return font.getName(); }
 
 auto Text::getText() const -> std::string { return this->text; }
 
+auto Text::getTextRevision() const -> uint64_t { return this->textRevision; }
+
+auto Text::getLayoutCache() const -> xoj::view::TextLayoutCache& { return *this->layoutCache; }
+
 void Text::setText(std::string text) {
     this->text = std::move(text);
+    this->textRevision++;
 
     calcSize();
 }
@@ -130,6 +137,7 @@ void Text::readSerialized(ObjectInputStream& in) {
     this->AudioElement::readSerialized(in);
 
     this->text = in.readString();
+    this->textRevision++;
 
     font.readSerialized(in);
 
@@ -11,7 +11,9 @@
 
 #pragma once
 
-#include <string>  // for string
+#include <cstdint>  // for uint64_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
 
 #include "AudioElement.h"  // for AudioElement
 #include "Font.h"          // for XojFont
@@ -19,6 +21,9 @@
 class Element;
 class ObjectInputStream;
 class ObjectOutputStream;
+namespace xoj::view {
+class TextLayoutCache;
+};
 
 class Text: public AudioElement {
 public:
@@ -34,6 +39,16 @@ public:
     std::string getText() const;
     void setText(std::string text);
 
+    /**
+     * @return A counter incremented on every change of the content (see setText), e.g. to invalidate caches
+     */
+    uint64_t getTextRevision() const;
+
+    /**
+     * @return The shaped layouts of the text, see TextView
+     */
+    xoj::view::TextLayoutCache& getLayoutCache() const;
+
     void setWidth(double width);
     void setHeight(double height);
 
@@ -66,6 +81,9 @@ private:
     XojFont font;
 
     std::string text;
+    uint64_t textRevision = 0;
+
+    std::unique_ptr<xoj::view::TextLayoutCache> layoutCache;
 
     bool inEditing = false;
 };
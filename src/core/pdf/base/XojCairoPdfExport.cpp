@@ -3,6 +3,8 @@
 #include <algorithm>  // for copy, min
 #include <map>        // for map
 #include <memory>     // for __shared_ptr_access
+#include <mutex>      // for lock_guard
+#include <numeric>    // for iota
 #include <sstream>    // for ostringstream, operator<<
 #include <stack>      // for stack
 #include <utility>    // for pair, make_pair
@@ -11,6 +13,7 @@
 #include <cairo-pdf.h>    // for cairo_pdf_surface_set_met...
 #include <glib-object.h>  // for g_object_unref
 
+#include "control/jobs/ParallelExport.h"    // for orderedFor, getThreadCount
 #include "control/jobs/ProgressListener.h"  // for ProgressListener
 #include "model/Document.h"                 // for Document
 #include "model/Layer.h"                    // for Layer
@@ -114,37 +117,111 @@ void XojCairoPdfExport::endPdf() {
     this->surface = nullptr;
 }
 
-void XojCairoPdfExport::exportPage(size_t page) {
-    PageRef p = doc->getPage(page);
-
-    cairo_pdf_surface_set_size(this->surface, p->getWidth(), p->getHeight());
-
+void XojCairoPdfExport::drawPage(const PageRef& p, cairo_t* cr) {
     DocumentView view;
 
-    cairo_save(this->cr);
-
     // For a better pdf quality, we use a dedicated pdf rendering
     if (p->getBackgroundType().isPdfPage() && (exportBackground != EXPORT_BACKGROUND_NONE)) {
         auto pgNo = p->getPdfPageNr();
-        XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
 
+        // The page is also fetched and released under the lock: both access the shared Poppler document
+        std::lock_guard lock(pdfRenderMutex);
+        XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
         popplerPage->renderForPrinting(cr);
     }
 
     if (layerRange) {
-        view.drawLayersOfPage(*layerRange, p, this->cr, true /* dont render eraseable */,
+        view.drawLayersOfPage(*layerRange, p, cr, true /* dont render eraseable */,
                               true /* don't rerender the pdf background */, exportBackground == EXPORT_BACKGROUND_NONE,
                               exportBackground <= EXPORT_BACKGROUND_UNRULED);
     } else {
-        view.drawPage(p, this->cr, true /* dont render eraseable */, true /* don't rerender the pdf background */,
+        view.drawPage(p, cr, true /* dont render eraseable */, true /* don't rerender the pdf background */,
                       exportBackground == EXPORT_BACKGROUND_NONE, exportBackground <= EXPORT_BACKGROUND_UNRULED);
     }
+}
+
+void XojCairoPdfExport::exportPage(size_t page) {
+    PageRef p = doc->getPage(page);
+
+    cairo_pdf_surface_set_size(this->surface, p->getWidth(), p->getHeight());
+
+    cairo_save(this->cr);
+
+    drawPage(p, this->cr);
 
     // next page
     cairo_show_page(this->cr);
     cairo_restore(this->cr);
 }
 
+auto XojCairoPdfExport::recordPage(size_t page) -> cairo_surface_t* {
+    doc->lock();
+    PageRef p = doc->getPage(page);
+    doc->unlock();
+
+    cairo_rectangle_t extents = {0, 0, p->getWidth(), p->getHeight()};
+    cairo_surface_t* recording = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+    cairo_t* recordingCr = cairo_create(recording);
+    drawPage(p, recordingCr);
+    cairo_destroy(recordingCr);
+
+    return recording;
+}
+
+void XojCairoPdfExport::replayPage(size_t page, cairo_surface_t* recording) {
+    PageRef p = doc->getPage(page);
+
+    cairo_pdf_surface_set_size(this->surface, p->getWidth(), p->getHeight());
+
+    // Cairo writes the replayed recording as a form XObject: the page looks the same as with exportPage(), but its
+    // content stream only references the XObject
+    cairo_save(this->cr);
+    cairo_set_source_surface(this->cr, recording, 0, 0);
+    cairo_paint(this->cr);
+
+    // next page
+    cairo_show_page(this->cr);
+    cairo_restore(this->cr);
+}
+
+void XojCairoPdfExport::exportPages(const std::vector<size_t>& pages, bool progressiveMode) {
+    if (this->progressListener) {
+        this->progressListener->setMaximumState(pages.size());
+    }
+
+    if (progressiveMode) {
+        // The layer visibility is changed for every exported PDF page: this cannot run concurrently
+        for (size_t n = 0; n < pages.size(); n++) {
+            exportPageLayers(pages[n]);
+
+            if (this->progressListener) {
+                this->progressListener->setCurrentState(n);
+            }
+        }
+        return;
+    }
+
+    // The pages are recorded concurrently, then replayed in order into the PDF surface on this thread
+    std::vector<cairo_surface_t*> recordings(pages.size(), nullptr);
+    try {
+        ParallelExport::orderedFor(
+                pages.size(), 2 * ParallelExport::getThreadCount(),
+                [&](size_t n) { recordings[n] = recordPage(pages[n]); },
+                [&](size_t n) {
+                    replayPage(pages[n], recordings[n]);
+                    cairo_surface_destroy(recordings[n]);
+                    recordings[n] = nullptr;
+
+                    if (this->progressListener) {
+                        this->progressListener->setCurrentState(n);
+                    }
+                });
+    } catch (...) {
+        for (cairo_surface_t* recording: recordings) { cairo_surface_destroy(recording); }
+        throw;
+    }
+}
+
 // export layers one by one to produce as many PDF pages as there are layers.
 void XojCairoPdfExport::exportPageLayers(size_t page) {
     PageRef p = doc->getPage(page);
@@ -180,29 +257,14 @@ auto XojCairoPdfExport::createPdf(fs::path const& file, const PageRangeVector& r
         return false;
     }
 
-    size_t count = 0;
-    for (const auto& e: range) { count += e.last - e.first + 1; }
-
-    if (this->progressListener) {
-        this->progressListener->setMaximumState(count);
-    }
-
-    size_t c = 0;
+    std::vector<size_t> pages;
     for (const auto& e: range) {
         auto max = std::min(e.last, doc->getPageCount());
-        for (size_t i = e.first; i <= max; i++) {
-            if (progressiveMode) {
-                exportPageLayers(i);
-            } else {
-                exportPage(i);
-            }
-
-            if (this->progressListener) {
-                this->progressListener->setCurrentState(c++);
-            }
-        }
+        for (size_t i = e.first; i <= max; i++) { pages.push_back(i); }
     }
 
+    exportPages(pages, progressiveMode);
+
     endPdf();
     return true;
 }
@@ -220,22 +282,10 @@ auto XojCairoPdfExport::createPdf(fs::path const& file, bool progressiveMode) ->
         return false;
     }
 
-    auto count = doc->getPageCount();
-    if (this->progressListener) {
-        this->progressListener->setMaximumState(count);
-    }
+    std::vector<size_t> pages(doc->getPageCount());
+    std::iota(pages.begin(), pages.end(), 0);
 
-    for (decltype(count) i = 0; i < count; i++) {
-        if (progressiveMode) {
-            exportPageLayers(i);
-        } else {
-            exportPage(i);
-        }
-
-        if (this->progressListener) {
-            this->progressListener->setCurrentState(i);
-        }
-    }
+    exportPages(pages, progressiveMode);
 
     endPdf();
     return true;
@@ -12,12 +12,16 @@
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex
 #include <string>   // for string
+#include <vector>   // for vector
 
 #include <cairo.h>    // for CAIRO_VERSION, CAIRO_VERSION...
 #include <gtk/gtk.h>  // for GtkTreeModel
 
 #include "control/jobs/BaseExportJob.h"  // for ExportBackgroundType, EXPORT...
+#include "model/PageRef.h"               // for PageRef
 #include "util/ElementRange.h"           // for PageRangeVector
 
 #include "XojPdfExport.h"  // for XojPdfExport
@@ -55,7 +59,29 @@ private:
     void populatePdfOutline(GtkTreeModel* tocModel);
 #endif
     void endPdf();
+
+    /**
+     * Exports the given pages in order. Unless progressiveMode is set, the pages are rendered concurrently into
+     * recording surfaces, which are replayed into the PDF surface in order on the calling thread.
+     */
+    void exportPages(const std::vector<size_t>& pages, bool progressiveMode);
+
+    /**
+     * Draws the background and the layers of the page to cr. Thread safe for different pages and contexts.
+     */
+    void drawPage(const PageRef& p, cairo_t* cr);
     void exportPage(size_t page);
+
+    /**
+     * @return A new recording surface with the content of the page. Thread safe.
+     */
+    cairo_surface_t* recordPage(size_t page);
+
+    /**
+     * Adds a PDF page with the content of the recording surface
+     */
+    void replayPage(size_t page, cairo_surface_t* recording);
+
     /**
      * Export as a PDF document where each additional layer creates a
      * new page */
@@ -79,4 +105,10 @@ private:
     std::string lastError;
 
     std::unique_ptr<LayerRangeVector> layerRange;
+
+    /**
+     * Poppler does not support accessing the same document concurrently: guards the lookup, rendering and release
+     * of the background pages
+     */
+    std::mutex pdfRenderMutex;
 };
@@ -76,6 +76,9 @@ public:
 
     virtual std::vector<XojPdfRectangle> findText(const std::string& text) = 0;
 
+    /// @return The whole text of the page
+    virtual std::string getText() = 0;
+
     /// Retrieve the text contained in the provided rectangle using the given
     /// selection style.
     /// @param rect start and end points
@@ -98,6 +98,13 @@ auto PopplerGlibPage::findText(const std::string& text) -> std::vector<XojPdfRec
     return findings;
 }
 
+auto PopplerGlibPage::getText() -> std::string {
+    char* text = poppler_page_get_text(page);
+    std::string result = text ? text : "";
+    g_free(text);
+    return result;
+}
+
 auto getPopplerSelectionStyle(XojPdfPageSelectionStyle style) -> PopplerSelectionStyle {
     switch (style) {
         case XojPdfPageSelectionStyle::Word:
@@ -35,6 +35,7 @@ public:
     void renderForPrinting(cairo_t* cr) const override;
 
     std::vector<XojPdfRectangle> findText(const std::string& text) override;
+    std::string getText() override;
 
     std::string selectText(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override;
 
@@ -1,6 +1,6 @@
 #include "Plugin.h"
 
-#include <algorithm>  // for max
+#include <algorithm>  // for max, find_if
 #include <array>      // for array
 #include <map>        // for map
 
@@ -109,6 +109,36 @@ auto Plugin::registerMenu(std::string menu, std::string callback, long mode, std
 
 auto Plugin::getControl() const -> Control* { return control; }
 
+auto Plugin::startWorker(lua_State* L, int optionsIdx, std::string& error) -> size_t {
+    PluginWorker::Options options;
+    error = PluginWorker::readOptions(L, optionsIdx, options);
+    if (!error.empty()) {
+        return 0;
+    }
+    auto& worker = workers.emplace_back(
+            std::make_unique<PluginWorker>(this, std::move(options), ++lastWorkerId, control));
+    control->showBackgroundProgress(name);
+    worker->start();
+    return worker->getId();
+}
+
+auto Plugin::cancelWorker(size_t id) -> bool {
+    auto it = std::find_if(workers.begin(), workers.end(), [id](auto const& w) { return w->getId() == id; });
+    if (it == workers.end()) {
+        return false;
+    }
+    (*it)->cancel();
+    return true;
+}
+
+void Plugin::removeWorker(PluginWorker* worker) {
+    auto it = std::find_if(workers.begin(), workers.end(), [worker](auto const& w) { return w.get() == worker; });
+    if (it != workers.end()) {
+        workers.erase(it);
+        control->hideBackgroundProgress();
+    }
+}
+
 void Plugin::loadIni() {
     GKeyFile* config = g_key_file_new();
     g_key_file_set_list_separator(config, ',');
@@ -236,14 +266,19 @@ void Plugin::loadScript() {
 }
 
 auto Plugin::callFunction(const std::string& fnc, long mode) -> bool {
-    lua_getglobal(lua.get(), fnc.c_str());
+    return callFunction(fnc, [mode](lua_State* L) {
+        if (mode == std::numeric_limits<long>::max()) {
+            return 0;
+        }
+        lua_pushinteger(L, mode);
+        return 1;
+    });
+}
 
-    int numArgs = 0;
+auto Plugin::callFunction(const std::string& fnc, const std::function<int(lua_State*)>& pushArgs) -> bool {
+    lua_getglobal(lua.get(), fnc.c_str());
 
-    if (mode != std::numeric_limits<long>::max()) {
-        lua_pushinteger(lua.get(), mode);
-        numArgs = 1;
-    }
+    int numArgs = pushArgs(lua.get());
 
     // Run the function
     if (lua_pcall(lua.get(), numArgs, 0, 0)) {
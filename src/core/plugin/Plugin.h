@@ -19,13 +19,15 @@
 
 #ifdef ENABLE_PLUGINS
 
-#include <string>   // for string
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <functional>  // for function
+#include <string>      // for string
+#include <utility>     // for move
+#include <vector>      // for vector
 
 #include <gtk/gtk.h>  // for GtkWidget, GtkWindow
 
-#include "filesystem.h"  // for path
+#include "PluginWorker.h"  // for PluginWorker
+#include "filesystem.h"    // for path
 
 extern "C" {
 #include <lua.h>  // for lua_State, lua_close
@@ -111,6 +113,20 @@ public:
     ///@return The main controller
     auto getControl() const -> Control*;
 
+    /// Start a background worker with the options at index optionsIdx of the plugin's Lua state (see PluginWorker)
+    /// @return ID of the worker, can be used to cancel it, or 0 if the options are invalid (error is then set)
+    auto startWorker(lua_State* L, int optionsIdx, std::string& error) -> size_t;
+
+    /// Request the cancellation of a running worker
+    /// @return false if there is no running worker with this ID
+    auto cancelWorker(size_t id) -> bool;
+
+    /// Delete a worker which has finished and delivered its result
+    void removeWorker(PluginWorker* worker);
+
+    /// Execute lua function with the arguments pushed by pushArgs (which returns their number)
+    auto callFunction(const std::string& fnc, const std::function<int(lua_State*)>& pushArgs) -> bool;
+
 private:
     /// Load ini file
     void loadIni();
@@ -133,6 +149,10 @@ private:
     std::unique_ptr<lua_State, LuaDeleter> lua{};  ///< Lua engine
     std::vector<MenuEntry> menuEntries;            ///< All registered menu entries
 
+    /// Running background workers, destroyed (i.e. cancelled and joined) before the Lua engine
+    std::vector<std::unique_ptr<PluginWorker>> workers;
+    size_t lastWorkerId = 0;
+
     std::string name;             ///< Plugin name
     std::string description;      ///< Description of the plugin
     std::string author;           ///< Author of the plugin
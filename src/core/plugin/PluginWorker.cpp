@@ -0,0 +1,572 @@
+#include "PluginWorker.h"
+
+#ifdef ENABLE_PLUGINS
+
+#include <algorithm>  // for min, any_of
+#include <map>        // for map
+#include <utility>    // for move, pair, swap
+#include <vector>     // for vector
+
+#include <gdk/gdk.h>  // for gdk_threads_add_idle
+
+#include "control/Control.h"                // for Control
+#include "control/jobs/ProgressListener.h"  // for ProgressListener
+#include "model/Document.h"                 // for Document
+#include "model/Element.h"                  // for ELEMENT_STROKE
+#include "model/Layer.h"                    // for Layer
+#include "model/Stroke.h"                   // for Stroke
+#include "model/XojPage.h"                  // for XojPage
+#include "plugin/Plugin.h"                  // for Plugin, LuaDeleter
+#include "util/XojMsgBox.h"                 // for XojMsgBox
+#include "util/i18n.h"                      // for _
+
+extern "C" {
+#include <lauxlib.h>  // for luaL_error, luaL_checkinteger, luaL_Reg
+#include <lua.h>      // for lua_State, lua_pcall, lua_sethook
+#include <lualib.h>   // for luaL_openlibs
+}
+
+#include "luapi_pointbuffer.h"  // for PointBuffer, pushPointBuffer, registerPointBufferMetatable
+
+namespace xoj::plugin {
+
+/**
+ * Copy of plain Lua data (nil, booleans, numbers, strings, point buffers and tables of those), used to pass values
+ * between the Lua states of a plugin and of its workers.
+ */
+struct LuaValue {
+    enum Type { NIL, BOOLEAN, INTEGER, NUMBER, STRING, POINTS, TABLE };
+
+    /// Deepest table nesting that can be copied. Also catches cyclic tables.
+    static constexpr int MAX_DEPTH = 32;
+
+    /**
+     * Copies the value at index idx.
+     *
+     * Does not raise Lua errors, so that no C++ frame is skipped: for values which cannot be copied (functions, ...),
+     * returns nullptr and sets error. The caller raises the error once its C++ objects are destroyed.
+     */
+    static auto fromStack(lua_State* L, int idx, std::string& error, int depth = 0) -> std::unique_ptr<LuaValue> {
+        idx = lua_absindex(L, idx);
+        auto v = std::make_unique<LuaValue>();
+        switch (lua_type(L, idx)) {
+            case LUA_TNONE:
+            case LUA_TNIL:
+                break;
+            case LUA_TBOOLEAN:
+                v->type = BOOLEAN;
+                v->boolean = lua_toboolean(L, idx);
+                break;
+            case LUA_TNUMBER:
+                if (lua_isinteger(L, idx)) {
+                    v->type = INTEGER;
+                    v->integer = lua_tointeger(L, idx);
+                } else {
+                    v->type = NUMBER;
+                    v->number = lua_tonumber(L, idx);
+                }
+                break;
+            case LUA_TSTRING: {
+                size_t len = 0;
+                const char* str = lua_tolstring(L, idx, &len);
+                v->type = STRING;
+                v->string.assign(str, len);
+                break;
+            }
+            case LUA_TUSERDATA:
+                if (auto* points = static_cast<PointBuffer*>(luaL_testudata(L, idx, POINT_BUFFER_METATABLE))) {
+                    v->type = POINTS;
+                    v->points = *points;
+                    break;
+                }
+                error = "Only point buffers can be passed to or from a background worker";
+                return nullptr;
+            case LUA_TTABLE:
+                if (depth >= MAX_DEPTH) {
+                    error = "Table nested too deeply (or cyclic) to be passed to or from a background worker";
+                    return nullptr;
+                }
+                v->type = TABLE;
+                lua_pushnil(L);
+                while (lua_next(L, idx) != 0) {
+                    auto key = fromStack(L, -2, error, depth + 1);
+                    auto value = key ? fromStack(L, -1, error, depth + 1) : nullptr;
+                    if (!value) {
+                        lua_pop(L, 2);  // key and value
+                        return nullptr;
+                    }
+                    v->table.emplace_back(std::move(*key), std::move(*value));
+                    lua_pop(L, 1);
+                }
+                break;
+            default:
+                error = std::string("A ") + luaL_typename(L, idx) + " cannot be passed to or from a background worker";
+                return nullptr;
+        }
+        return v;
+    }
+
+    void push(lua_State* L) const {
+        switch (this->type) {
+            case NIL:
+                lua_pushnil(L);
+                break;
+            case BOOLEAN:
+                lua_pushboolean(L, this->boolean);
+                break;
+            case INTEGER:
+                lua_pushinteger(L, this->integer);
+                break;
+            case NUMBER:
+                lua_pushnumber(L, this->number);
+                break;
+            case STRING:
+                lua_pushlstring(L, this->string.data(), this->string.size());
+                break;
+            case POINTS:
+                pushPointBuffer(L, this->points);
+                break;
+            case TABLE:
+                lua_createtable(L, 0, static_cast<int>(this->table.size()));
+                for (auto const& [key, value]: this->table) {
+                    key.push(L);
+                    value.push(L);
+                    lua_settable(L, -3);
+                }
+                break;
+        }
+    }
+
+    Type type = NIL;
+    bool boolean = false;
+    lua_Integer integer = 0;
+    lua_Number number = 0;
+    std::string string;
+    PointBuffer points;
+    std::vector<std::pair<LuaValue, LuaValue>> table;
+};
+
+/**
+ * Read-only copy of the strokes of (a part of) the document, taken on the main thread
+ */
+struct DocumentSnapshot {
+    struct LayerData {
+        std::string name;
+        bool visible = true;
+        std::vector<std::unique_ptr<Stroke>> strokes;
+    };
+
+    struct PageData {
+        size_t pageNo = 0;
+        double width = 0;
+        double height = 0;
+        std::vector<LayerData> layers;
+    };
+
+    DocumentSnapshot(Document* doc, size_t firstPage, size_t lastPage, size_t currentPage): currentPage(currentPage) {
+        doc->lock();
+        lastPage = std::min(lastPage, doc->getPageCount());
+        for (size_t i = firstPage; i < lastPage; i++) {
+            PageRef page = doc->getPage(i);
+            auto& pageData = this->pages.emplace_back();
+            pageData.pageNo = i;
+            pageData.width = page->getWidth();
+            pageData.height = page->getHeight();
+            for (Layer* l: *page->getLayers()) {
+                auto& layerData = pageData.layers.emplace_back();
+                layerData.name = l->getName();
+                layerData.visible = l->isVisible();
+                for (Element* e: l->getElements()) {
+                    if (e->getType() == ELEMENT_STROKE) {
+                        layerData.strokes.emplace_back(static_cast<Stroke*>(e)->cloneStroke());
+                    }
+                }
+            }
+        }
+        doc->unlock();
+    }
+
+    /**
+     * Pushes the snapshot as a table. Page numbers are 1-based, the strokes have the format of app.getStrokesBulk:
+     * { pages = { { pageNo, width, height, layers = { { name, visible, strokes = { ... } } } } }, currentPage }
+     */
+    void push(lua_State* L) const {
+        lua_createtable(L, 0, 2);
+        lua_createtable(L, static_cast<int>(this->pages.size()), 0);
+        lua_Integer pageIdx = 0;
+        for (auto const& page: this->pages) {
+            lua_createtable(L, 0, 4);
+            lua_pushinteger(L, as_signed(page.pageNo + 1));
+            lua_setfield(L, -2, "pageNo");
+            lua_pushnumber(L, page.width);
+            lua_setfield(L, -2, "width");
+            lua_pushnumber(L, page.height);
+            lua_setfield(L, -2, "height");
+
+            lua_createtable(L, static_cast<int>(page.layers.size()), 0);
+            lua_Integer layerIdx = 0;
+            for (auto const& layer: page.layers) {
+                lua_createtable(L, 0, 3);
+                lua_pushstring(L, layer.name.c_str());
+                lua_setfield(L, -2, "name");
+                lua_pushboolean(L, layer.visible);
+                lua_setfield(L, -2, "visible");
+
+                lua_createtable(L, static_cast<int>(layer.strokes.size()), 0);
+                lua_Integer strokeIdx = 0;
+                for (auto const& stroke: layer.strokes) {
+                    pushStrokeWithPointBuffer(L, stroke.get());
+                    lua_rawseti(L, -2, ++strokeIdx);
+                }
+                lua_setfield(L, -2, "strokes");
+                lua_rawseti(L, -2, ++layerIdx);
+            }
+            lua_setfield(L, -2, "layers");
+            lua_rawseti(L, -2, ++pageIdx);
+        }
+        lua_setfield(L, -2, "pages");
+        lua_pushinteger(L, as_signed(this->currentPage + 1));
+        lua_setfield(L, -2, "currentPage");
+    }
+
+    std::vector<PageData> pages;
+    size_t currentPage;
+};
+
+}  // namespace xoj::plugin
+
+using xoj::plugin::DocumentSnapshot;
+using xoj::plugin::LuaValue;
+
+/// Number of Lua instructions between two checks for the cancellation of a worker
+constexpr int CANCEL_CHECK_INTERVAL = 10000;
+
+/**
+ * Sends a copy of a value (nil, boolean, number, string, point buffer or table of those) to the main thread,
+ * where it is passed to the callback of the worker.
+ *
+ * Example: worker.post({["strokes"] = result})
+ */
+static int workerlib_post(lua_State* L) {
+    PluginWorker* worker = PluginWorker::getWorkerFromLua(L);
+    bool copied = false;
+    {
+        // The C++ objects must be destroyed before the Lua error is raised
+        std::string error;
+        auto message = LuaValue::fromStack(L, 1, error);
+        copied = message != nullptr;
+        if (copied) {
+            worker->post(std::move(message));
+        } else {
+            lua_pushstring(L, error.c_str());
+        }
+    }
+    return copied ? 0 : lua_error(L);
+}
+
+/**
+ * Reports the progress of the worker, shown in the status bar of the main window
+ *
+ * Example: worker.progress(i, #snapshot.pages)
+ */
+static int workerlib_progress(lua_State* L) {
+    PluginWorker* worker = PluginWorker::getWorkerFromLua(L);
+    auto current = luaL_checkinteger(L, 1);
+    auto max = luaL_optinteger(L, 2, 100);
+    luaL_argcheck(L, max > 0, 2, "the maximum must be positive");
+    worker->reportProgress(static_cast<int>(current), static_cast<int>(max));
+    return 0;
+}
+
+/**
+ * Returns true if the worker has been cancelled (app.cancelBackground). The worker should return as soon as possible.
+ *
+ * Example: if worker.isCancelled() then return end
+ */
+static int workerlib_isCancelled(lua_State* L) {
+    lua_pushboolean(L, PluginWorker::getWorkerFromLua(L)->isCancelled());
+    return 1;
+}
+
+static const luaL_Reg workerlib[] = {{"post", workerlib_post},
+                                     {"progress", workerlib_progress},
+                                     {"isCancelled", workerlib_isCancelled},
+                                     {nullptr, nullptr}};
+
+static int luaopen_worker(lua_State* L) {
+    luaL_newlib(L, workerlib);
+    return 1;
+}
+
+/**
+ * Aborts the worker's Lua code once the worker has been cancelled, even if it never polls worker.isCancelled()
+ */
+static void cancelHook(lua_State* L, lua_Debug*) {
+    if (PluginWorker::getWorkerFromLua(L)->isCancelled()) {
+        luaL_error(L, "Cancelled");
+    }
+}
+
+/**
+ * Runs in protected mode on the worker state: loads the file and calls the function.
+ * Arguments: file name, function name, snapshot (or nil), args. Returns the result of the function.
+ */
+static int workerMain(lua_State* L) {
+    const char* file = lua_tostring(L, 1);
+    const char* function = lua_tostring(L, 2);
+    if (luaL_dofile(L, file) != LUA_OK) {
+        return lua_error(L);
+    }
+    if (lua_getglobal(L, function) != LUA_TFUNCTION) {
+        return luaL_error(L, "No function \"%s\" in \"%s\"", function, file);
+    }
+    lua_pushvalue(L, 3);
+    lua_pushvalue(L, 4);
+    lua_call(L, 2, 1);
+    return 1;
+}
+
+/**
+ * Runs in protected mode on the worker state: copies the value of the first argument to the std::unique_ptr<LuaValue>
+ * given as second argument (light userdata). The copy may fail, e.g. if the worker returns a function.
+ */
+static int copyResult(lua_State* L) {
+    auto* result = static_cast<std::unique_ptr<LuaValue>*>(lua_touserdata(L, 2));
+    {
+        // The C++ objects must be destroyed before the Lua error is raised
+        std::string error;
+        *result = LuaValue::fromStack(L, 1, error);
+        if (!*result) {
+            lua_pushstring(L, error.c_str());
+        }
+    }
+    return *result ? 0 : lua_error(L);
+}
+
+/**
+ * Reads the optional string field key of the table at index idx, without raising Lua errors (no metamethod is called)
+ * @return false if the field is neither nil nor a string
+ */
+static auto getStringField(lua_State* L, int idx, const char* key, std::string& value) -> bool {
+    lua_pushstring(L, key);
+    lua_rawget(L, idx);
+    bool valid = true;
+    if (lua_isstring(L, -1)) {
+        value = lua_tostring(L, -1);
+    } else {
+        valid = lua_isnil(L, -1);
+    }
+    lua_pop(L, 1);
+    return valid;
+}
+
+PluginWorker::Options::Options() = default;
+PluginWorker::Options::Options(Options&&) = default;
+PluginWorker::Options::~Options() = default;
+
+auto PluginWorker::readOptions(lua_State* L, int optionsIdx, Options& options) -> std::string {
+    optionsIdx = lua_absindex(L, optionsIdx);
+    if (!lua_istable(L, optionsIdx)) {
+        return "The options of a background worker must be a table";
+    }
+
+    for (auto [key, value]: {std::pair{"file", &options.file}, std::pair{"function", &options.function},
+                             std::pair{"callback", &options.callback}, std::pair{"done", &options.doneCallback},
+                             std::pair{"snapshot", &options.snapshotType}}) {
+        if (!getStringField(L, optionsIdx, key, *value)) {
+            return std::string("The option \"") + key + "\" must be a string";
+        }
+    }
+
+    if (options.file.empty()) {
+        return "The option \"file\" is required";
+    }
+    // The file must stay within the plugin folder
+    fs::path file = fs::u8path(options.file);
+    if (file.is_absolute() || file.has_root_name() || file.has_root_directory() ||
+        std::any_of(file.begin(), file.end(), [](const fs::path& part) { return part == ".."; })) {
+        return "Unsupported path \"" + options.file + "\"";
+    }
+    if (options.snapshotType != "none" && options.snapshotType != "page" && options.snapshotType != "document") {
+        return "Unknown snapshot type \"" + options.snapshotType + "\"";
+    }
+
+    std::string error;
+    lua_pushstring(L, "args");
+    lua_rawget(L, optionsIdx);
+    options.args = LuaValue::fromStack(L, -1, error);
+    lua_pop(L, 1);
+    return error;
+}
+
+PluginWorker::PluginWorker(Plugin* plugin, Options options, size_t id, ProgressListener* progressListener):
+        plugin(plugin),
+        progressListener(progressListener),
+        id(id),
+        file(plugin->getPath() / fs::u8path(options.file)),
+        function(std::move(options.function)),
+        callback(std::move(options.callback)),
+        doneCallback(std::move(options.doneCallback)),
+        args(std::move(options.args)) {
+    Control* control = plugin->getControl();
+    Document* doc = control->getDocument();
+    size_t currentPage = control->getCurrentPageNo();
+    if (options.snapshotType == "document") {
+        this->snapshot = std::make_unique<DocumentSnapshot>(doc, 0, doc->getPageCount(), currentPage);
+    } else if (options.snapshotType == "page") {
+        this->snapshot = std::make_unique<DocumentSnapshot>(doc, currentPage, currentPage + 1, currentPage);
+    }
+}
+
+PluginWorker::~PluginWorker() {
+    cancel();
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+
+    std::lock_guard lock(this->messageLock);
+    if (this->deliverSourceId) {
+        g_source_remove(this->deliverSourceId);
+    }
+}
+
+void PluginWorker::start() { this->thread = std::thread(&PluginWorker::run, this); }
+
+void PluginWorker::cancel() { this->cancelled = true; }
+
+auto PluginWorker::isCancelled() const -> bool { return this->cancelled; }
+
+auto PluginWorker::getId() const -> size_t { return this->id; }
+
+auto PluginWorker::getWorkerFromLua(lua_State* lua) -> PluginWorker* {
+    lua_getfield(lua, LUA_REGISTRYINDEX, "Xournalpp_PluginWorker");
+    auto* worker = static_cast<PluginWorker*>(lua_touserdata(lua, -1));
+    lua_pop(lua, 1);
+    return worker;
+}
+
+void PluginWorker::run() {
+    std::unique_ptr<lua_State, LuaDeleter> lua(luaL_newstate());
+    lua_State* L = lua.get();
+    luaL_openlibs(L);
+
+    lua_pushlightuserdata(L, this);
+    lua_setfield(L, LUA_REGISTRYINDEX, "Xournalpp_PluginWorker");
+    registerPointBufferMetatable(L);
+    luaL_requiref(L, "worker", luaopen_worker, 1);
+    lua_pop(L, 1);
+    lua_sethook(L, cancelHook, LUA_MASKCOUNT, CANCEL_CHECK_INTERVAL);
+
+    // Allow the worker to require the modules of the plugin
+    lua_getglobal(L, "package");
+    auto pluginPath = (this->plugin->getPath() / "?.lua").string();
+    lua_getfield(L, -1, "path");
+    lua_pushfstring(L, "%s;%s", pluginPath.c_str(), lua_tostring(L, -1));
+    lua_setfield(L, -3, "path");
+    lua_pop(L, 2);
+
+    lua_pushcfunction(L, workerMain);
+    lua_pushstring(L, this->file.string().c_str());
+    lua_pushstring(L, this->function.c_str());
+    if (this->snapshot) {
+        this->snapshot->push(L);
+        this->snapshot.reset();  // Not needed anymore, the worker has its own copy
+    } else {
+        lua_pushnil(L);
+    }
+    this->args->push(L);
+
+    if (lua_pcall(L, 4, 1, 0) != LUA_OK) {
+        const char* errMsg = lua_tostring(L, -1);
+        enqueue({Message::FAILED, nullptr, errMsg ? errMsg : "Unknown error"});
+        return;
+    }
+
+    lua_pushcfunction(L, copyResult);
+    lua_insert(L, -2);
+    std::unique_ptr<LuaValue> result;
+    lua_pushlightuserdata(L, &result);
+    if (lua_pcall(L, 2, 0, 0) != LUA_OK) {
+        const char* errMsg = lua_tostring(L, -1);
+        enqueue({Message::FAILED, nullptr, errMsg ? errMsg : "Unknown error"});
+        return;
+    }
+    enqueue({Message::DONE, std::move(result), {}});
+}
+
+void PluginWorker::post(std::unique_ptr<LuaValue> message) { enqueue({Message::POST, std::move(message), {}}); }
+
+void PluginWorker::reportProgress(int current, int max) {
+    std::lock_guard lock(this->messageLock);
+    this->progressCurrent = current;
+    this->progressMax = max;
+    if (!this->deliverSourceId) {
+        this->deliverSourceId = gdk_threads_add_idle(reinterpret_cast<GSourceFunc>(deliverCallback), this);
+    }
+}
+
+void PluginWorker::enqueue(Message message) {
+    std::lock_guard lock(this->messageLock);
+    this->messages.emplace_back(std::move(message));
+    if (!this->deliverSourceId) {
+        this->deliverSourceId = gdk_threads_add_idle(reinterpret_cast<GSourceFunc>(deliverCallback), this);
+    }
+}
+
+auto PluginWorker::deliverCallback(PluginWorker* self) -> gboolean {
+    std::deque<Message> pending;
+    int current = -1;
+    int max = 0;
+    {
+        std::lock_guard lock(self->messageLock);
+        std::swap(pending, self->messages);
+        std::swap(current, self->progressCurrent);
+        max = self->progressMax;
+        self->deliverSourceId = 0;
+    }
+
+    if (current >= 0 && self->progressListener) {
+        self->progressListener->setMaximumState(max);
+        self->progressListener->setCurrentState(current);
+    }
+
+    for (auto& message: pending) {
+        if (message.type == Message::POST) {
+            if (!self->callback.empty()) {
+                self->plugin->callFunction(self->callback, [&message](lua_State* L) {
+                    message.value->push(L);
+                    return 1;
+                });
+            }
+            continue;
+        }
+
+        // DONE or FAILED: always the last message of the worker
+        if (message.type == Message::FAILED) {
+            g_warning("Background worker of plugin \"%s\" failed: \"%s\"", self->plugin->getName().c_str(),
+                      message.error.c_str());
+        }
+        if (!self->doneCallback.empty()) {
+            self->plugin->callFunction(self->doneCallback, [&message](lua_State* L) {
+                if (message.type == Message::DONE) {
+                    message.value->push(L);
+                    return 1;
+                }
+                lua_pushnil(L);
+                lua_pushstring(L, message.error.c_str());
+                return 2;
+            });
+        } else if (message.type == Message::FAILED && !self->isCancelled()) {
+            std::map<int, std::string> button;
+            button.insert(std::pair<int, std::string>(0, _("OK")));
+            XojMsgBox::showPluginMessage(self->plugin->getName(), message.error, button, true);
+        }
+        self->plugin->removeWorker(self);  // Deletes self
+        break;
+    }
+
+    // do not call again
+    return false;
+}
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Xournal++
+ *
+ * Runs a Lua function of a plugin in a separate Lua state on a worker thread
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "config-features.h"  // for ENABLE_PLUGINS
+
+#ifdef ENABLE_PLUGINS
+
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
+#include <deque>    // for deque
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex
+#include <string>   // for string
+#include <thread>   // for thread
+
+#include <glib.h>  // for guint
+
+#include "filesystem.h"  // for path
+
+extern "C" {
+#include <lua.h>  // for lua_State
+}
+
+class Plugin;
+class ProgressListener;
+
+namespace xoj::plugin {
+struct LuaValue;
+struct DocumentSnapshot;
+}  // namespace xoj::plugin
+
+/**
+ * @brief Background execution of plugin code.
+ *
+ * The worker runs `function(snapshot, args)` of a Lua file of the plugin in a fresh Lua state on its own thread. The
+ * worker state has no access to the `app` library: it only sees a read-only copy of the document (taken on the main
+ * thread when the worker is created) and the `worker` library (post, progress, isCancelled).
+ *
+ * Messages posted by the worker are copied and handed to a callback of the plugin on the main thread, where the
+ * document can be modified through the regular `app` API. Progress is reported through a ProgressListener, also on
+ * the main thread.
+ *
+ * Workers are owned by their Plugin. All public methods must be called from the main thread.
+ */
+class PluginWorker final {
+public:
+    /**
+     * The options of app.runInBackground
+     */
+    struct Options {
+        Options();
+        Options(Options&&);
+        ~Options();
+
+        std::string file;  ///< Relative to the plugin folder
+        std::string function = "main";
+        std::string callback;
+        std::string doneCallback;
+        std::string snapshotType = "none";
+        std::unique_ptr<xoj::plugin::LuaValue> args;
+    };
+
+    /**
+     * Parses the options table at index optionsIdx of the plugin's Lua state L (see app.runInBackground).
+     *
+     * Does not raise Lua errors, as they would skip the destructors of the C++ objects on the way.
+     * @return The error message if the options are invalid, an empty string otherwise
+     */
+    static auto readOptions(lua_State* L, int optionsIdx, Options& options) -> std::string;
+
+    PluginWorker(Plugin* plugin, Options options, size_t id, ProgressListener* progressListener);
+    PluginWorker(const PluginWorker&) = delete;
+    PluginWorker& operator=(const PluginWorker&) = delete;
+
+    /**
+     * Requests the cancellation and waits for the worker thread to terminate. Undelivered messages are dropped.
+     */
+    ~PluginWorker();
+
+public:
+    void start();
+
+    /**
+     * Requests the cancellation. The worker is expected to poll worker.isCancelled() and return early.
+     */
+    void cancel();
+
+    auto getId() const -> size_t;
+
+public:
+    /// Called from the worker thread (worker library)
+    void post(std::unique_ptr<xoj::plugin::LuaValue> message);
+    void reportProgress(int current, int max);
+    auto isCancelled() const -> bool;
+
+    /// Get the worker from the worker's Lua state
+    static auto getWorkerFromLua(lua_State* lua) -> PluginWorker*;
+
+private:
+    struct Message {
+        enum Type { POST, DONE, FAILED };
+        Type type;
+        std::unique_ptr<xoj::plugin::LuaValue> value;
+        std::string error;
+    };
+
+    void run();
+    void enqueue(Message message);
+
+    /// Delivers the queued messages on the main thread
+    static auto deliverCallback(PluginWorker* self) -> gboolean;
+
+private:
+    Plugin* plugin;
+    ProgressListener* progressListener;
+    size_t id;
+
+    fs::path file;
+    std::string function;
+    std::string callback;      ///< Called with every posted message
+    std::string doneCallback;  ///< Called with the return value of the function, or nil and the error message
+
+    std::unique_ptr<xoj::plugin::DocumentSnapshot> snapshot;
+    std::unique_ptr<xoj::plugin::LuaValue> args;
+
+    std::thread thread;
+    std::atomic<bool> cancelled{false};
+
+    std::mutex messageLock;
+    std::deque<Message> messages;  ///< Guarded by messageLock
+    guint deliverSourceId = 0;     ///< Guarded by messageLock
+    int progressCurrent = -1;      ///< Guarded by messageLock, -1 if unchanged since the last delivery
+    int progressMax = 0;           ///< Guarded by messageLock
+};
+
+#endif
@@ -14,6 +14,7 @@
 #include <cstring>
 #include <limits>  // for numeric_limits
 #include <map>
+#include <vector>
 
 #include <gtk/gtk.h>
 #include <stdint.h>
@@ -35,13 +36,16 @@
 #include "gui/widgets/XournalWidget.h"
 #include "model/Document.h"
 #include "model/Font.h"
+#include "model/Point.h"
 #include "model/SplineSegment.h"
 #include "model/Stroke.h"
 #include "model/StrokeStyle.h"
 #include "model/Text.h"
 #include "model/XojPage.h"
 #include "plugin/Plugin.h"
+#include "plugin/luapi_pointbuffer.h"
 #include "undo/InsertUndoAction.h"
+#include "util/Range.h"
 #include "util/StringUtils.h"
 #include "util/XojMsgBox.h"
 #include "util/i18n.h"  // for _
@@ -948,6 +952,318 @@ static int applib_getStrokes(lua_State* L) {
     return 1;
 }
 
+/**
+ * Creates a new point buffer, optionally with a reserved capacity (in points).
+ * A point buffer is a packed array of points with the methods size, get, set, append, resize and clear.
+ * Indices are 1-based like in Lua tables.
+ *
+ * Example:
+ *   local points = app.newPointBuffer(1000)
+ *   for i = 0, 999 do points:append(100 + i * 0.1, 200 + math.sin(i / 50) * 20) end
+ */
+static int applib_newPointBuffer(lua_State* L) {
+    lua_Integer capacity = luaL_optinteger(L, 1, 0);
+    luaL_argcheck(L, capacity >= 0, 1, "capacity must not be negative");
+    pushPointBuffer(L)->reserve(static_cast<size_t>(capacity));
+    return 1;
+}
+
+/**
+ * Bulk version of app.addStrokes: the points of each stroke are given as a point buffer (see app.newPointBuffer).
+ * The points are moved into the strokes without being copied, so the buffers are empty afterwards.
+ *
+ * All strokes are added to the current layer, the page is rerendered once and, by default, a single undo action is
+ * recorded for the whole batch.
+ *
+ * Required Arguments: strokes (each with points)
+ * Optional Arguments: tool, width, color, fill, lineStyle (per stroke), allowUndoRedoAction
+ *
+ * Example:
+ *
+ * app.addStrokesBulk({
+ *     ["strokes"] = {
+ *         {
+ *             ["points"] = points, -- a point buffer
+ *             ["tool"] = "pen",
+ *             ["width"] = 3.8,
+ *             ["color"] = 0xa000f0,
+ *             ["fill"] = 0,
+ *             ["lineStyle"] = "solid",
+ *         },
+ *     },
+ *     ["allowUndoRedoAction"] = "grouped", -- or "individual" or "none"
+ * })
+ */
+static int applib_addStrokesBulk(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* ctrl = plugin->getControl();
+
+    // Discard any extra arguments passed in
+    lua_settop(L, 1);
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    lua_getfield(L, 1, "allowUndoRedoAction");
+    const char* allowUndoRedoAction = luaL_optstring(L, -1, "grouped");  // Stays on the stack at index 2
+
+    lua_getfield(L, 1, "strokes");
+    if (!lua_istable(L, -1)) {
+        return luaL_error(L, "Missing stroke table!");
+    }
+    auto numStrokes = static_cast<lua_Integer>(lua_rawlen(L, -1));
+
+    /*
+     * First check all the arguments, without side effects: a Lua error raised once strokes are added to the layer would
+     * leave them without undo action nor rerendering, and would skip the destructors of the C++ objects below.
+     */
+    for (lua_Integer a = 1; a <= numStrokes; a++) {
+        lua_rawgeti(L, -1, a);
+        if (!lua_istable(L, -1)) {
+            return luaL_error(L, "Stroke %d is not a table!", static_cast<int>(a));
+        }
+        lua_getfield(L, -1, "points");
+        if (!luaL_testudata(L, -1, POINT_BUFFER_METATABLE)) {
+            return luaL_error(L, "Stroke %d has no point buffer!", static_cast<int>(a));
+        }
+        lua_getfield(L, -2, "tool");
+        if (!lua_isnil(L, -1) && !lua_isstring(L, -1)) {
+            return luaL_error(L, "The tool of stroke %d is not a string!", static_cast<int>(a));
+        }
+        lua_pop(L, 3);
+    }
+    if (!ctrl->getCurrentPage()) {
+        return luaL_error(L, "There is no current page!");
+    }
+
+    // No Lua error can be raised from here on
+    PageRef page = ctrl->getCurrentPage();
+    Layer* layer = page->getSelectedLayer();
+    std::vector<Element*> strokes;
+    Range range;
+    strokes.reserve(static_cast<size_t>(numStrokes));
+    for (lua_Integer a = 1; a <= numStrokes; a++) {
+        lua_rawgeti(L, -1, a);
+        lua_getfield(L, -1, "points");
+        auto* buffer = static_cast<PointBuffer*>(luaL_testudata(L, -1, POINT_BUFFER_METATABLE));
+        lua_pop(L, 1);
+
+        if (buffer->size() < 2) {
+            g_warning("Stroke shorter than two points. Discarding. (Has %zu/2)", buffer->size());
+            lua_pop(L, 1);
+            continue;
+        }
+
+        auto* stroke = new Stroke();
+        stroke->setPointVector(std::move(*buffer));
+        buffer->clear();  // A moved-from vector is only guaranteed to be valid, not empty
+
+        // Finish building the Stroke and apply it to the layer.
+        addStrokeHelper(L, stroke);
+        range = range.unite(Range(stroke->boundingRect()));
+        strokes.push_back(stroke);
+        // Onto the next stroke
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);  // The stroke table
+
+    UndoRedoHandler* undo = ctrl->getUndoRedoHandler();
+    if (strcmp(allowUndoRedoAction, "grouped") == 0) {
+        undo->addUndoAction(std::make_unique<InsertsUndoAction>(page, layer, strokes));
+    } else if (strcmp(allowUndoRedoAction, "individual") == 0) {
+        for (Element* element: strokes) undo->addUndoAction(std::make_unique<InsertUndoAction>(page, layer, element));
+    } else if (strcmp(allowUndoRedoAction, "none") == 0) {
+        g_warning("Not allowing undo/redo action.");
+    } else {
+        g_warning("Unrecognized undo/redo option: %s", allowUndoRedoAction);
+    }
+    lua_pop(L, 1);  // Stack is now the same as it was on entry to this function
+
+    if (!strokes.empty()) {
+        page->fireElementsChanged(strokes, range);
+    }
+    return 0;
+}
+
+/**
+ * Bulk version of app.getStrokes: puts a table of the strokes (from the selection tool / selected layer) onto the
+ * stack, the points of each stroke being returned in a point buffer (see app.newPointBuffer and app.addStrokesBulk).
+ *
+ * Required argument: type ("selection" or "layer")
+ *
+ * Example:
+ *   for _, stroke in ipairs(app.getStrokesBulk("layer")) do
+ *     local x, y = stroke.points:get(1)
+ *   end
+ */
+static int applib_getStrokesBulk(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* control = plugin->getControl();
+    if (!control->getCurrentPage()) {
+        return luaL_error(L, "There is no current page!");
+    }
+    std::string type = StringUtils::toLowerCase(luaL_checkstring(L, 1));
+
+    std::vector<Element*> elements;
+    if (type == "layer") {
+        if (control->getWindow()->getXournal()->getSelection()) {
+            control->clearSelection();  // otherwise strokes in the selection won't be recognized
+        }
+        elements = control->getCurrentPage()->getSelectedLayer()->getElements();
+    } else if (type == "selection") {
+        auto sel = control->getWindow()->getXournal()->getSelection();
+        if (!sel) {
+            g_warning("There is no selection! ");
+            return 0;
+        }
+        elements = sel->getElements();
+    } else {
+        g_warning("Unknown argument: %s", type.c_str());
+        return 0;
+    }
+
+    lua_createtable(L, static_cast<int>(elements.size()), 0);
+    lua_Integer currStrokeNo = 0;
+    for (Element* e: elements) {
+        if (e->getType() == ELEMENT_STROKE) {
+            pushStrokeWithPointBuffer(L, static_cast<Stroke*>(e));
+            lua_rawseti(L, -2, ++currStrokeNo);
+        }
+    }
+    return 1;
+}
+
+/**
+ * Iterator function returned by app.iterateStrokes.
+ * Upvalues: 1 = the iterated layer (light userdata), 2 = its revision, 3 = the index of the next element,
+ * 4 = the number of strokes returned so far.
+ */
+static int strokeIteratorNext(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* control = plugin->getControl();
+
+    // The layer is resolved again at every step and compared with the one the iteration started with, so that the
+    // iteration neither reads freed memory nor silently skips elements if a callback changes the document.
+    PageRef const& page = control->getCurrentPage();
+    Layer* layer = page ? page->getSelectedLayer() : nullptr;
+    if (layer != lua_touserdata(L, lua_upvalueindex(1)) ||
+        static_cast<lua_Integer>(layer->getRevision()) != lua_tointeger(L, lua_upvalueindex(2))) {
+        return luaL_error(L, "The layer was modified during the iteration!");
+    }
+
+    auto& elements = layer->getElements();
+    auto i = static_cast<size_t>(lua_tointeger(L, lua_upvalueindex(3)));
+    while (i < elements.size() && elements[i]->getType() != ELEMENT_STROKE) { i++; }
+    if (i >= elements.size()) {
+        return 0;
+    }
+
+    lua_pushinteger(L, as_signed(i + 1));
+    lua_replace(L, lua_upvalueindex(3));
+
+    lua_Integer strokeNo = lua_tointeger(L, lua_upvalueindex(4)) + 1;
+    lua_pushinteger(L, strokeNo);
+    lua_replace(L, lua_upvalueindex(4));
+
+    lua_pushinteger(L, strokeNo);
+    pushStrokeWithPointBuffer(L, static_cast<Stroke*>(elements[i]));
+    return 2;
+}
+
+/**
+ * Returns an iterator over the strokes of the selected layer of the current page, for use in a generic for loop.
+ * Each step returns the number of the stroke and a table in the format of app.getStrokesBulk. Only one stroke is
+ * converted at a time, so large layers can be analysed without building a table of all their strokes first.
+ * Modifying the layer while iterating raises an error.
+ *
+ * Example:
+ *   for i, stroke in app.iterateStrokes() do
+ *     print(i, stroke.color, #stroke.points)
+ *   end
+ */
+static int applib_iterateStrokes(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* control = plugin->getControl();
+    PageRef const& page = control->getCurrentPage();
+    if (!page) {
+        return luaL_error(L, "There is no current page!");
+    }
+    if (control->getWindow()->getXournal()->getSelection()) {
+        control->clearSelection();  // otherwise strokes in the selection won't be recognized
+    }
+
+    Layer* layer = page->getSelectedLayer();
+    lua_pushlightuserdata(L, layer);
+    lua_pushinteger(L, static_cast<lua_Integer>(layer->getRevision()));
+    lua_pushinteger(L, 0);
+    lua_pushinteger(L, 0);
+    lua_pushcclosure(L, strokeIteratorNext, 4);
+    return 1;
+}
+
+/**
+ * Runs a function of the plugin in the background, in a separate Lua state on a worker thread, so that expensive
+ * computations do not block the UI. Returns the ID of the worker (see app.cancelBackground).
+ *
+ * The worker loads "file" (relative to the plugin folder) and calls its global function "function" (default: "main")
+ * with two arguments: a read-only snapshot of the document (or nil) and a copy of "args". The worker cannot use the
+ * app library. Instead it has a "worker" library:
+ *   worker.post(value)         -- copies value (nil, boolean, number, string, point buffer or table of those) to the
+ *                                 main thread and calls the global function named "callback" of the plugin with it
+ *   worker.progress(i, max)    -- shows the progress in the status bar
+ *   worker.isCancelled()       -- true once app.cancelBackground was called; the worker is aborted shortly after
+ *
+ * When the function returns, the global function named "done" of the plugin is called on the main thread with a copy
+ * of the return value, or with nil and the error message if the worker failed.
+ * The document may only be modified in the callbacks, through the regular app API.
+ *
+ * The snapshot ("none", "page" or "document") has the following format (strokes as in app.getStrokesBulk):
+ * { ["pages"] = { { ["pageNo"], ["width"], ["height"], ["layers"] = { { ["name"], ["visible"], ["strokes"] } } } },
+ *   ["currentPage"] }
+ *
+ * Example:
+ *   local id = app.runInBackground({
+ *       ["file"] = "worker.lua",
+ *       ["function"] = "smooth",
+ *       ["snapshot"] = "page",
+ *       ["args"] = {["strength"] = 0.5},
+ *       ["callback"] = "onSmoothedStrokes", -- called with each worker.post(...) of the worker
+ *       ["done"] = "onSmoothingDone",
+ *   })
+ */
+static int applib_runInBackground(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+
+    // Discard any extra arguments passed in
+    lua_settop(L, 1);
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    bool started = false;
+    {
+        // The C++ objects must be destroyed before the Lua error is raised
+        std::string error;
+        size_t id = plugin->startWorker(L, 1, error);
+        started = error.empty();
+        if (started) {
+            lua_pushinteger(L, as_signed(id));
+        } else {
+            lua_pushstring(L, error.c_str());
+        }
+    }
+    return started ? 1 : lua_error(L);
+}
+
+/**
+ * Requests the cancellation of a background worker started with app.runInBackground.
+ * Returns false if the worker has already finished.
+ *
+ * Example: app.cancelBackground(id)
+ */
+static int applib_cancelBackground(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    lua_Integer id = luaL_checkinteger(L, 1);
+    lua_pushboolean(L, id > 0 && plugin->cancelWorker(static_cast<size_t>(id)));
+    return 1;
+}
+
 /**
  * Notifies program of any updates to the working document caused
  * by the API.
@@ -2007,6 +2323,12 @@ static const luaL_Reg applib[] = {{"msgbox", applib_msgbox},
                                   {"getFilePath", applib_getFilePath},
                                   {"refreshPage", applib_refreshPage},
                                   {"getStrokes", applib_getStrokes},
+                                  {"newPointBuffer", applib_newPointBuffer},
+                                  {"addStrokesBulk", applib_addStrokesBulk},
+                                  {"getStrokesBulk", applib_getStrokesBulk},
+                                  {"iterateStrokes", applib_iterateStrokes},
+                                  {"runInBackground", applib_runInBackground},
+                                  {"cancelBackground", applib_cancelBackground},
                                   {"openFile", applib_openFile},
                                   // Placeholder
                                   //	{"MSG_BT_OK", nullptr},
@@ -2017,6 +2339,7 @@ static const luaL_Reg applib[] = {{"msgbox", applib_msgbox},
  * Open application Library
  */
 LUAMOD_API int luaopen_app(lua_State* L) {
+    registerPointBufferMetatable(L);
     luaL_newlib(L, applib);
     //	lua_pushnumber(L, MSG_BT_OK);
     //	lua_setfield(L, -2, "MSG_BT_OK");
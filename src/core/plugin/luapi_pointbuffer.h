@@ -0,0 +1,191 @@
+/*
+ * Xournal++
+ *
+ * Lua API, packed point buffers shared by the application library and the background workers
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/StrokeStyle.h"
+#include "util/safe_casts.h"
+
+extern "C" {
+#include <lauxlib.h>  // for luaL_Reg, luaL_checkudata, luaL_setmetatable
+#include <lua.h>      // for lua_State, lua_newuserdata, lua_setfield
+}
+
+/**
+ * Name of the metatable shared by all point buffers
+ */
+static constexpr const char* POINT_BUFFER_METATABLE = "xournalpp.PointBuffer";
+
+/**
+ * A point buffer is a userdata holding a packed std::vector<Point> (x, y, pressure as doubles).
+ * Points are only converted to Lua numbers when they are accessed, and strokes take over the vector without copying.
+ */
+using PointBuffer = std::vector<Point>;
+
+static PointBuffer* pushPointBuffer(lua_State* L, PointBuffer points = {}) {
+    void* memory = lua_newuserdata(L, sizeof(PointBuffer));
+    auto* buffer = new (memory) PointBuffer(std::move(points));
+    luaL_setmetatable(L, POINT_BUFFER_METATABLE);
+    return buffer;
+}
+
+static PointBuffer* checkPointBuffer(lua_State* L, int idx) {
+    return static_cast<PointBuffer*>(luaL_checkudata(L, idx, POINT_BUFFER_METATABLE));
+}
+
+/**
+ * Converts the 1-based Lua index at stack position idx into a 0-based index into buffer
+ */
+static size_t checkPointIndex(lua_State* L, const PointBuffer& buffer, int idx) {
+    lua_Integer i = luaL_checkinteger(L, idx);
+    luaL_argcheck(L, i >= 1 && static_cast<size_t>(i) <= buffer.size(), idx, "point index out of range");
+    return static_cast<size_t>(i - 1);
+}
+
+static int pointbuffer_gc(lua_State* L) {
+    checkPointBuffer(L, 1)->~PointBuffer();
+    return 0;
+}
+
+/**
+ * Number of points in the buffer
+ *
+ * Example: local n = buffer:size() -- or #buffer
+ */
+static int pointbuffer_size(lua_State* L) {
+    lua_pushinteger(L, as_signed(checkPointBuffer(L, 1)->size()));
+    return 1;
+}
+
+/**
+ * Returns x, y and the pressure of the i-th point. The pressure is nil if the point has none.
+ *
+ * Example: local x, y, pressure = buffer:get(1)
+ */
+static int pointbuffer_get(lua_State* L) {
+    PointBuffer* buffer = checkPointBuffer(L, 1);
+    const Point& p = (*buffer)[checkPointIndex(L, *buffer, 2)];
+    lua_pushnumber(L, p.x);
+    lua_pushnumber(L, p.y);
+    if (p.z != Point::NO_PRESSURE) {
+        lua_pushnumber(L, p.z);
+    } else {
+        lua_pushnil(L);
+    }
+    return 3;
+}
+
+/**
+ * Overwrites the i-th point. The pressure is optional.
+ *
+ * Example: buffer:set(1, 110.0, 200.0, 0.8)
+ */
+static int pointbuffer_set(lua_State* L) {
+    PointBuffer* buffer = checkPointBuffer(L, 1);
+    Point& p = (*buffer)[checkPointIndex(L, *buffer, 2)];
+    p.x = luaL_checknumber(L, 3);
+    p.y = luaL_checknumber(L, 4);
+    p.z = luaL_optnumber(L, 5, Point::NO_PRESSURE);
+    return 0;
+}
+
+/**
+ * Appends a point at the end of the buffer. The pressure is optional.
+ *
+ * Example: buffer:append(110.0, 200.0)
+ */
+static int pointbuffer_append(lua_State* L) {
+    PointBuffer* buffer = checkPointBuffer(L, 1);
+    buffer->emplace_back(luaL_checknumber(L, 2), luaL_checknumber(L, 3), luaL_optnumber(L, 4, Point::NO_PRESSURE));
+    return 0;
+}
+
+/**
+ * Resizes the buffer. New points are (0, 0) without pressure.
+ *
+ * Example: buffer:resize(1000)
+ */
+static int pointbuffer_resize(lua_State* L) {
+    PointBuffer* buffer = checkPointBuffer(L, 1);
+    lua_Integer n = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, n >= 0, 2, "size must not be negative");
+    buffer->resize(static_cast<size_t>(n));
+    return 0;
+}
+
+/**
+ * Removes all points from the buffer
+ *
+ * Example: buffer:clear()
+ */
+static int pointbuffer_clear(lua_State* L) {
+    checkPointBuffer(L, 1)->clear();
+    return 0;
+}
+
+static const luaL_Reg pointbufferlib[] = {{"size", pointbuffer_size},     {"get", pointbuffer_get},
+                                          {"set", pointbuffer_set},       {"append", pointbuffer_append},
+                                          {"resize", pointbuffer_resize}, {"clear", pointbuffer_clear},
+                                          {nullptr, nullptr}};
+
+/**
+ * Registers the metatable of point buffers
+ */
+static void registerPointBufferMetatable(lua_State* L) {
+    luaL_newmetatable(L, POINT_BUFFER_METATABLE);
+    luaL_newlib(L, pointbufferlib);
+    lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, pointbuffer_size);
+    lua_setfield(L, -2, "__len");
+    lua_pushcfunction(L, pointbuffer_gc);
+    lua_setfield(L, -2, "__gc");
+    lua_pop(L, 1);
+}
+
+/**
+ * Pushes a table describing the stroke s, the points being stored in a point buffer.
+ * Same format as the strokes of app.getStrokes except for the "points" field replacing "x", "y" and "pressure".
+ */
+static void pushStrokeWithPointBuffer(lua_State* L, const Stroke* s) {
+    lua_createtable(L, 0, 6);
+
+    pushPointBuffer(L, s->getPointVector());
+    lua_setfield(L, -2, "points");
+
+    StrokeTool tool = s->getToolType();
+    if (tool == StrokeTool::PEN) {
+        lua_pushstring(L, "pen");
+    } else if (tool == StrokeTool::ERASER) {
+        lua_pushstring(L, "eraser");
+    } else {
+        lua_pushstring(L, "highlighter");
+    }
+    lua_setfield(L, -2, "tool");
+
+    lua_pushnumber(L, s->getWidth());
+    lua_setfield(L, -2, "width");
+
+    lua_pushinteger(L, int(uint32_t(s->getColor())));
+    lua_setfield(L, -2, "color");
+
+    lua_pushinteger(L, s->getFill());
+    lua_setfield(L, -2, "fill");
+
+    lua_pushstring(L, StrokeStyle::formatStyle(s->getLineStyle()).c_str());
+    lua_setfield(L, -2, "lineStyle");
+}
@@ -3,9 +3,9 @@
 #include <algorithm>  // for none_of
 #include <utility>    // for move
 
-#include "undo/UndoAction.h"  // for UndoAction
-
-class Control;
+#include "control/Control.h"        // for Control
+#include "model/DocumentHandler.h"  // for DocumentHandler
+#include "undo/UndoAction.h"        // for UndoAction
 
 GroupUndoAction::GroupUndoAction(): UndoAction("GroupUndoAction") {}
 
@@ -30,6 +30,8 @@ auto GroupUndoAction::getPages() -> std::vector<PageRef> {
 }
 
 auto GroupUndoAction::redo(Control* control) -> bool {
+    // The pages inserted or deleted by the actions are laid out once
+    DocumentHandler::PageBatch batch(control);
     bool result = true;
     for (auto& action: actions) { result = result && action->redo(control); }
 
@@ -37,6 +39,7 @@ auto GroupUndoAction::redo(Control* control) -> bool {
 }
 
 auto GroupUndoAction::undo(Control* control) -> bool {
+    DocumentHandler::PageBatch batch(control);
     bool result = true;
     for (auto& action: actions) { result = result && action->undo(control); }
 
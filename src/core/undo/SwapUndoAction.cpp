@@ -7,6 +7,7 @@
 #include "control/Control.h"        // for Control
 #include "control/ScrollHandler.h"  // for ScrollHandler
 #include "model/Document.h"         // for Document
+#include "model/DocumentHandler.h"  // for DocumentHandler
 #include "undo/UndoAction.h"        // for UndoAction
 #include "util/i18n.h"              // for _
 
@@ -49,8 +50,11 @@ void SwapUndoAction::swap(Control* control) {
     doc->deletePage(deletePos);
     doc->insertPage(this->swappedPage, insertPos);
 
-    control->firePageDeleted(deletePos);
-    control->firePageInserted(insertPos);
+    {
+        DocumentHandler::PageBatch batch(control);
+        control->firePageDeleted(deletePos);
+        control->firePageInserted(insertPos);
+    }
     control->firePageSelected(insertPos);
 
     control->getScrollHandler()->scrollToPage(insertPos);
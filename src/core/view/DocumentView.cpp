@@ -20,6 +20,8 @@ void DocumentView::setMarkAudioStroke(bool markAudioStroke) { this->markAudioStr
 
 void DocumentView::setPdfCache(PdfCache* cache) { pdfCache = cache; }
 
+void DocumentView::setRulingCache(xoj::view::RulingTileCache* cache) { rulingCache = cache; }
+
 /**
  * Drawing first step
  * @param page The page to draw
@@ -61,7 +63,7 @@ void DocumentView::finializeDrawing() {
  * Draw the background
  */
 void DocumentView::drawBackground(xoj::view::BackgroundFlags bgFlags) const {
-    auto bgView = xoj::view::BackgroundView::createForPage(page, bgFlags, pdfCache);
+    auto bgView = xoj::view::BackgroundView::createForPage(page, bgFlags, pdfCache, rulingCache);
     bgView->draw(cr);
 }
 
@@ -20,6 +20,7 @@ class PdfCache;
 
 namespace xoj::view {
 struct BackgroundFlags;
+class RulingTileCache;
 };
 
 class DocumentView {
@@ -63,6 +64,11 @@ public:
 public:
     void setPdfCache(PdfCache* cache);
 
+    /**
+     * Paint the periodic part of the rulings from cached tiles. Only for on-screen rendering.
+     */
+    void setRulingCache(xoj::view::RulingTileCache* cache);
+
     /**
      * Drawing first step
      * @param page The page to draw
@@ -90,6 +96,7 @@ private:
     cairo_t* cr = nullptr;
     PageRef page = nullptr;
     PdfCache* pdfCache = nullptr;
+    xoj::view::RulingTileCache* rulingCache = nullptr;
     bool dontRenderEditingStroke = false;
     bool markAudioStroke = false;
 
@@ -0,0 +1,241 @@
+#include "LayerRasterCache.h"
+
+#include <algorithm>  // for find, find_if, any_of
+#include <cmath>      // for ceil, floor
+#include <cstddef>    // for size_t
+
+#include "model/Element.h"                   // for Element, ELEMENT_STROKE
+#include "model/Layer.h"                     // for Layer
+#include "model/Stroke.h"                    // for Stroke, StrokeTool
+#include "model/XojPage.h"                   // for XojPage
+#include "view/background/BackgroundView.h"  // for BackgroundView, BACKGROUND_SHOW_ALL
+
+#include "LayerView.h"  // for LayerView
+#include "View.h"       // for Context, SHOW_CURRENT_EDITING, NORMAL_COLOR
+
+using namespace xoj::view;
+using xoj::util::Rectangle;
+
+/**
+ * Above this number of dirty regions, a stratum is redrawn completely
+ */
+constexpr size_t MAX_DIRTY_RECTS = 16;
+
+/**
+ * Padding of the redrawn regions, in page coordinates (see RenderJob::rerenderRectangle)
+ */
+constexpr double REPAIR_PADDING = 1;
+
+void LayerRasterCache::Stratum::invalidate(const Rectangle<double>& rect) {
+    if (this->fullyDirty) {
+        return;
+    }
+    for (auto& r: this->dirty) {
+        if (r.intersects(rect)) {
+            r.unite(rect);
+            return;
+        }
+    }
+    if (this->dirty.size() >= MAX_DIRTY_RECTS) {
+        invalidateAll();
+        return;
+    }
+    this->dirty.push_back(rect);
+}
+
+void LayerRasterCache::Stratum::invalidateAll() {
+    this->fullyDirty = true;
+    this->dirty.clear();
+}
+
+auto LayerRasterCache::Stratum::contains(const Layer* layer) const -> bool {
+    return std::find(this->layers.begin(), this->layers.end(), layer) != this->layers.end();
+}
+
+void LayerRasterCache::invalidate(const PageRef& page, const Rectangle<double>& rect) {
+    std::lock_guard lock(this->mutex);
+    if (!this->underlay.surface && !this->overlay.surface) {
+        // Nothing cached, the revisions are recorded when the rasters are created
+        return;
+    }
+
+    std::vector<const Layer*> changed;
+    if (!updateSeenRevisions(page, changed)) {
+        // An element was modified in place, its layer is unknown
+        this->underlay.invalidate(rect);
+        this->overlay.invalidate(rect);
+        return;
+    }
+
+    for (const Layer* l: changed) {
+        if (this->underlay.contains(l)) {
+            this->underlay.invalidate(rect);
+        }
+        if (this->overlay.contains(l)) {
+            this->overlay.invalidate(rect);
+        }
+    }
+}
+
+void LayerRasterCache::clear() {
+    std::lock_guard lock(this->mutex);
+    this->underlay = Stratum();
+    this->overlay = Stratum();
+    this->seenRevisions.clear();
+}
+
+auto LayerRasterCache::getSeenRevision(const Layer* layer) const -> uint64_t {
+    auto it = std::find_if(this->seenRevisions.begin(), this->seenRevisions.end(),
+                           [layer](const auto& seen) { return seen.first == layer; });
+    return it == this->seenRevisions.end() ? 0 : it->second;
+}
+
+auto LayerRasterCache::updateSeenRevisions(const PageRef& page, std::vector<const Layer*>& changed) -> bool {
+    std::vector<std::pair<const Layer*, uint64_t>> revisions;
+    for (const Layer* l: *page->getLayers()) {
+        if (getSeenRevision(l) != l->getRevision()) {
+            changed.push_back(l);
+        }
+        revisions.emplace_back(l, l->getRevision());
+    }
+    this->seenRevisions = std::move(revisions);
+    return !changed.empty();
+}
+
+static auto containsHighlighter(const std::vector<const Layer*>& layers) -> bool {
+    return std::any_of(layers.begin(), layers.end(), [](const Layer* l) {
+        const auto& elements = l->getElements();
+        return std::any_of(elements.begin(), elements.end(), [](const Element* e) {
+            return e->getType() == ELEMENT_STROKE &&
+                   static_cast<const Stroke*>(e)->getToolType() == StrokeTool::HIGHLIGHTER;
+        });
+    });
+}
+
+void LayerRasterCache::update(const PageRef& page, double ratio, bool markAudioStroke) {
+    if (ratio != this->ratio || page->getWidth() != this->pageWidth || page->getHeight() != this->pageHeight ||
+        markAudioStroke != this->markAudioStroke) {
+        this->underlay = Stratum();
+        this->overlay = Stratum();
+        this->ratio = ratio;
+        this->pageWidth = page->getWidth();
+        this->pageHeight = page->getHeight();
+        this->markAudioStroke = markAudioStroke;
+    }
+
+    std::vector<const Layer*> below;
+    std::vector<const Layer*> above;
+    const Layer::Index selected = page->getSelectedLayerId();
+    Layer::Index id = 1;  // 0 is the background
+    for (const Layer* l: *page->getLayers()) {
+        if (l->isVisible()) {
+            if (id < selected) {
+                below.push_back(l);
+            } else if (id > selected) {
+                above.push_back(l);
+            }
+        }
+        id++;
+    }
+
+    const bool backgroundVisible = page->isLayerVisible(0);
+    if (this->underlay.backgroundVisible != backgroundVisible) {
+        this->underlay.backgroundVisible = backgroundVisible;
+        this->underlay.invalidateAll();
+    }
+
+    for (auto [stratum, layers]: {std::make_pair(&this->underlay, &below), std::make_pair(&this->overlay, &above)}) {
+        if (stratum->layers != *layers) {
+            stratum->layers = std::move(*layers);
+            stratum->invalidateAll();
+        }
+        // Safety net for changes which were not notified (yet): the layer is redrawn completely
+        for (const Layer* l: stratum->layers) {
+            if (l->getRevision() != getSeenRevision(l)) {
+                stratum->invalidateAll();
+            }
+        }
+    }
+
+    std::vector<const Layer*> changed;
+    updateSeenRevisions(page, changed);
+}
+
+void LayerRasterCache::repair(Stratum& stratum, const PageRef& page, PdfCache* pdfCache,
+                              RulingTileCache* rulingCache) {
+    if (!stratum.surface) {
+        const int width = static_cast<int>(std::ceil(this->pageWidth * this->ratio));
+        const int height = static_cast<int>(std::ceil(this->pageHeight * this->ratio));
+        stratum.surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height), xoj::util::adopt);
+        cairo_surface_set_device_scale(stratum.surface.get(), this->ratio, this->ratio);
+        stratum.invalidateAll();
+    }
+    if (!stratum.fullyDirty && stratum.dirty.empty()) {
+        return;
+    }
+
+    xoj::util::CairoSPtr cr(cairo_create(stratum.surface.get()), xoj::util::adopt);
+    if (!stratum.fullyDirty) {
+        for (const auto& r: stratum.dirty) {
+            // Aligned on the pixels, so that the antialiasing on the border of the region is fully redrawn
+            const double x1 = std::floor((r.x - REPAIR_PADDING) * this->ratio) / this->ratio;
+            const double y1 = std::floor((r.y - REPAIR_PADDING) * this->ratio) / this->ratio;
+            const double x2 = std::ceil((r.x + r.width + REPAIR_PADDING) * this->ratio) / this->ratio;
+            const double y2 = std::ceil((r.y + r.height + REPAIR_PADDING) * this->ratio) / this->ratio;
+            cairo_rectangle(cr.get(), x1, y1, x2 - x1, y2 - y1);
+        }
+        cairo_clip(cr.get());
+    }
+
+    cairo_set_operator(cr.get(), CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr.get());
+    cairo_set_operator(cr.get(), CAIRO_OPERATOR_OVER);
+
+    if (&stratum == &this->underlay) {
+        auto bgView = BackgroundView::createForPage(page, BACKGROUND_SHOW_ALL, pdfCache, rulingCache);
+        bgView->draw(cr.get());
+    }
+
+    Context context{cr.get(), static_cast<NonAudioTreatment>(this->markAudioStroke), SHOW_CURRENT_EDITING,
+                    NORMAL_COLOR};
+    for (const Layer* l: stratum.layers) { LayerView(l).draw(context); }
+
+    stratum.dirty.clear();
+    stratum.fullyDirty = false;
+}
+
+static void paintRaster(cairo_t* cr, cairo_surface_t* raster) {
+    cairo_save(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    cairo_set_source_surface(cr, raster, 0, 0);
+    // The rasters have the resolution of the target and are aligned on its pixels
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_NEAREST);
+    cairo_paint(cr);
+    cairo_restore(cr);
+}
+
+void LayerRasterCache::draw(const PageRef& page, cairo_t* cr, double ratio, PdfCache* pdfCache,
+                            RulingTileCache* rulingCache, bool markAudioStroke) {
+    std::lock_guard lock(this->mutex);
+    update(page, ratio, markAudioStroke);
+
+    repair(this->underlay, page, pdfCache, rulingCache);
+    paintRaster(cr, this->underlay.surface.get());
+
+    Context context{cr, static_cast<NonAudioTreatment>(markAudioStroke), SHOW_CURRENT_EDITING, NORMAL_COLOR};
+    const Layer::Index selected = page->getSelectedLayerId();
+    if (selected > 0 && page->isLayerVisible(selected)) {
+        LayerView(page->getLayers()->at(selected - 1)).draw(context);
+    }
+
+    if (this->overlay.layers.empty()) {
+        this->overlay.surface.reset();
+    } else if (containsHighlighter(this->overlay.layers)) {
+        // The highlighters must be multiplied with the layers below: draw the elements
+        this->overlay.surface.reset();
+        for (const Layer* l: this->overlay.layers) { LayerView(l).draw(context); }
+    } else {
+        repair(this->overlay, page, pdfCache, rulingCache);
+        paintRaster(cr, this->overlay.surface.get());
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ * Xournal++
+ *
+ * Cached rasters of the layers of a page which are not edited
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>  // for uint64_t
+#include <mutex>    // for mutex
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+#include <cairo.h>  // for cairo_t
+
+#include "model/PageRef.h"            // for PageRef
+#include "util/Rectangle.h"           // for Rectangle
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+class Layer;
+class PdfCache;
+
+namespace xoj::view {
+class RulingTileCache;
+
+/**
+ * @brief Rasters of a page at the zoom of its view, used to rerender a region without redrawing the layers which are
+ * not being edited.
+ *
+ * The page is split in three strata around the selected layer:
+ *  - the underlay: the background and the visible layers below the selected layer,
+ *  - the selected layer, which is always drawn from its elements,
+ *  - the overlay: the visible layers above the selected layer.
+ * The underlay is opaque and contains the background, so that the highlighters of the lower layers are multiplied with
+ * the background as usual. For the same reason, the overlay is only cached if it contains no highlighter stroke.
+ *
+ * The rasters are invalidated region-wise by the page notifications (see invalidate()). A notification is attributed
+ * to the layers whose revision changed since the previous one. If none did (i.e. an element was modified in place),
+ * the region is invalidated in all the strata.
+ *
+ * invalidate() and clear() are called from the main thread, draw() from the scheduler thread.
+ */
+class LayerRasterCache {
+public:
+    LayerRasterCache() = default;
+    LayerRasterCache(const LayerRasterCache&) = delete;
+    LayerRasterCache& operator=(const LayerRasterCache&) = delete;
+    ~LayerRasterCache() = default;
+
+public:
+    /**
+     * Invalidates a region of the page, in page coordinates. Must be called for every change of the page content.
+     */
+    void invalidate(const PageRef& page, const xoj::util::Rectangle<double>& rect);
+
+    /**
+     * Drops all the rasters
+     */
+    void clear();
+
+    /**
+     * Draws the page like DocumentView::drawPage() does, within the clip region of cr. The invalid parts of the rasters
+     * are redrawn first. The document must be locked.
+     * @param cr Context in page coordinates
+     * @param ratio Scale between the page coordinates and the device pixels, i.e. zoom times DPI scaling
+     */
+    void draw(const PageRef& page, cairo_t* cr, double ratio, PdfCache* pdfCache, RulingTileCache* rulingCache,
+              bool markAudioStroke);
+
+private:
+    struct Stratum {
+        xoj::util::CairoSurfaceSPtr surface;
+
+        /**
+         * The visible layers drawn in this stratum, from bottom to top
+         */
+        std::vector<const Layer*> layers;
+        bool backgroundVisible = false;  ///< Only used by the underlay
+
+        /**
+         * Regions to redraw, in page coordinates
+         */
+        std::vector<xoj::util::Rectangle<double>> dirty;
+        bool fullyDirty = true;
+
+        void invalidate(const xoj::util::Rectangle<double>& rect);
+        void invalidateAll();
+        bool contains(const Layer* layer) const;
+    };
+
+    /**
+     * Assigns the layers of the page to the strata, invalidating the strata whose content changed
+     */
+    void update(const PageRef& page, double ratio, bool markAudioStroke);
+
+    /**
+     * Redraws the dirty regions of a stratum
+     */
+    void repair(Stratum& stratum, const PageRef& page, PdfCache* pdfCache, RulingTileCache* rulingCache);
+
+    /**
+     * @return The revision of the layer as seen by the last notification, or 0
+     */
+    uint64_t getSeenRevision(const Layer* layer) const;
+
+    /**
+     * Records the current revisions of the layers of the page
+     * @return true if any layer was added or changed since the last call
+     */
+    bool updateSeenRevisions(const PageRef& page, std::vector<const Layer*>& changed);
+
+private:
+    std::mutex mutex;
+
+    Stratum underlay;
+    Stratum overlay;
+
+    std::vector<std::pair<const Layer*, uint64_t>> seenRevisions;
+
+    double ratio = 0;
+    double pageWidth = 0;
+    double pageHeight = 0;
+    bool markAudioStroke = false;
+};
+};  // namespace xoj::view
@@ -6,10 +6,12 @@
 #include <cairo.h>  // for cairo_clip_extents, cairo_rectangle
 #include <glib.h>   // for g_message
 
-#include "model/Element.h"  // for Element
+#include "model/Element.h"  // for Element, ELEMENT_STROKE
 #include "model/Layer.h"    // for Layer
+#include "model/Stroke.h"   // for Stroke
 
 #include "DebugShowRepaintBounds.h"  // for IF_DEBUG_REPAINT
+#include "StrokeMaskBatch.h"         // for StrokeMaskBatch
 #include "View.h"                    // for Context, ElementView
 
 using namespace xoj::view;
@@ -28,6 +30,9 @@ void LayerView::draw(const Context& ctx) const {
     double maxY;
     cairo_clip_extents(ctx.cr, &minX, &minY, &maxX, &maxY);
 
+    // Consecutive translucent strokes share their masks
+    StrokeMaskBatch maskBatch(ctx);
+
     for (auto& e: layer->getElements()) {
 
         IF_DEBUG_REPAINT({
@@ -40,10 +45,15 @@ void LayerView::draw(const Context& ctx) const {
         });
 
         if (e->intersectsArea(minX, minY, maxX - minX, maxY - minY)) {
-            ElementView::createFromElement(e)->draw(ctx);
+            if (e->getType() != ELEMENT_STROKE || !maskBatch.add(dynamic_cast<const Stroke*>(e))) {
+                // Keep the painting order
+                maskBatch.flush();
+                ElementView::createFromElement(e)->draw(ctx);
+            }
             IF_DEBUG_REPAINT(drawn++;);
         }
         IF_DEBUG_REPAINT(else { notDrawn++; });
     }
+    maskBatch.flush();
     IF_DEBUG_REPAINT(g_message("DBG:LayerView::draw: draw %i / not draw %i", drawn, notDrawn););
 }
@@ -0,0 +1,90 @@
+#include "ResolutionPyramid.h"
+
+#include <algorithm>  // for min
+#include <cmath>      // for ceil, floor
+#include <cstddef>    // for size_t
+#include <utility>    // for move
+
+using namespace xoj::view;
+using xoj::util::Rectangle;
+
+/**
+ * Number of levels below the buffer, i.e. the lowest level has 1/16 of the resolution of the buffer
+ */
+constexpr size_t MAX_LEVELS = 4;
+
+/**
+ * Levels smaller than this, in pixels, are not worth it
+ */
+constexpr int MIN_LEVEL_SIZE = 32;
+
+static auto getScale(cairo_surface_t* surface) -> double {
+    double scaleX = 1;
+    double scaleY = 1;
+    cairo_surface_get_device_scale(surface, &scaleX, &scaleY);
+    return scaleX;
+}
+
+/**
+ * Downscales a region of `source` onto `level`
+ * @param rect The region in page coordinates, or nullptr for the whole surface
+ */
+static void downscale(cairo_surface_t* source, cairo_surface_t* level, const Rectangle<double>* rect) {
+    xoj::util::CairoSPtr cr(cairo_create(level), xoj::util::adopt);
+    if (rect) {
+        // Aligned on the pixels of the level, with a padding of one pixel for the filter
+        const double scale = getScale(level);
+        const double x1 = std::floor(rect->x * scale - 1) / scale;
+        const double y1 = std::floor(rect->y * scale - 1) / scale;
+        const double x2 = std::ceil((rect->x + rect->width) * scale + 1) / scale;
+        const double y2 = std::ceil((rect->y + rect->height) * scale + 1) / scale;
+        cairo_rectangle(cr.get(), x1, y1, x2 - x1, y2 - y1);
+        cairo_clip(cr.get());
+    }
+    cairo_set_operator(cr.get(), CAIRO_OPERATOR_SOURCE);
+    // Both surfaces have their device scale: the source is placed in page coordinates
+    cairo_set_source_surface(cr.get(), source, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr.get()), CAIRO_FILTER_GOOD);
+    cairo_paint(cr.get());
+}
+
+void ResolutionPyramid::rebuild(cairo_surface_t* buffer) {
+    this->levels.clear();
+
+    cairo_surface_t* source = buffer;
+    while (this->levels.size() < MAX_LEVELS) {
+        const int width = (cairo_image_surface_get_width(source) + 1) / 2;
+        const int height = (cairo_image_surface_get_height(source) + 1) / 2;
+        if (std::min(width, height) < MIN_LEVEL_SIZE) {
+            break;
+        }
+
+        xoj::util::CairoSurfaceSPtr level(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+                                          xoj::util::adopt);
+        const double scale = getScale(source) / 2;
+        cairo_surface_set_device_scale(level.get(), scale, scale);
+        downscale(source, level.get(), nullptr);
+
+        source = level.get();
+        this->levels.push_back(std::move(level));
+    }
+}
+
+void ResolutionPyramid::update(cairo_surface_t* buffer, const Rectangle<double>& rect) {
+    cairo_surface_t* source = buffer;
+    for (auto& level: this->levels) {
+        downscale(source, level.get(), &rect);
+        source = level.get();
+    }
+}
+
+void ResolutionPyramid::clear() { this->levels.clear(); }
+
+auto ResolutionPyramid::getLevel(double ratio) const -> cairo_surface_t* {
+    for (auto it = this->levels.rbegin(); it != this->levels.rend(); ++it) {
+        if (getScale(it->get()) >= ratio) {
+            return it->get();
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,71 @@
+/*
+ * Xournal++
+ *
+ * Downscaled copies of a page buffer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <vector>  // for vector
+
+#include <cairo.h>  // for cairo_surface_t
+
+#include "util/Rectangle.h"           // for Rectangle
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+namespace xoj::view {
+
+/**
+ * @brief Copies of a page buffer at half, a quarter, ... of its resolution.
+ *
+ * While zooming out, the page is painted from the level closest to the new zoom until it is rendered again: a smaller
+ * source is faster to paint and does not alias like a buffer shrunk by a large factor.
+ *
+ * The levels are derived from the buffer, never rendered: they must be updated whenever the buffer changes. This class
+ * is not thread safe: it is guarded by the same mutex as the buffer.
+ */
+class ResolutionPyramid {
+public:
+    ResolutionPyramid() = default;
+    ResolutionPyramid(const ResolutionPyramid&) = delete;
+    ResolutionPyramid& operator=(const ResolutionPyramid&) = delete;
+    ResolutionPyramid(ResolutionPyramid&&) = default;
+    ResolutionPyramid& operator=(ResolutionPyramid&&) = default;
+    ~ResolutionPyramid() = default;
+
+public:
+    /**
+     * Replaces the levels by downscaled copies of the buffer
+     * @param buffer Page buffer, whose device scale is its number of pixels per page coordinate unit
+     */
+    void rebuild(cairo_surface_t* buffer);
+
+    /**
+     * Updates the levels after a region of the buffer was redrawn
+     * @param rect The region, in page coordinates
+     */
+    void update(cairo_surface_t* buffer, const xoj::util::Rectangle<double>& rect);
+
+    /**
+     * Drops all the levels
+     */
+    void clear();
+
+    /**
+     * @return The level with the lowest resolution which still has at least `ratio` pixels per page coordinate unit,
+     * or nullptr if no level has enough pixels
+     */
+    cairo_surface_t* getLevel(double ratio) const;
+
+private:
+    /**
+     * From the highest resolution to the lowest. Each level has half the resolution of the previous one.
+     */
+    std::vector<xoj::util::CairoSurfaceSPtr> levels;
+};
+};  // namespace xoj::view
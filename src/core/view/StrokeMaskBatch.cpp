@@ -0,0 +1,171 @@
+#include "StrokeMaskBatch.h"
+
+#include <algorithm>  // for min, max, none_of, fill
+#include <cassert>    // for assert
+#include <cmath>      // for floor, ceil
+#include <cstddef>    // for size_t, ptrdiff_t
+
+#include <cairo.h>  // for cairo_t, cairo_surface_t, ...
+
+#include "model/Stroke.h"    // for Stroke
+#include "util/Color.h"      // for cairo_set_source_rgbi
+#include "util/Rectangle.h"  // for Rectangle
+
+#include "config-debug.h"  // for DEBUG_SHOW_MASK
+
+using xoj::util::Rectangle;
+using namespace xoj::view;
+
+/**
+ * Maximal number of strokes in a batch, to bound the cost of the overlap test
+ */
+constexpr size_t MAX_BATCH_SIZE = 64;
+
+/**
+ * The extent of a batch may exceed the area of its strokes by this factor (plus MASK_AREA_SLACK) before a new batch is
+ * started, so that blitting sparse strokes does not composite much more pixels than blitting them one by one.
+ */
+constexpr int64_t MAX_AREA_FACTOR = 4;
+constexpr int64_t MASK_AREA_SLACK = 256 * 256;
+
+auto StrokeMaskBatch::PixelBox::intersects(const PixelBox& other) const -> bool {
+    return minX < other.maxX && other.minX < maxX && minY < other.maxY && other.minY < maxY;
+}
+
+auto StrokeMaskBatch::PixelBox::area() const -> int64_t {
+    return static_cast<int64_t>(maxX - minX) * static_cast<int64_t>(maxY - minY);
+}
+
+StrokeMaskBatch::StrokeMaskBatch(const Context& ctx): ctx(ctx) {
+    /**
+     * The mask needs to have to right resolution: the number of pixels per page coordinate units.
+     *
+     * This value can be recovered from the given canvas: the mask must have the exact same resolution as the canvas
+     * This resolution combines both the surface scale and the transformation matrix zoom ratio.
+     */
+    cairo_surface_get_device_scale(cairo_get_target(ctx.cr), &scaleX, &scaleY);
+
+    {  // Multiply the scale using the transformation matrix
+        cairo_matrix_t matrix;
+        cairo_get_matrix(ctx.cr, &matrix);
+        // We assume the matrix is diagonal (i.e. only scaling, no rotation)
+        assert(matrix.xy == 0 && matrix.yx == 0);
+
+        scaleX *= matrix.xx;
+        scaleY *= matrix.yy;
+    }
+}
+
+StrokeMaskBatch::~StrokeMaskBatch() { assert(strokes.empty() && "StrokeMaskBatch destroyed without flush()"); }
+
+auto StrokeMaskBatch::canMerge(const StrokeView::MaskBlend& blend, const PixelBox& box) const -> bool {
+    if (strokes.empty()) {
+        return true;
+    }
+    if (strokes.size() >= MAX_BATCH_SIZE || blend != this->blend) {
+        return false;
+    }
+
+    PixelBox united{std::min(extent.minX, box.minX), std::min(extent.minY, box.minY), std::max(extent.maxX, box.maxX),
+                    std::max(extent.maxY, box.maxY)};
+    if (united.area() > MAX_AREA_FACTOR * (strokesArea + box.area()) + MASK_AREA_SLACK) {
+        return false;
+    }
+
+    // A shared pixel would be blitted once instead of twice, changing the result where the strokes overlap
+    return std::none_of(strokes.begin(), strokes.end(), [&box](const auto& s) { return s.second.intersects(box); });
+}
+
+auto StrokeMaskBatch::add(const Stroke* s) -> bool {
+    StrokeView view(s);
+    if (!view.usesMask(ctx)) {
+        return false;
+    }
+
+    // Use integral offsets to avoid unnecessary antialiasing upon blitting the mask
+    Rectangle<double> rect = s->boundingRect();
+    PixelBox box{static_cast<int>(std::floor(rect.x * scaleX)), static_cast<int>(std::floor(rect.y * scaleY)),
+                 static_cast<int>(std::ceil((rect.x + rect.width) * scaleX)),
+                 static_cast<int>(std::ceil((rect.y + rect.height) * scaleY))};
+    if (box.maxX <= box.minX || box.maxY <= box.minY) {
+        // Nothing to paint
+        return true;
+    }
+
+    StrokeView::MaskBlend strokeBlend = view.getMaskBlend(ctx);
+    if (!canMerge(strokeBlend, box)) {
+        flush();
+    }
+
+    if (strokes.empty()) {
+        this->blend = strokeBlend;
+        this->extent = box;
+        this->strokesArea = 0;
+    } else {
+        extent = {std::min(extent.minX, box.minX), std::min(extent.minY, box.minY), std::max(extent.maxX, box.maxX),
+                  std::max(extent.maxY, box.maxY)};
+    }
+    strokesArea += box.area();
+    strokes.emplace_back(s, box);
+    return true;
+}
+
+void StrokeMaskBatch::flush() {
+    if (strokes.empty()) {
+        return;
+    }
+
+    const int width = extent.maxX - extent.minX;
+    const int height = extent.maxY - extent.minY;
+
+    cairo_surface_t* surfMask = nullptr;
+    if (cairo_surface_get_type(cairo_get_target(ctx.cr)) == CAIRO_SURFACE_TYPE_IMAGE) {
+        // Raster targets blit the mask immediately: its pixels can be reused for the next batch
+        const int stride = cairo_format_stride_for_width(CAIRO_FORMAT_A8, width);
+        const size_t size = static_cast<size_t>(stride) * static_cast<size_t>(height);
+        if (maskData.size() < size) {
+            maskData.assign(size, 0);
+        } else {
+            std::fill(maskData.begin(), maskData.begin() + static_cast<std::ptrdiff_t>(size), 0);
+        }
+        surfMask = cairo_image_surface_create_for_data(maskData.data(), CAIRO_FORMAT_A8, width, height, stride);
+    } else {
+        // Vector targets (e.g. PDF export) may keep a reference to the mask
+        surfMask = cairo_image_surface_create(CAIRO_FORMAT_A8, width, height);
+    }
+
+    // Apply offset and scaling
+    cairo_surface_set_device_offset(surfMask, -extent.minX, -extent.minY);
+    cairo_surface_set_device_scale(surfMask, scaleX, scaleY);
+
+    // Get a context to draw on our mask
+    cairo_t* cr = cairo_create(surfMask);
+
+#ifdef DEBUG_SHOW_MASK
+    cairo_set_source_rgba(cr, 1, 1, 1, 0.3);
+    cairo_paint(cr);
+#endif
+
+    for (const auto& [s, box]: strokes) {
+        cairo_save(cr);
+        // Each stroke only paints in its own pixels, as it did on a mask of its own
+        cairo_rectangle(cr, box.minX / scaleX, box.minY / scaleY, (box.maxX - box.minX) / scaleX,
+                        (box.maxY - box.minY) / scaleY);
+        cairo_clip(cr);
+        StrokeView(s).drawMask(cr, ctx);
+        cairo_restore(cr);
+    }
+    cairo_destroy(cr);
+
+    /**
+     * Blit the mask onto the target cairo context.
+     */
+    cairo_save(ctx.cr);
+    cairo_set_operator(ctx.cr, blend.multiply ? CAIRO_OPERATOR_MULTIPLY : CAIRO_OPERATOR_OVER);
+    Util::cairo_set_source_rgbi(ctx.cr, blend.color, blend.alpha);
+    cairo_mask_surface(ctx.cr, surfMask, 0, 0);
+    cairo_restore(ctx.cr);
+
+    cairo_surface_destroy(surfMask);
+    strokes.clear();
+}
@@ -0,0 +1,90 @@
+/*
+ * Xournal++
+ *
+ * Paints consecutive translucent strokes through a shared mask
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>  // for int64_t
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+#include "StrokeView.h"  // for StrokeView
+#include "View.h"        // for Context
+
+class Stroke;
+
+namespace xoj::view {
+
+/**
+ * @brief Paints strokes which use a mask (filled highlighters and strokes faded out for audio playback, see
+ * StrokeView::usesMask()) with one mask and one blit per batch, instead of one per stroke.
+ *
+ * Consecutive strokes are batched together if they are blitted with the same color, opacity and operator, and if
+ * their masks do not share any pixel. Every pixel of the mask thus belongs to a single stroke and the result is exactly
+ * the same as blitting the masks one by one: in particular, overlapping translucent strokes still darken each other.
+ *
+ * Usage: call add() for each stroke, in painting order. If it returns false, call flush() and paint the stroke
+ * directly. Call flush() once all the strokes are added.
+ */
+class StrokeMaskBatch {
+public:
+    explicit StrokeMaskBatch(const Context& ctx);
+    StrokeMaskBatch(const StrokeMaskBatch&) = delete;
+    StrokeMaskBatch& operator=(const StrokeMaskBatch&) = delete;
+    ~StrokeMaskBatch();
+
+public:
+    /**
+     * Adds a stroke to the batch. The batch is flushed first if the stroke cannot be merged with it.
+     * @return false if the stroke does not use a mask. Nothing is done in this case.
+     */
+    bool add(const Stroke* s);
+
+    /**
+     * Paints the strokes of the batch onto the target
+     */
+    void flush();
+
+private:
+    /**
+     * Extent of the mask of a stroke, in pixels
+     */
+    struct PixelBox {
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+
+        bool intersects(const PixelBox& other) const;
+        int64_t area() const;
+    };
+
+    bool canMerge(const StrokeView::MaskBlend& blend, const PixelBox& box) const;
+
+private:
+    Context ctx;
+
+    /**
+     * Pixels per page coordinate units on the target
+     */
+    double scaleX = 1;
+    double scaleY = 1;
+
+    std::vector<std::pair<const Stroke*, PixelBox>> strokes;
+    StrokeView::MaskBlend blend{};
+    PixelBox extent{};
+    int64_t strokesArea = 0;
+
+    /**
+     * Pixels of the mask, reused from one batch to the next on raster targets
+     */
+    std::vector<unsigned char> maskData;
+};
+};  // namespace xoj::view
@@ -13,6 +13,8 @@
 
 #include <cairo.h>  // for cairo_t, CAIRO_LINE_CAP_BUTT, CAIRO_LINE_CAP_ROUND
 
+#include "util/Color.h"  // for Color
+
 #include "View.h"  // for ElementView
 
 class Stroke;
@@ -32,6 +34,43 @@ public:
      */
     void draw(const Context& ctx) const override;
 
+    /**
+     * @brief How the mask of a stroke is blitted onto the target
+     */
+    struct MaskBlend {
+        Color color;
+        double alpha;
+        bool multiply;
+
+        bool operator==(const MaskBlend& other) const {
+            return color == other.color && alpha == other.alpha && multiply == other.multiply;
+        }
+        bool operator!=(const MaskBlend& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @return true if the stroke is painted without colors to a mask which is then blitted (see StrokeMaskBatch)
+     */
+    bool usesMask(const Context& ctx) const;
+
+    /**
+     * @brief Paint the stroke onto a mask: only the alpha values are painted. Requires usesMask(ctx).
+     */
+    void drawMask(cairo_t* maskCr, const Context& ctx) const;
+
+    /**
+     * @return The color, opacity and operator with which the mask must be blitted. Requires usesMask(ctx).
+     */
+    MaskBlend getMaskBlend(const Context& ctx) const;
+
+private:
+    /**
+     * @brief Paint the stroke's filling and line
+     * @param noColor If true, only the alpha values are painted
+     * @param useMask If true, cr is a mask created for this stroke
+     */
+    void paint(cairo_t* cr, bool noColor, bool useMask, bool showCurrentEdition) const;
+
 private:
     const Stroke* s;
 
@@ -0,0 +1,69 @@
+#include "TextLayoutCache.h"
+
+#include <algorithm>  // for rotate
+#include <cstddef>    // for size_t
+#include <string>     // for string
+#include <utility>    // for move
+
+#include "model/Text.h"  // for Text
+
+#include "TextView.h"  // for TextView
+
+using namespace xoj::view;
+
+/**
+ * Typically one layout for the main thread, one for the rendering thread and one for the exports
+ */
+constexpr size_t MAX_ENTRIES = 4;
+
+thread_local bool TextLayoutCache::disabledOnThisThread = false;
+
+void TextLayoutCache::disableOnThisThread() { disabledOnThisThread = true; }
+
+auto TextLayoutCache::createLayout(cairo_t* cr, const Text* t) -> PangoLayout* {
+    PangoLayout* layout = TextView::initPango(cr, t);
+    std::string content = t->getText();
+    pango_layout_set_text(layout, content.c_str(), static_cast<int>(content.length()));
+    return layout;
+}
+
+auto TextLayoutCache::getLayout(cairo_t* cr, const Text* t) -> PangoLayout* {
+    // Same font options as the ones pango_cairo_update_layout() gives to the layout
+    std::unique_ptr<cairo_font_options_t, FontOptionsDeleter> options(cairo_font_options_create());
+    cairo_surface_get_font_options(cairo_get_target(cr), options.get());
+    {
+        std::unique_ptr<cairo_font_options_t, FontOptionsDeleter> crOptions(cairo_font_options_create());
+        cairo_get_font_options(cr, crOptions.get());
+        cairo_font_options_merge(options.get(), crOptions.get());
+    }
+
+    // The font map used by pango_cairo_create_layout() in TextView::initPango(), one per thread
+    PangoFontMap* fontMap = pango_cairo_font_map_get_default();
+
+    for (auto it = this->entries.begin(); it != this->entries.end(); ++it) {
+        if (it->fontMap == fontMap && cairo_font_options_equal(it->fontOptions.get(), options.get())) {
+            if (it->textRevision != t->getTextRevision() || it->fontName != t->getFontName() ||
+                it->fontSize != t->getFontSize()) {
+                // Outdated, the text or its font changed
+                this->entries.erase(it);
+                break;
+            }
+            std::rotate(this->entries.begin(), it, it + 1);
+            return this->entries.front().layout.get();
+        }
+    }
+
+    Entry entry;
+    entry.layout.reset(createLayout(cr, t), xoj::util::adopt);
+    entry.fontMap = fontMap;
+    entry.fontOptions = std::move(options);
+    entry.textRevision = t->getTextRevision();
+    entry.fontName = t->getFontName();
+    entry.fontSize = t->getFontSize();
+
+    if (this->entries.size() >= MAX_ENTRIES) {
+        this->entries.pop_back();
+    }
+    this->entries.insert(this->entries.begin(), std::move(entry));
+    return this->entries.front().layout.get();
+}
@@ -0,0 +1,99 @@
+/*
+ * Xournal++
+ *
+ * Shaped Pango layouts of a text element
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>  // for uint64_t
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex, lock_guard
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <pango/pangocairo.h>  // for PangoLayout, PangoFontMap, cairo_t, cairo_font_options_t
+
+#include "util/raii/GObjectSPtr.h"  // for GObjectSPtr
+
+class Text;
+
+namespace xoj::view {
+
+/**
+ * @brief The PangoLayout of a Text element, shaped once and shared by the drawing, the size computation and the search.
+ *
+ * A layout is reused as long as the text, its font and the font options of the target do not change. The font options
+ * differ between the screen and the vector exports, so a layout is kept for each of the last few.
+ *
+ * The text is measured on the main thread and drawn on the rendering and export threads. The fonts of a layout belong
+ * to the default font map of the thread which created it, and are not thread-safe: a layout is only reused with the
+ * same font map, i.e. on the same thread, and only handed out within withLayout(). The short-lived threads of the
+ * parallel exports do not cache their layouts (see disableOnThisThread()).
+ */
+class TextLayoutCache {
+public:
+    TextLayoutCache() = default;
+    TextLayoutCache(const TextLayoutCache&) = delete;
+    TextLayoutCache& operator=(const TextLayoutCache&) = delete;
+    ~TextLayoutCache() = default;
+
+public:
+    /**
+     * Calls fn(layout) with the layout of the text, shaped for the font options of cr. The layout must neither be
+     * modified nor kept after fn returns.
+     */
+    template <class Fn>
+    void withLayout(cairo_t* cr, const Text* t, Fn&& fn) {
+        if (disabledOnThisThread) {
+            xoj::util::GObjectSPtr<PangoLayout> layout(createLayout(cr, t), xoj::util::adopt);
+            fn(layout.get());
+            return;
+        }
+        std::lock_guard lock(this->mutex);
+        fn(getLayout(cr, t));
+    }
+
+    /**
+     * Stops caching the layouts created on the calling thread, which must not outlive the export it works for: the
+     * cached layouts would keep the font map of the thread alive after it exits.
+     */
+    static void disableOnThisThread();
+
+private:
+    PangoLayout* getLayout(cairo_t* cr, const Text* t);
+
+    /**
+     * @return A new layout of the text, shaped for the font options of cr
+     */
+    static PangoLayout* createLayout(cairo_t* cr, const Text* t);
+
+    static thread_local bool disabledOnThisThread;
+
+    struct FontOptionsDeleter {
+        void operator()(cairo_font_options_t* options) const { cairo_font_options_destroy(options); }
+    };
+
+    struct Entry {
+        xoj::util::GObjectSPtr<PangoLayout> layout;
+        /// Kept alive by the context of the layout
+        PangoFontMap* fontMap = nullptr;
+        std::unique_ptr<cairo_font_options_t, FontOptionsDeleter> fontOptions;
+        uint64_t textRevision = 0;
+        std::string fontName;
+        double fontSize = 0;
+    };
+
+    std::mutex mutex;
+
+    /**
+     * Most recently used first
+     */
+    std::vector<Entry> entries;
+};
+};  // namespace xoj::view
@@ -3,13 +3,12 @@
 #include <algorithm>  // for max
 #include <cstddef>    // for size_t
 
-#include <glib-object.h>  // for g_object_unref
-
-#include "model/Text.h"           // for Text
-#include "pdf/base/XojPdfPage.h"  // for XojPdfRectangle
-#include "util/Color.h"           // for cairo_set_source_rgbi
-#include "util/StringUtils.h"     // for StringUtils
-#include "view/View.h"            // for Context, OPACITY_NO_AUDIO, view
+#include "model/Text.h"            // for Text
+#include "pdf/base/XojPdfPage.h"   // for XojPdfRectangle
+#include "util/Color.h"            // for cairo_set_source_rgbi
+#include "util/StringUtils.h"      // for StringUtils
+#include "view/TextLayoutCache.h"  // for TextLayoutCache
+#include "view/View.h"             // for Context, OPACITY_NO_AUDIO, view
 
 #include "filesystem.h"  // for path
 
@@ -64,13 +63,8 @@ void TextView::draw(const Context& ctx) const {
 
     cairo_translate(ctx.cr, text->getX(), text->getY());
 
-    PangoLayout* layout = initPango(ctx.cr, text);
-    std::string content = text->getText();
-    pango_layout_set_text(layout, content.c_str(), static_cast<int>(content.length()));
-
-    pango_cairo_show_layout(ctx.cr, layout);
-
-    g_object_unref(layout);
+    text->getLayoutCache().withLayout(ctx.cr, text,
+                                      [cr = ctx.cr](PangoLayout* layout) { pango_cairo_show_layout(cr, layout); });
 
     cairo_restore(ctx.cr);
 }
@@ -84,32 +78,28 @@ auto TextView::findText(const Text* t, const std::string& search) -> std::vector
     cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
     cairo_t* cr = cairo_create(surface);
 
-    PangoLayout* layout = initPango(cr, t);
-    std::string content = t->getText();
-    pango_layout_set_text(layout, content.c_str(), static_cast<int>(content.length()));
-
-
-    std::string text = StringUtils::toLowerCase(content);
+    std::string text = StringUtils::toLowerCase(t->getText());
 
     std::string pattern = StringUtils::toLowerCase(search);
 
     std::vector<XojPdfRectangle> list;
 
-    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
-        XojPdfRectangle mark;
-        PangoRectangle rect = {0};
-        pango_layout_index_to_pos(layout, static_cast<int>(pos), &rect);
-        mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + t->getX();
-        mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + t->getY();
+    t->getLayoutCache().withLayout(cr, t, [&](PangoLayout* layout) {
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+            XojPdfRectangle mark;
+            PangoRectangle rect = {0};
+            pango_layout_index_to_pos(layout, static_cast<int>(pos), &rect);
+            mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + t->getX();
+            mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + t->getY();
 
-        pango_layout_index_to_pos(layout, static_cast<int>(pos + patternLength - 1), &rect);
-        mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + t->getX();
-        mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + t->getY();
+            pango_layout_index_to_pos(layout, static_cast<int>(pos + patternLength - 1), &rect);
+            mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + t->getX();
+            mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + t->getY();
 
-        list.push_back(mark);
-    }
+            list.push_back(mark);
+        }
+    });
 
-    g_object_unref(layout);
     cairo_surface_destroy(surface);
     cairo_destroy(cr);
 
@@ -120,15 +110,11 @@ void TextView::calcSize(const Text* t, double& width, double& height) {
     cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
     cairo_t* cr = cairo_create(surface);
 
-    PangoLayout* layout = initPango(cr, t);
-    std::string content = t->getText();
-    pango_layout_set_text(layout, content.c_str(), static_cast<int>(content.length()));
     int w = 0;
     int h = 0;
-    pango_layout_get_size(layout, &w, &h);
+    t->getLayoutCache().withLayout(cr, t, [&](PangoLayout* layout) { pango_layout_get_size(layout, &w, &h); });
     width = (static_cast<double>(w)) / PANGO_SCALE;
     height = (static_cast<double>(h)) / PANGO_SCALE;
-    g_object_unref(layout);
 
     cairo_destroy(cr);
     cairo_surface_destroy(surface);
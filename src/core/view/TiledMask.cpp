@@ -0,0 +1,89 @@
+#include "TiledMask.h"
+
+#include <cassert>
+#include <cmath>
+
+#include <cairo.h>
+
+#include "util/Range.h"
+
+using namespace xoj::view;
+
+/**
+ * Size of the tiles, in device space coordinates (i.e. before DPI scaling)
+ */
+constexpr int TILE_SIZE = 256;
+
+TiledMask::TiledMask(cairo_surface_t* target, double zoom, int dpiScaling): zoom(zoom), dpiScaling(dpiScaling) {
+    assert(target);
+    assert(zoom > 0.0);
+    assert(dpiScaling > 0);
+    this->model.reset(cairo_surface_create_similar(target, CAIRO_CONTENT_ALPHA, 1, 1), xoj::util::adopt);
+}
+
+bool TiledMask::isInitialized() const { return model; }
+
+auto TiledMask::getTile(int col, int row) -> cairo_t* {
+    auto& tile = this->tiles[{col, row}];
+    if (!tile) {
+        cairo_surface_t* surf =
+                cairo_surface_create_similar(this->model.get(), CAIRO_CONTENT_ALPHA, TILE_SIZE, TILE_SIZE);
+        cairo_surface_set_device_offset(surf, -col * TILE_SIZE * this->dpiScaling, -row * TILE_SIZE * this->dpiScaling);
+        cairo_surface_set_device_scale(surf, this->zoom * this->dpiScaling, this->zoom * this->dpiScaling);
+
+        tile.reset(cairo_create(surf), xoj::util::adopt);
+        cairo_surface_destroy(surf);  // surf is now owned by tile
+
+        cairo_t* cr = tile.get();
+        cairo_set_source_rgba(cr, 1, 1, 1, 1);
+        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+        cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
+        cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+    }
+    return tile.get();
+}
+
+void TiledMask::drawOn(const Range& rg, const std::function<void(cairo_t*)>& draw) {
+    assert(isInitialized());
+    if (!rg.isValid()) {
+        return;
+    }
+    const double scale = this->zoom / TILE_SIZE;
+    const int minCol = static_cast<int>(std::floor(rg.minX * scale));
+    const int maxCol = static_cast<int>(std::floor(rg.maxX * scale));
+    const int minRow = static_cast<int>(std::floor(rg.minY * scale));
+    const int maxRow = static_cast<int>(std::floor(rg.maxY * scale));
+
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int col = minCol; col <= maxCol; col++) { draw(getTile(col, row)); }
+    }
+}
+
+void TiledMask::blitTo(cairo_t* targetCr) const {
+    assert(isInitialized());
+    double x1 = 0;
+    double y1 = 0;
+    double x2 = 0;
+    double y2 = 0;
+    cairo_clip_extents(targetCr, &x1, &y1, &x2, &y2);
+
+    const double scale = this->zoom / TILE_SIZE;
+    const int minCol = static_cast<int>(std::floor(x1 * scale));
+    const int maxCol = static_cast<int>(std::floor(x2 * scale));
+    const int minRow = static_cast<int>(std::floor(y1 * scale));
+    const int maxRow = static_cast<int>(std::floor(y2 * scale));
+
+    for (auto& [pos, tile]: this->tiles) {
+        auto [col, row] = pos;
+        if (col >= minCol && col <= maxCol && row >= minRow && row <= maxRow) {
+            cairo_mask_surface(targetCr, cairo_get_target(tile.get()), 0.0, 0.0);
+        }
+    }
+}
+
+void TiledMask::wipe() { this->tiles.clear(); }
+
+void TiledMask::reset() {
+    this->tiles.clear();
+    this->model.reset();
+}
@@ -0,0 +1,84 @@
+/*
+ * Xournal++
+ *
+ * A mask split in tiles, allocated where something is drawn
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <utility>
+
+#include <cairo.h>
+
+#include "util/raii/CairoWrappers.h"
+
+class Range;
+
+namespace xoj::view {
+
+/**
+ * @brief A mask made of square tiles, which are only created where something is drawn.
+ *
+ * Unlike Mask, which covers a whole area from the start, the memory used only depends on the extent of what is drawn.
+ * Blitting only involves the tiles intersecting the clip of the target, i.e. the region being repainted.
+ */
+class TiledMask {
+public:
+    TiledMask() = default;
+    /**
+     * @brief Create an empty mask tailored for the specified target
+     * @param target A cairo surface similar to that on which the mask will be used
+     * @param zoom The local zoom ratio (zoom ratio of the cairo context(s) on which the mask will be used).
+     * @param DPIScaling The targeted screen DPI scaling
+     */
+    TiledMask(cairo_surface_t* target, double zoom, int DPIScaling);
+
+    bool isInitialized() const;
+
+    /**
+     * @brief Draws on the tiles intersecting the given range, which are created if need be.
+     * @param rg The extent of what is drawn, in local coordinates
+     * @param draw Called with the context of each tile. The contexts are set up to draw round-capped lines with an
+     * opaque source.
+     */
+    void drawOn(const Range& rg, const std::function<void(cairo_t*)>& draw);
+
+    /**
+     * @brief Use the tiles intersecting the clip of targetCr as a mask
+     */
+    void blitTo(cairo_t* targetCr) const;
+
+    /**
+     * @brief Erase all the content
+     */
+    void wipe();
+
+    /**
+     * @brief Delete the mask
+     */
+    void reset();
+
+private:
+    cairo_t* getTile(int col, int row);
+
+private:
+    /**
+     * A tiny surface, similar to the target: the tiles are created similar to it
+     */
+    xoj::util::CairoSurfaceSPtr model;
+    double zoom = 1.0;
+    int dpiScaling = 1;
+
+    /**
+     * The tiles, by column and row
+     */
+    std::map<std::pair<int, int>, xoj::util::CairoSPtr> tiles;
+};
+};  // namespace xoj::view
@@ -1,11 +1,16 @@
 #include "BackgroundView.h"
 
+#include <cstdint>  // for uint32_t
+#include <string>   // for string, to_string
+#include <utility>  // for move
+
 #include <glib.h>  // for g_warning
 
 #include "model/PageType.h"                          // for PageType, PageTy...
 #include "model/XojPage.h"                           // for XojPage
 #include "view/background/OneColorBackgroundView.h"  // for OneColorBackgrou...
 
+#include "CachedRulingBackgroundView.h"             // for CachedRulingBackg...
 #include "DottedBackgroundView.h"                   // for DottedBackground...
 #include "GraphBackgroundView.h"                    // for GraphBackgroundView
 #include "ImageBackgroundView.h"                    // for ImageBackgroundView
@@ -56,8 +61,8 @@ auto BackgroundView::createRuled(double width, double height, Color backgroundCo
     return res;
 }
 
-auto BackgroundView::createForPage(PageRef page, BackgroundFlags bgFlags, PdfCache* pdfCache)
-        -> std::unique_ptr<BackgroundView> {
+auto BackgroundView::createForPage(PageRef page, BackgroundFlags bgFlags, PdfCache* pdfCache,
+                                   RulingTileCache* rulingCache) -> std::unique_ptr<BackgroundView> {
     const double width = page->getWidth();
     const double height = page->getHeight();
     if (!page->isLayerVisible(0)) {
@@ -86,7 +91,16 @@ auto BackgroundView::createForPage(PageRef page, BackgroundFlags bgFlags, PdfCac
         }
     } else {
         if (bgFlags.showRuling) {
-            return createRuled(width, height, page->getBackgroundColor(), pt);
+            auto ruling = createRuled(width, height, page->getBackgroundColor(), pt);
+            if (rulingCache && ruling && ruling->getTiling()) {
+                // Everything the ruling depends on
+                std::string key = std::to_string(static_cast<int>(pt.format)) + ";" + pt.config + ";" +
+                                  std::to_string(uint32_t(page->getBackgroundColor())) + ";" + std::to_string(width) +
+                                  ";" + std::to_string(height);
+                return std::make_unique<CachedRulingBackgroundView>(width, height, std::move(ruling), rulingCache,
+                                                                    std::move(key));
+            }
+            return ruling;
         }
     }
     // In case the flags tell us to hide the background, create a dummy view.
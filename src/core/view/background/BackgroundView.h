@@ -11,18 +11,21 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
+#include <memory>    // for unique_ptr
+#include <optional>  // for optional
 
 #include <cairo.h>  // for cairo_t
 
-#include "model/PageRef.h"  // for PageRef
-#include "util/Color.h"     // for Color
+#include "model/PageRef.h"   // for PageRef
+#include "util/Color.h"      // for Color
+#include "util/Rectangle.h"  // for Rectangle
 
 class PdfCache;
 class PageType;
 
 namespace xoj {
 namespace view {
+class RulingTileCache;
 
 enum PDFBackgroundTreatment : bool { SHOW_PDF_BACKGROUND = true, HIDE_PDF_BACKGROUND = false };
 enum ImageBackgroundTreatment : bool { SHOW_IMAGE_BACKGROUND = true, HIDE_IMAGE_BACKGROUND = false };
@@ -49,11 +52,34 @@ public:
      */
     virtual void draw(cairo_t* cr) const {}
 
+    /**
+     * @brief Region of the page where the background repeats itself (see RulingTileCache)
+     *
+     * Within the interior, the background drawn in any window of periodX by periodY is the same as in this window
+     * translated by periodX or periodY. A period of 0 means that the background does not repeat in this direction: the
+     * tiles then span the whole interior.
+     */
+    struct Tiling {
+        double periodX;
+        double periodY;
+        xoj::util::Rectangle<double> interior;
+    };
+
+    /**
+     * @return The region where the background is periodic, or nothing if it must always be drawn from vectors
+     */
+    virtual std::optional<Tiling> getTiling() const { return std::nullopt; }
+
     [[nodiscard]] static std::unique_ptr<BackgroundView> createRuled(double width, double height, Color backgroundColor,
                                                                      const PageType& pt, double lineWidthFactor = 1.0);
 
+    /**
+     * @param rulingCache If not null, the periodic part of a ruling is painted from cached tiles on raster targets.
+     * Must only be set for on-screen rendering: exports keep the exact vector output.
+     */
     [[nodiscard]] static std::unique_ptr<BackgroundView> createForPage(PageRef page, xoj::view::BackgroundFlags bgFlags,
-                                                                       PdfCache* pdfCache = nullptr);
+                                                                       PdfCache* pdfCache = nullptr,
+                                                                       RulingTileCache* rulingCache = nullptr);
 
 protected:
     double pageWidth;
@@ -83,3 +83,28 @@ void BaseIsometricBackgroundView::draw(cairo_t* cr) const {
     cairo_stroke(cr);
     cairo_restore(cr);
 }
+
+auto BaseIsometricBackgroundView::getTiling() const -> std::optional<Tiling> {
+    // Same grid as in draw()
+    const double xstep = std::sqrt(3.0) / 2.0 * triangleSize;
+    const double ystep = triangleSize / 2.0;
+    if (ystep <= lineWidth) {
+        return std::nullopt;
+    }
+
+    const double margin = triangleSize;
+    const int cols = static_cast<int>(std::floor((pageWidth - 2 * margin) / xstep));
+    const int rows = static_cast<int>(std::floor((pageHeight - 2 * margin) / ystep));
+    const double contentXOffset = (pageWidth - cols * xstep) / 2;
+    const double contentYOffset = (pageHeight - rows * ystep) / 2;
+
+    // The lattice repeats itself every two steps. Leave out two steps on each side: the edges of the grid differ.
+    const int periodsX = cols / 2 - 2;
+    const int periodsY = rows / 2 - 2;
+    if (periodsX < 1 || periodsY < 1) {
+        return std::nullopt;
+    }
+    return Tiling{2 * xstep,
+                  2 * ystep,
+                  {contentXOffset + 2 * xstep, contentYOffset + 2 * ystep, periodsX * 2 * xstep, periodsY * 2 * ystep}};
+}
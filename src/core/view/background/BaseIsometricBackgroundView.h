@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <optional>  // for optional
+
 #include <cairo.h>  // for cairo_t
 
 #include "util/Color.h"  // for Color
@@ -27,6 +29,7 @@ public:
     virtual ~BaseIsometricBackgroundView() = default;
 
     virtual void draw(cairo_t* cr) const override;
+    virtual std::optional<Tiling> getTiling() const override;
 
 protected:
     virtual void paintGrid(cairo_t* cr, int cols, int rows, double xstep, double ystep, double xOffset,
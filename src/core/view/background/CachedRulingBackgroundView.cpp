@@ -0,0 +1,16 @@
+#include "CachedRulingBackgroundView.h"
+
+#include <utility>  // for move
+
+#include "RulingTileCache.h"  // for RulingTileCache
+
+using namespace xoj::view;
+
+CachedRulingBackgroundView::CachedRulingBackgroundView(double pageWidth, double pageHeight,
+                                                       std::unique_ptr<BackgroundView> ruling, RulingTileCache* cache,
+                                                       std::string key):
+        BackgroundView(pageWidth, pageHeight), ruling(std::move(ruling)), cache(cache), key(std::move(key)) {}
+
+void CachedRulingBackgroundView::draw(cairo_t* cr) const { cache->draw(cr, *ruling, key); }
+
+auto CachedRulingBackgroundView::getTiling() const -> std::optional<Tiling> { return ruling->getTiling(); }
@@ -0,0 +1,45 @@
+/*
+ * Xournal++
+ *
+ * Ruling painted from cached tiles
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <memory>    // for unique_ptr
+#include <optional>  // for optional
+#include <string>    // for string
+
+#include <cairo.h>  // for cairo_t
+
+#include "BackgroundView.h"  // for BackgroundView
+
+namespace xoj::view {
+class RulingTileCache;
+
+/**
+ * @brief Draws a ruling through a RulingTileCache, for on-screen rendering.
+ */
+class CachedRulingBackgroundView: public BackgroundView {
+public:
+    /**
+     * @param key Identifies the ruling: rulings with the same key must be drawn identically
+     */
+    CachedRulingBackgroundView(double pageWidth, double pageHeight, std::unique_ptr<BackgroundView> ruling,
+                               RulingTileCache* cache, std::string key);
+    virtual ~CachedRulingBackgroundView() = default;
+
+    virtual void draw(cairo_t* cr) const override;
+    virtual std::optional<Tiling> getTiling() const override;
+
+private:
+    std::unique_ptr<BackgroundView> ruling;
+    RulingTileCache* cache;
+    std::string key;
+};
+};  // namespace xoj::view
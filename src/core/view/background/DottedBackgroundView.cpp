@@ -53,3 +53,12 @@ void DottedBackgroundView::draw(cairo_t* cr) const {
     cairo_stroke(cr);
     cairo_restore(cr);
 }
+
+auto DottedBackgroundView::getTiling() const -> std::optional<Tiling> {
+    if (squareSize <= lineWidth) {
+        return std::nullopt;
+    }
+    // All the dots but the ones on the left and top edges are drawn
+    const double start = 0.5 * squareSize;
+    return Tiling{squareSize, squareSize, {start, start, pageWidth - start, pageHeight - start}};
+}
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <optional>  // for optional
+
 #include <cairo.h>  // for cairo_t
 
 #include "util/Color.h"  // for Color
@@ -26,6 +28,7 @@ public:
     virtual ~DottedBackgroundView() = default;
 
     virtual void draw(cairo_t* cr) const override;
+    virtual std::optional<Tiling> getTiling() const override;
 
 protected:
     double squareSize = 14.17;  // 5mm
@@ -77,3 +77,13 @@ void GraphBackgroundView::draw(cairo_t* cr) const {
     cairo_stroke(cr);
     cairo_restore(cr);
 }
+
+auto GraphBackgroundView::getTiling() const -> std::optional<Tiling> {
+    if (margin > 0.0 || squareSize <= lineWidth) {
+        // The grid is not periodic close to the margins
+        return std::nullopt;
+    }
+    // All the lines but the ones on the left and top edges are drawn
+    const double start = 0.5 * squareSize;
+    return Tiling{squareSize, squareSize, {start, start, pageWidth - start, pageHeight - start}};
+}
@@ -1,5 +1,6 @@
 #include "RuledBackgroundView.h"
 
+#include <cmath>   // for floor
 #include <memory>  // for allocator
 
 #include "model/BackgroundConfig.h"                  // for BackgroundConfig
@@ -46,3 +47,15 @@ void RuledBackgroundView::draw(cairo_t* cr) const {
     cairo_stroke(cr);
     cairo_restore(cr);
 }
+
+auto RuledBackgroundView::getTiling() const -> std::optional<Tiling> {
+    if (lineSpacing <= lineWidth) {
+        return std::nullopt;
+    }
+    const int lastLine = static_cast<int>(std::floor((pageHeight - HEADER_SIZE - FOOTER_SIZE) / lineSpacing));
+    if (lastLine < 0) {
+        return std::nullopt;
+    }
+    // The lines span the whole width. Each one is in the middle of a period.
+    return Tiling{0.0, lineSpacing, {0.0, HEADER_SIZE - 0.5 * lineSpacing, pageWidth, (lastLine + 1) * lineSpacing}};
+}
@@ -0,0 +1,199 @@
+#include "RulingTileCache.h"
+
+#include <algorithm>  // for find_if, min, max
+#include <cmath>      // for ceil, floor, round, abs
+#include <cstdint>    // for int64_t
+#include <optional>   // for optional
+#include <utility>    // for pair
+
+#include "util/Tracing.h"  // for counter
+
+using namespace xoj::view;
+using xoj::util::Rectangle;
+
+/**
+ * Tiles smaller than this, in pixels, span several periods of the ruling, so that they are not painted too many times
+ */
+constexpr double MIN_TILE_SIDE = 64;
+
+/**
+ * Number of period counts tried for a tile side, to find the one whose size in pixels is the closest to an integer
+ */
+constexpr int PERIOD_CANDIDATES = 8;
+
+/**
+ * Larger tiles are not worth caching: the ruling is drawn from vectors
+ */
+constexpr int MAX_TILE_PIXELS = 4096 * 1024;
+
+/**
+ * Memory budget of the cache, in bytes. The least recently used tiles are dropped first.
+ */
+constexpr size_t MAX_CACHE_SIZE = 64 * 1024 * 1024;
+
+/**
+ * Tolerance on the pixel alignment, in pixels
+ */
+constexpr double PIXEL_EPSILON = 1e-6;
+
+/**
+ * @return The side of the tile in pixels and in page coordinates, or nothing if the region is too small
+ * @param period Period of the ruling in this direction, or 0
+ * @param regionPixels Side of the region painted with the tiles, in pixels
+ */
+static auto computeTileSide(double period, int regionPixels, double scale) -> std::optional<std::pair<int, double>> {
+    if (regionPixels < 1) {
+        return std::nullopt;
+    }
+    if (period <= 0) {
+        // Not periodic: the tile spans the whole region
+        return std::make_pair(regionPixels, regionPixels / scale);
+    }
+
+    const double periodPixels = period * scale;
+    const int maxPeriods = static_cast<int>(std::floor(regionPixels / periodPixels));
+    if (maxPeriods < 1) {
+        return std::nullopt;
+    }
+
+    // The tile is repeated every k * period: the closer its size in pixels is to an integer, the less it gets resampled
+    const int minPeriods = std::min(maxPeriods, std::max(1, static_cast<int>(std::ceil(MIN_TILE_SIDE / periodPixels))));
+    int bestPeriods = minPeriods;
+    double bestError = 1.0;
+    for (int k = minPeriods; k <= std::min(maxPeriods, minPeriods + PERIOD_CANDIDATES - 1); k++) {
+        const double error = std::abs(k * periodPixels - std::round(k * periodPixels));
+        if (error < bestError) {
+            bestError = error;
+            bestPeriods = k;
+        }
+    }
+    return std::make_pair(std::max(1, static_cast<int>(std::round(bestPeriods * periodPixels))), bestPeriods * period);
+}
+
+/**
+ * Draws the ruling from vectors in a rectangle of the clip region
+ */
+static void drawClipped(cairo_t* cr, const BackgroundView& ruling, double x1, double y1, double x2, double y2) {
+    if (x2 <= x1 || y2 <= y1) {
+        return;
+    }
+    cairo_save(cr);
+    cairo_rectangle(cr, x1, y1, x2 - x1, y2 - y1);
+    cairo_clip(cr);
+    ruling.draw(cr);
+    cairo_restore(cr);
+}
+
+void RulingTileCache::draw(cairo_t* cr, const BackgroundView& ruling, const std::string& key) {
+    auto tiling = ruling.getTiling();
+    cairo_surface_t* target = cairo_get_target(cr);
+    if (!tiling || cairo_surface_get_type(target) != CAIRO_SURFACE_TYPE_IMAGE) {
+        ruling.draw(cr);
+        return;
+    }
+
+    // The tiles are only used if the page coordinates are scaled uniformly and the page is aligned on the pixels
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    double deviceScaleX = 1;
+    double deviceScaleY = 1;
+    cairo_surface_get_device_scale(target, &deviceScaleX, &deviceScaleY);
+    double deviceOffsetX = 0;
+    double deviceOffsetY = 0;
+    cairo_surface_get_device_offset(target, &deviceOffsetX, &deviceOffsetY);
+
+    const double scale = matrix.xx * deviceScaleX;
+    const double originX = matrix.x0 * deviceScaleX + deviceOffsetX;
+    const double originY = matrix.y0 * deviceScaleY + deviceOffsetY;
+    if (matrix.xy != 0 || matrix.yx != 0 || scale <= 0 || scale != matrix.yy * deviceScaleY ||
+        std::abs(originX - std::round(originX)) > PIXEL_EPSILON ||
+        std::abs(originY - std::round(originY)) > PIXEL_EPSILON) {
+        ruling.draw(cr);
+        return;
+    }
+
+    // Shrink the interior to whole pixels, so that the tiles and the borders drawn from vectors do not share any pixel
+    const Rectangle<double>& interior = tiling->interior;
+    const int pixelX1 = static_cast<int>(std::ceil(interior.x * scale - PIXEL_EPSILON));
+    const int pixelY1 = static_cast<int>(std::ceil(interior.y * scale - PIXEL_EPSILON));
+    const int pixelX2 = static_cast<int>(std::floor((interior.x + interior.width) * scale + PIXEL_EPSILON));
+    const int pixelY2 = static_cast<int>(std::floor((interior.y + interior.height) * scale + PIXEL_EPSILON));
+
+    auto sideX = computeTileSide(tiling->periodX, pixelX2 - pixelX1, scale);
+    auto sideY = computeTileSide(tiling->periodY, pixelY2 - pixelY1, scale);
+    if (!sideX || !sideY || static_cast<int64_t>(sideX->first) * sideY->first > MAX_TILE_PIXELS) {
+        ruling.draw(cr);
+        return;
+    }
+
+    Layout layout{{pixelX1 / scale, pixelY1 / scale, (pixelX2 - pixelX1) / scale, (pixelY2 - pixelY1) / scale},
+                  sideX->second,
+                  sideY->second,
+                  sideX->first,
+                  sideY->first};
+    xoj::util::CairoSurfaceSPtr tile = getTile(ruling, key, scale, layout);
+
+    // The borders, where the ruling is not periodic
+    double minX;
+    double maxX;
+    double minY;
+    double maxY;
+    cairo_clip_extents(cr, &minX, &minY, &maxX, &maxY);
+    const Rectangle<double>& region = layout.region;
+    const double regionX2 = region.x + region.width;
+    const double regionY2 = region.y + region.height;
+    drawClipped(cr, ruling, minX, minY, maxX, std::min(maxY, region.y));
+    drawClipped(cr, ruling, minX, std::max(minY, regionY2), maxX, maxY);
+    drawClipped(cr, ruling, minX, std::max(minY, region.y), std::min(maxX, region.x), std::min(maxY, regionY2));
+    drawClipped(cr, ruling, std::max(minX, regionX2), std::max(minY, region.y), maxX, std::min(maxY, regionY2));
+
+    // The interior
+    cairo_save(cr);
+    cairo_rectangle(cr, region.x, region.y, region.width, region.height);
+    cairo_clip(cr);
+    cairo_set_source_surface(cr, tile.get(), region.x, region.y);
+    cairo_pattern_set_extend(cairo_get_source(cr), CAIRO_EXTEND_REPEAT);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_BILINEAR);
+    cairo_paint(cr);
+    cairo_restore(cr);
+}
+
+auto RulingTileCache::getTile(const BackgroundView& ruling, const std::string& key, double scale, const Layout& layout)
+        -> xoj::util::CairoSurfaceSPtr {
+    std::lock_guard lock(this->mutex);
+
+    auto it = std::find_if(this->entries.begin(), this->entries.end(),
+                           [&](const Entry& e) { return e.key == key && e.scale == scale; });
+    if (it != this->entries.end()) {
+        this->hits++;
+        xoj::util::trace::counter("RulingTileCache", {{"hits", this->hits}, {"misses", this->misses}});
+        this->entries.splice(this->entries.begin(), this->entries, it);
+        return it->tile;
+    }
+    this->misses++;
+    xoj::util::trace::counter("RulingTileCache", {{"hits", this->hits}, {"misses", this->misses}});
+
+    // Render the top-left tile of the region with the vector code: the whole region is periodic, so any tile will do
+    xoj::util::CairoSurfaceSPtr tile(
+            cairo_image_surface_create(CAIRO_FORMAT_ARGB32, layout.tilePixelWidth, layout.tilePixelHeight),
+            xoj::util::adopt);
+    cairo_surface_set_device_scale(tile.get(), layout.tilePixelWidth / layout.tileWidth,
+                                   layout.tilePixelHeight / layout.tileHeight);
+    xoj::util::CairoSPtr cr(cairo_create(tile.get()), xoj::util::adopt);
+    cairo_translate(cr.get(), -layout.region.x, -layout.region.y);
+    cairo_rectangle(cr.get(), layout.region.x, layout.region.y, layout.tileWidth, layout.tileHeight);
+    cairo_clip(cr.get());
+    ruling.draw(cr.get());
+    cr.reset();
+    cairo_surface_flush(tile.get());
+
+    const size_t size = static_cast<size_t>(cairo_image_surface_get_stride(tile.get())) *
+                        static_cast<size_t>(layout.tilePixelHeight);
+    this->entries.push_front({key, scale, tile, size});
+    this->totalSize += size;
+    while (this->totalSize > MAX_CACHE_SIZE && this->entries.size() > 1) {
+        this->totalSize -= this->entries.back().size;
+        this->entries.pop_back();
+    }
+    return tile;
+}
@@ -0,0 +1,93 @@
+/*
+ * Xournal++
+ *
+ * Cache of pre-rendered tiles of the page rulings
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <list>     // for list
+#include <mutex>    // for mutex
+#include <string>   // for string
+
+#include <cairo.h>  // for cairo_t
+
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+#include "BackgroundView.h"  // for BackgroundView
+
+namespace xoj::view {
+
+/**
+ * @brief Tiles of the procedural backgrounds (ruled, graph, dotted, ...) rendered at the resolution of the screen.
+ *
+ * The interior of a ruling (see BackgroundView::getTiling()) is painted from a repeating pattern whose tile is rendered
+ * once per ruling and resolution, instead of stroking thousands of lines or dots every time a page region is rendered.
+ * The borders of the page, where the ruling is not periodic (margins, header, footer), are still drawn from vectors.
+ *
+ * Only raster targets whose pixels are aligned with the page coordinates use the tiles: anything else (in particular
+ * the exports) gets the exact vector output.
+ *
+ * The cache is shared by the rendering threads.
+ */
+class RulingTileCache {
+public:
+    RulingTileCache() = default;
+    RulingTileCache(const RulingTileCache&) = delete;
+    RulingTileCache& operator=(const RulingTileCache&) = delete;
+    ~RulingTileCache() = default;
+
+public:
+    /**
+     * Draws the ruling like ruling.draw(cr) does, within the clip region of cr
+     * @param key Identifies the ruling: rulings with the same key must be drawn identically
+     */
+    void draw(cairo_t* cr, const BackgroundView& ruling, const std::string& key);
+
+private:
+    /**
+     * Position of the tiles on the page, for a given ruling and resolution
+     */
+    struct Layout {
+        xoj::util::Rectangle<double> region;  ///< Part of the interior painted with the tiles, aligned on the pixels
+        double tileWidth;                     ///< In page coordinates
+        double tileHeight;
+        int tilePixelWidth;
+        int tilePixelHeight;
+    };
+
+    struct Entry {
+        std::string key;
+        double scale;
+        xoj::util::CairoSurfaceSPtr tile;
+        size_t size;  ///< In bytes
+    };
+
+    /**
+     * @return The tile of the ruling, rendering it if it is not cached
+     */
+    xoj::util::CairoSurfaceSPtr getTile(const BackgroundView& ruling, const std::string& key, double scale,
+                                        const Layout& layout);
+
+private:
+    std::mutex mutex;
+
+    /**
+     * Most recently used first
+     */
+    std::list<Entry> entries;
+    size_t totalSize = 0;
+
+    /**
+     * Only used for the tracing
+     */
+    size_t hits = 0;
+    size_t misses = 0;
+};
+};  // namespace xoj::view
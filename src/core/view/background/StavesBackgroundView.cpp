@@ -1,5 +1,7 @@
 #include "StavesBackgroundView.h"
 
+#include <cmath>  // for floor
+
 #include "model/BackgroundConfig.h"                  // for BackgroundConfig
 #include "view/background/BackgroundView.h"          // for view
 #include "view/background/OneColorBackgroundView.h"  // for OneColorBackgrou...
@@ -53,3 +55,18 @@ void StavesBackgroundView::draw(cairo_t* cr) const {
     cairo_stroke(cr);
     cairo_restore(cr);
 }
+
+auto StavesBackgroundView::getTiling() const -> std::optional<Tiling> {
+    // Same spacing as in draw()
+    const double staffHeight = lineWidth + 4 * LINES_SPACING;
+    const double vOffsetBetweenStaves = STAVES_SPACING + staffHeight + 4 * lineWidth;
+    const int lastStaff =
+            static_cast<int>(std::floor((pageHeight - HEADER_SIZE - FOOTER_SIZE) / vOffsetBetweenStaves));
+    if (lastStaff < 0) {
+        return std::nullopt;
+    }
+    // Each staff is in the middle of a period
+    const double gap = 0.5 * (vOffsetBetweenStaves - 4 * LINES_SPACING);
+    return Tiling{0.0, vOffsetBetweenStaves,
+                  {0.0, HEADER_SIZE - gap, pageWidth, (lastStaff + 1) * vOffsetBetweenStaves}};
+}
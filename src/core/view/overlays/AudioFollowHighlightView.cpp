@@ -0,0 +1,39 @@
+#include "AudioFollowHighlightView.h"
+
+#include "control/AudioFollowHighlight.h"
+#include "util/Range.h"
+#include "util/raii/CairoWrappers.h"
+#include "view/Repaintable.h"
+
+using namespace xoj::view;
+
+AudioFollowHighlightView::AudioFollowHighlightView(const AudioFollowHighlight* highlight, const XojPage* page,
+                                                   Repaintable* parent, Color color):
+        OverlayView(parent), highlight(highlight), page(page), color(color) {
+    this->registerToPool(highlight->getViewPool());
+}
+
+AudioFollowHighlightView::~AudioFollowHighlightView() noexcept { this->unregisterFromPool(); }
+
+void AudioFollowHighlightView::draw(cairo_t* cr) const {
+    auto rects = this->highlight->getRectsOnPage(this->page);
+    if (rects.empty()) {
+        return;
+    }
+
+    xoj::util::CairoSaveGuard saveGuard(cr);
+    for (const auto& r: rects) {
+        cairo_rectangle(cr, r.x - PADDING, r.y - PADDING, r.width + 2 * PADDING, r.height + 2 * PADDING);
+    }
+    Util::cairo_set_source_rgbi(cr, color, BACKGROUND_OPACITY);
+    cairo_fill(cr);
+}
+
+bool AudioFollowHighlightView::isViewOf(const OverlayBase* overlay) const { return overlay == this->highlight; }
+
+void AudioFollowHighlightView::on(AudioFollowHighlightView::HighlightChangedNotification, const XojPage* page,
+                                  const Range& rg) {
+    if (page == this->page) {
+        this->parent->flagDirtyRegion(rg);
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * View highlighting the elements written at the current audio playback position
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+#pragma once
+
+#include <cairo.h>  // for cairo_t
+
+#include "util/Color.h"
+#include "util/DispatchPool.h"  // for Listener
+#include "view/overlays/OverlayView.h"
+
+class AudioFollowHighlight;
+class OverlayBase;
+class Range;
+class XojPage;
+
+namespace xoj::view {
+class Repaintable;
+
+class AudioFollowHighlightView final: public OverlayView, public xoj::util::Listener<AudioFollowHighlightView> {
+
+public:
+    AudioFollowHighlightView(const AudioFollowHighlight* highlight, const XojPage* page, Repaintable* parent,
+                             Color color);
+    ~AudioFollowHighlightView() noexcept override;
+
+    /**
+     * @brief Draws the overlay to the given context
+     */
+    void draw(cairo_t* cr) const override;
+
+    bool isViewOf(const OverlayBase* overlay) const override;
+
+    /**
+     * Listener interface
+     */
+    static constexpr struct HighlightChangedNotification {
+    } HIGHLIGHT_CHANGED_NOTIFICATION = {};
+    void on(HighlightChangedNotification, const XojPage* page, const Range& rg);
+
+private:
+    const AudioFollowHighlight* highlight;
+    const XojPage* page;
+    const Color color;
+
+public:
+    // Margin around the highlighted elements, in document coordinates
+    static constexpr double PADDING = 2.0;
+    // Opacity of the background
+    static constexpr double BACKGROUND_OPACITY = 0.25;
+};
+};  // namespace xoj::view
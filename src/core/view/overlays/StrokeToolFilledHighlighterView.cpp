@@ -16,6 +16,13 @@ StrokeToolFilledHighlighterView::StrokeToolFilledHighlighterView(const StrokeHan
 
 StrokeToolFilledHighlighterView::~StrokeToolFilledHighlighterView() noexcept = default;
 
+void StrokeToolFilledHighlighterView::on(StrokeReplacementRequest, const Stroke& newStroke) {
+    StrokeToolFilledView::on(STROKE_REPLACEMENT_REQUEST, newStroke);
+    if (this->fillingMask.isInitialized()) {
+        this->fillingMask.wipe();
+    }
+}
+
 void StrokeToolFilledHighlighterView::draw(cairo_t* cr) const {
 
     std::vector<Point> pts = this->flushBuffer();
@@ -26,10 +33,10 @@ void StrokeToolFilledHighlighterView::draw(cairo_t* cr) const {
 
     this->filling.appendSegments(pts);
 
-    if (!this->mask.isInitialized()) {
+    if (!this->fillingMask.isInitialized()) {
         // Initialize mask on first call
-        this->mask = this->createMask(cr);
-        if (!mask.isInitialized()) {
+        this->fillingMask = this->createMask(cr);
+        if (!fillingMask.isInitialized()) {
             /*
              * The user might be drawing on a page that is not visible at all:
              * e.g. https://github.com/xournalpp/xournalpp/pull/4158#issuecomment-1385954494
@@ -39,7 +46,7 @@ void StrokeToolFilledHighlighterView::draw(cairo_t* cr) const {
     }
 
     if (this->singleDot) {
-        this->drawDot(this->mask.get(), pts.back());
+        this->drawDot(this->fillingMask.get(), pts.back());
     } else {
         /*
          * Upon adding a segment, the filling can actually shrink.
@@ -52,22 +59,22 @@ void StrokeToolFilledHighlighterView::draw(cairo_t* cr) const {
         }
 
         if (wipe.isValid()) {
-            this->mask.wipeRange(wipe);
+            this->fillingMask.wipeRange(wipe);
         }
 
 
         /*
          * Draw both the filling and the stroke alike on the mask
          */
-        cairo_set_line_width(this->mask.get(), this->strokeWidth);
-        StrokeViewHelper::pathToCairo(this->mask.get(), this->filling.contour);
-        cairo_fill_preserve(this->mask.get());
-        cairo_stroke(this->mask.get());
+        cairo_set_line_width(this->fillingMask.get(), this->strokeWidth);
+        StrokeViewHelper::pathToCairo(this->fillingMask.get(), this->filling.contour);
+        cairo_fill_preserve(this->fillingMask.get());
+        cairo_stroke(this->fillingMask.get());
     }
 
     xoj::util::CairoSaveGuard saveGuard(cr);
     Util::cairo_set_source_argb(cr, this->strokeColor);
     cairo_set_operator(cr, this->cairoOp);
 
-    cairo_mask_surface(cr, cairo_get_target(this->mask.get()), 0, 0);
+    cairo_mask_surface(cr, cairo_get_target(this->fillingMask.get()), 0, 0);
 }
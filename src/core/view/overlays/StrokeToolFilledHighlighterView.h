@@ -12,6 +12,8 @@
  */
 #pragma once
 
+#include "view/Mask.h"
+
 #include "StrokeToolFilledView.h"
 
 namespace xoj::view {
@@ -21,5 +23,13 @@ public:
     virtual ~StrokeToolFilledHighlighterView() noexcept;
 
     void draw(cairo_t* cr) const override;
+
+    void on(StrokeReplacementRequest, const Stroke& newStroke) override;
+
+private:
+    /**
+     * @brief Drawing mask, covering the visible area: the whole filling is redrawn on it at every iteration
+     */
+    mutable Mask fillingMask;
 };
 };  // namespace xoj::view
@@ -1,5 +1,6 @@
 #include "StrokeToolView.h"
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <memory>
@@ -11,6 +12,7 @@
 #include "util/Color.h"
 #include "util/PairView.h"
 #include "util/Range.h"
+#include "util/Tracing.h"
 #include "util/raii/CairoWrappers.h"  // for CairoSaveGuard
 #include "view/Repaintable.h"
 #include "view/StrokeViewHelper.h"
@@ -28,6 +30,7 @@ StrokeToolView::~StrokeToolView() noexcept { this->unregisterFromPool(); }
 bool StrokeToolView::isViewOf(const OverlayBase* overlay) const { return overlay == this->strokeHandler; }
 
 void StrokeToolView::draw(cairo_t* cr) const {
+    XOJ_TRACE_SCOPE("StrokeToolView::draw");
 
     std::vector<Point> pts = this->flushBuffer();
     if (pts.empty()) {
@@ -38,14 +41,7 @@ void StrokeToolView::draw(cairo_t* cr) const {
 
     if (!mask.isInitialized()) {
         // Initialize the mask on first call
-        mask = createMask(cr);
-        if (!mask.isInitialized()) {
-            /*
-             * The user might be drawing on a page that is not visible at all:
-             * e.g. https://github.com/xournalpp/xournalpp/pull/4158#issuecomment-1385954494
-             */
-            return;
-        }
+        mask = TiledMask(cairo_get_target(cr), this->parent->getZoom(), this->parent->getDPIScaling());
     }
 
     xoj::util::CairoSaveGuard saveGuard(cr);
@@ -55,11 +51,14 @@ void StrokeToolView::draw(cairo_t* cr) const {
 
     Util::cairo_set_source_argb(cr, strokeColor);
 
+    // Only the tiles touched by the new segments are drawn on
+    const Range rg = this->getRange(pts);
     if (pts.size() > 1) {
         // Draw the new segments on the mask
         if (pts.front().z == Point::NO_PRESSURE) {
-            StrokeViewHelper::drawNoPressure(this->mask.get(), pts, this->strokeWidth, this->lineStyle,
-                                             this->dashOffset);
+            this->mask.drawOn(rg, [&](cairo_t* tileCr) {
+                StrokeViewHelper::drawNoPressure(tileCr, pts, this->strokeWidth, this->lineStyle, this->dashOffset);
+            });
             if (this->lineStyle.hasDashes()) {
                 // Keep the offset up to date, so we do not have to redraw the entire stroke every time.
                 PairView segments(pts);
@@ -68,14 +67,17 @@ void StrokeToolView::draw(cairo_t* cr) const {
                                               [](auto& seg) { return seg.front().lineLengthTo(seg.back()); });
             }
         } else {
-            this->dashOffset =
-                    StrokeViewHelper::drawWithPressure(this->mask.get(), pts, this->lineStyle, this->dashOffset);
+            double dashOffset = this->dashOffset;
+            this->mask.drawOn(rg, [&](cairo_t* tileCr) {
+                dashOffset = StrokeViewHelper::drawWithPressure(tileCr, pts, this->lineStyle, this->dashOffset);
+            });
+            this->dashOffset = dashOffset;
         }
     } else if (this->singleDot) {
-        this->drawDot(this->mask.get(), pts.back());
+        this->mask.drawOn(rg, [&](cairo_t* tileCr) { this->drawDot(tileCr, pts.back()); });
     }
 
-    cairo_mask_surface(cr, cairo_get_target(this->mask.get()), 0, 0);
+    this->mask.blitTo(cr);
 }
 
 void StrokeToolView::on(StrokeToolView::AddPointRequest, const Point& p) {
@@ -125,6 +127,17 @@ auto StrokeToolView::getRepaintRange(const Point& lastPoint, const Point& addedP
     return rg;
 }
 
+auto StrokeToolView::getRange(const std::vector<Point>& pts) const -> Range {
+    Range rg;
+    double width = 0;
+    for (const Point& p: pts) {
+        rg.addPoint(p.x, p.y);
+        width = std::max(width, p.z == Point::NO_PRESSURE ? this->strokeWidth : p.z);
+    }
+    rg.addPadding(0.5 * width);
+    return rg;
+}
+
 void StrokeToolView::drawDot(cairo_t* cr, const Point& p) const {
     cairo_set_line_width(cr, p.z == Point::NO_PRESSURE ? this->strokeWidth : p.z);
     cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
@@ -15,7 +15,7 @@
 #include <cairo.h>
 
 #include "util/DispatchPool.h"
-#include "view/Mask.h"
+#include "view/TiledMask.h"
 
 #include "BaseStrokeToolView.h"
 
@@ -69,6 +69,11 @@ protected:
      */
     auto getRepaintRange(const Point& lastPoint, const Point& addedPoint) const -> Range;
 
+    /**
+     * @brief Compute the bounding box of the given points, taking stroke width into account.
+     */
+    auto getRange(const std::vector<Point>& pts) const -> Range;
+
     void drawDot(cairo_t* cr, const Point& p) const;
 
     /**
@@ -102,7 +107,8 @@ protected:
      *
      * The stroke is drawn to the mask and the mask is then blitted wherever needed.
      * Upon calls to draw(), the buffer is flushed and the corresponding part of stroke is added to the mask.
+     * The mask is tiled: it only covers the stroke, and only the tiles in the repainted region are blitted.
      */
-    mutable Mask mask;
+    mutable TiledMask mask;
 };
 };  // namespace xoj::view
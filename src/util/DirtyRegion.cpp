@@ -0,0 +1,118 @@
+#include "util/DirtyRegion.h"
+
+#include <cassert>   // for assert
+#include <cstddef>   // for ptrdiff_t
+#include <iterator>  // for next
+#include <limits>    // for numeric_limits
+
+using namespace xoj::util;
+
+/**
+ * A rectangle is merged with another one if the merge adds at most this ratio of their areas
+ */
+constexpr double MAX_WASTE_RATIO = 0.5;
+
+/**
+ * @return The area of the union of a and b which is neither in a nor in b
+ */
+static auto mergeWaste(const Rectangle<double>& a, const Rectangle<double>& b) -> double {
+    Rectangle<double> u = a;
+    u.unite(b);
+    const auto overlap = a.intersects(b);
+    return u.area() - a.area() - b.area() + (overlap ? overlap->area() : 0.0);
+}
+
+DirtyRegion::DirtyRegion(size_t maxRects): maxRects(maxRects) { assert(maxRects > 0); }
+
+void DirtyRegion::add(const Rectangle<double>& rect) {
+    if (!(rect.width > 0 && rect.height > 0)) {
+        return;
+    }
+    this->requestedArea += rect.area();
+
+    Rectangle<double> merged = rect;
+    auto best = this->rects.end();
+    double bestWaste = std::numeric_limits<double>::max();
+    for (auto it = this->rects.begin(); it != this->rects.end(); ++it) {
+        const double waste = mergeWaste(*it, rect);
+        if (waste <= MAX_WASTE_RATIO * (it->area() + rect.area()) && waste < bestWaste) {
+            best = it;
+            bestWaste = waste;
+        }
+    }
+    if (best != this->rects.end()) {
+        merged.unite(*best);
+        this->rects.erase(best);
+    }
+    insertMerged(merged);
+
+    while (this->rects.size() > this->maxRects) {
+        mergeCheapestPair();
+    }
+}
+
+void DirtyRegion::insertMerged(Rectangle<double> rect) {
+    for (auto it = this->rects.begin(); it != this->rects.end();) {
+        if (it->intersects(rect)) {
+            // The union may intersect rectangles we already went past: start over
+            rect.unite(*it);
+            this->rects.erase(it);
+            it = this->rects.begin();
+        } else {
+            ++it;
+        }
+    }
+    this->rects.push_back(rect);
+}
+
+void DirtyRegion::mergeCheapestPair() {
+    assert(this->rects.size() >= 2);
+    size_t bestI = 0;
+    size_t bestJ = 1;
+    double bestWaste = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < this->rects.size(); i++) {
+        for (size_t j = i + 1; j < this->rects.size(); j++) {
+            const double waste = mergeWaste(this->rects[i], this->rects[j]);
+            if (waste < bestWaste) {
+                bestI = i;
+                bestJ = j;
+                bestWaste = waste;
+            }
+        }
+    }
+
+    Rectangle<double> merged = this->rects[bestI];
+    merged.unite(this->rects[bestJ]);
+    this->rects.erase(std::next(this->rects.begin(), static_cast<std::ptrdiff_t>(bestJ)));
+    this->rects.erase(std::next(this->rects.begin(), static_cast<std::ptrdiff_t>(bestI)));
+    insertMerged(merged);
+}
+
+void DirtyRegion::clear() {
+    this->rects.clear();
+    this->requestedArea = 0;
+}
+
+auto DirtyRegion::empty() const -> bool { return this->rects.empty(); }
+
+auto DirtyRegion::getRects() const -> const std::vector<Rectangle<double>>& { return this->rects; }
+
+auto DirtyRegion::getBounds() const -> Rectangle<double> {
+    assert(!empty());
+    Rectangle<double> bounds = this->rects.front();
+    for (const auto& r: this->rects) { bounds.unite(r); }
+    return bounds;
+}
+
+auto DirtyRegion::getArea() const -> double {
+    // The rectangles are pairwise disjoint
+    double area = 0;
+    for (const auto& r: this->rects) { area += r.area(); }
+    return area;
+}
+
+auto DirtyRegion::getRequestedArea() const -> double { return this->requestedArea; }
+
+auto DirtyRegion::getOverdrawRatio() const -> double {
+    return this->requestedArea > 0 ? getArea() / this->requestedArea : 1.0;
+}
@@ -1,5 +1,6 @@
 #include "util/StringUtils.h"
 
+#include <cstdio>  // for snprintf
 #include <cstring>
 #include <sstream>  // std::istringstream
 #include <utility>
@@ -81,3 +82,36 @@ auto StringUtils::iequals(const string& a, const string& b) -> bool {
 
     return result == 0;
 }
+
+auto StringUtils::escapeJson(const string& input) -> string {
+    string out;
+    out.reserve(input.size());
+    for (char c: input) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[7];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(c));
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
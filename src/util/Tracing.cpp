@@ -0,0 +1,164 @@
+#include "util/Tracing.h"
+
+#include <array>      // for array
+#include <chrono>     // for steady_clock, duration_cast
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint32_t, uint8_t
+#include <fstream>    // for ofstream
+#include <locale>     // for locale
+#include <mutex>      // for mutex, lock_guard
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include <glib.h>  // for g_warning
+
+#include "util/StringUtils.h"  // for StringUtils
+
+using namespace xoj::util;
+
+std::atomic<bool> trace::detail::enabled = false;
+
+/**
+ * Beyond this number of events, the following ones are dropped (an event takes about 100 bytes)
+ */
+constexpr size_t MAX_EVENTS = 1 << 21;
+
+constexpr size_t MAX_COUNTER_VALUES = 4;
+
+namespace {
+struct Event {
+    const char* name;
+    char phase;  ///< 'X' for a complete event, 'C' for a counter
+    uint32_t thread;
+    int64_t timestamp;
+    int64_t duration;
+    uint8_t valueCount;
+    std::array<std::pair<const char*, double>, MAX_COUNTER_VALUES> values;
+};
+
+struct Recording {
+    std::mutex mutex;
+    fs::path file;
+    std::vector<Event> events;
+    size_t dropped = 0;
+};
+
+auto getRecording() -> Recording& {
+    static Recording recording;
+    return recording;
+}
+
+/**
+ * @return A small number identifying the calling thread, in the order in which the threads first recorded an event
+ */
+auto getThreadId() -> uint32_t {
+    static std::atomic<uint32_t> nextId = 1;
+    thread_local const uint32_t id = nextId++;
+    return id;
+}
+
+void record(const Event& event) {
+    Recording& recording = getRecording();
+    std::lock_guard lock(recording.mutex);
+    if (!trace::isEnabled()) {
+        // Stopped in the meantime
+        return;
+    }
+    if (recording.events.size() >= MAX_EVENTS) {
+        recording.dropped++;
+        return;
+    }
+    recording.events.push_back(event);
+}
+
+void writeName(std::ostream& out, const char* name) { out << '"' << StringUtils::escapeJson(name) << '"'; }
+};  // namespace
+
+void trace::start(fs::path file) {
+    Recording& recording = getRecording();
+    std::lock_guard lock(recording.mutex);
+    recording.file = std::move(file);
+    recording.events.clear();
+    recording.dropped = 0;
+    detail::enabled = true;
+}
+
+auto trace::stop() -> bool {
+    Recording& recording = getRecording();
+    std::vector<Event> events;
+    fs::path file;
+    size_t dropped = 0;
+    {
+        std::lock_guard lock(recording.mutex);
+        if (!detail::enabled) {
+            return true;
+        }
+        detail::enabled = false;
+        std::swap(events, recording.events);
+        std::swap(file, recording.file);
+        dropped = recording.dropped;
+    }
+
+    std::ofstream out(file, std::ios::binary);
+    if (!out) {
+        g_warning("Tracing: could not open \"%s\" for writing", file.u8string().c_str());
+        return false;
+    }
+    out.imbue(std::locale::classic());
+
+    out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << dropped << "},\"traceEvents\":[\n";
+    bool first = true;
+    for (const Event& e: events) {
+        out << (first ? "" : ",\n") << "{\"name\":";
+        first = false;
+        writeName(out, e.name);
+        out << ",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << e.thread << ",\"ts\":" << e.timestamp;
+        if (e.phase == 'X') {
+            out << ",\"dur\":" << e.duration;
+        } else {
+            out << ",\"args\":{";
+            for (uint8_t i = 0; i < e.valueCount; i++) {
+                out << (i ? "," : "");
+                writeName(out, e.values[i].first);
+                out << ':' << e.values[i].second;
+            }
+            out << '}';
+        }
+        out << '}';
+    }
+    out << "\n]}\n";
+
+    out.close();
+    if (!out) {
+        g_warning("Tracing: could not write \"%s\"", file.u8string().c_str());
+        return false;
+    }
+    return true;
+}
+
+auto trace::now() -> int64_t {
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void trace::complete(const char* name, int64_t start, int64_t duration) {
+    if (!isEnabled()) {
+        return;
+    }
+    record({name, 'X', getThreadId(), start, duration, 0, {}});
+}
+
+void trace::counter(const char* name, std::initializer_list<std::pair<const char*, double>> values) {
+    if (!isEnabled()) {
+        return;
+    }
+    Event event{name, 'C', getThreadId(), now(), 0, 0, {}};
+    for (const auto& v: values) {
+        if (event.valueCount == MAX_COUNTER_VALUES) {
+            break;
+        }
+        event.values[event.valueCount++] = v;
+    }
+    record(event);
+}
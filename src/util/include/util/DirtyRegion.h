@@ -0,0 +1,81 @@
+/*
+ * Xournal++
+ *
+ * An area to be redrawn, tracked as a few rectangles
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "util/Rectangle.h"  // for Rectangle
+
+namespace xoj::util {
+
+/**
+ * @brief An area to be redrawn, tracked as a small number of pairwise disjoint rectangles.
+ *
+ * An added rectangle is merged with the rectangles it intersects. Otherwise, it is merged with the rectangle for which
+ * the merge adds the least area not asked for, if that area is small enough. When there are too many rectangles, the
+ * two wasting the least area once merged are merged.
+ */
+class DirtyRegion final {
+public:
+    /**
+     * @param maxRects The maximal number of rectangles kept
+     */
+    explicit DirtyRegion(size_t maxRects = 8);
+
+    void add(const Rectangle<double>& rect);
+
+    void clear();
+
+    bool empty() const;
+
+    const std::vector<Rectangle<double>>& getRects() const;
+
+    /**
+     * @return The bounding box of the rectangles. The region must not be empty.
+     */
+    Rectangle<double> getBounds() const;
+
+    /**
+     * @return The area of the region, i.e. what is redrawn
+     */
+    double getArea() const;
+
+    /**
+     * @return The sum of the areas of the added rectangles, i.e. what was asked for. The overlaps of the added
+     * rectangles are counted several times.
+     */
+    double getRequestedArea() const;
+
+    /**
+     * @return The ratio between the redrawn area and the requested area (1 if nothing more than asked for is redrawn)
+     */
+    double getOverdrawRatio() const;
+
+private:
+    /**
+     * Inserts the rectangle, merged with the rectangles it intersects (after the merge, if needs be)
+     */
+    void insertMerged(Rectangle<double> rect);
+
+    /**
+     * Merges the two rectangles wasting the least area once merged
+     */
+    void mergeCheapestPair();
+
+private:
+    std::vector<Rectangle<double>> rects;
+    size_t maxRects;
+    double requestedArea = 0;
+};
+
+}  // namespace xoj::util
@@ -29,4 +29,9 @@ public:
     static std::string trim(std::string str);
     static bool iequals(const std::string& a, const std::string& b);
     static bool isNumber(const std::string& input);
+
+    /**
+     * @return The input escaped to be used inside a JSON string literal (without the quotes)
+     */
+    static std::string escapeJson(const std::string& input);
 };
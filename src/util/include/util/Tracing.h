@@ -0,0 +1,95 @@
+/*
+ * Xournal++
+ *
+ * Timing of the rendering and of the input handling, exported as Chrome trace events
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>            // for atomic, memory_order_relaxed
+#include <cstdint>           // for int64_t
+#include <initializer_list>  // for initializer_list
+#include <utility>           // for pair
+
+#include "filesystem.h"  // for path
+
+/**
+ * @brief A tracing layer which can be switched on at runtime.
+ *
+ * While it is off, a traced scope costs a single relaxed atomic load. While it is on, the events are collected in
+ * memory and written to a file in the Chrome trace-event JSON format when tracing stops. The file can be opened in
+ * chrome://tracing, Perfetto or Speedscope.
+ *
+ * The event names and argument names must be string literals: only their addresses are recorded.
+ */
+namespace xoj::util::trace {
+
+namespace detail {
+extern std::atomic<bool> enabled;
+};  // namespace detail
+
+/**
+ * @return true if the events are currently recorded
+ */
+inline auto isEnabled() -> bool { return detail::enabled.load(std::memory_order_relaxed); }
+
+/**
+ * Starts recording the events. Any previous recording which was not written is discarded.
+ * @param file The trace is written to this file when the recording stops
+ */
+void start(fs::path file);
+
+/**
+ * Stops recording the events and writes them to the file given to start()
+ * @return false if the file could not be written
+ */
+auto stop() -> bool;
+
+/**
+ * @return The number of microseconds elapsed since an arbitrary, fixed origin
+ */
+auto now() -> int64_t;
+
+/**
+ * Records an event which started at `start` (see now()) and lasted `duration` microseconds
+ */
+void complete(const char* name, int64_t start, int64_t duration);
+
+/**
+ * Records the current values of a counter, e.g. the length of a queue or the hits and misses of a cache.
+ * At most 4 values are recorded.
+ */
+void counter(const char* name, std::initializer_list<std::pair<const char*, double>> values);
+
+/**
+ * Records the duration of the enclosing scope, if the tracing is on when the scope is entered
+ */
+class Scope {
+public:
+    explicit Scope(const char* name): name(name), start(isEnabled() ? now() : -1) {}
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() {
+        if (this->start >= 0) {
+            complete(this->name, this->start, now() - this->start);
+        }
+    }
+
+private:
+    const char* name;
+    int64_t start;
+};
+};  // namespace xoj::util::trace
+
+#define XOJ_TRACE_CONCAT_(a, b) a##b
+#define XOJ_TRACE_CONCAT(a, b) XOJ_TRACE_CONCAT_(a, b)
+
+/**
+ * Traces the enclosing scope under the given name
+ */
+#define XOJ_TRACE_SCOPE(name) xoj::util::trace::Scope XOJ_TRACE_CONCAT(xojTraceScope, __LINE__)(name)
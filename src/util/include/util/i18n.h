@@ -23,6 +23,10 @@
 #define _F(msg) PlaceholderString(_(msg))
 #define C_F(context, msg) PlaceholderString(C_(context, msg))
 
+// Formatted Translation with plural forms, chosen by n
+#define NG_(msg, msgPlural, n) ngettext(msg, msgPlural, n)
+#define NG_F(msg, msgPlural, n) PlaceholderString(NG_(msg, msgPlural, n))
+
 // Formatted, not translated text
 #define FORMAT_STR(msg) PlaceholderString(msg)
 
@@ -11,17 +11,32 @@
 
 #pragma once
 
-#include <cstddef>  // for size_t
-#include <sstream>  // for istringstream
-#include <string>   // for string
+#include <cstddef>      // for size_t
+#include <cstring>      // for memcpy
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <type_traits>  // for is_trivially_copyable_v
+#include <vector>       // for vector
 
+/**
+ * @brief Reads a stream written by ObjectOutputStream (with BinObjectEncoding).
+ *
+ * The stream is read in place: the buffer given to read() is neither copied nor owned, and must outlive the reading.
+ */
 class ObjectInputStream {
 public:
     ObjectInputStream() = default;
     virtual ~ObjectInputStream() = default;
 
 public:
-    bool read(const char* data, int len);
+    /**
+     * Starts reading a stream
+     * @param data The stream, which must remain valid while reading
+     * @param len The number of bytes available. The stream header records the actual length of the stream, so any
+     *            trailing bytes are ignored.
+     * @return false if the data is not a stream of the current version
+     */
+    bool read(const char* data, size_t len);
 
     void readObject(const char* name);
     std::string readObject();
@@ -33,18 +48,60 @@ public:
     size_t readSizeT();
     std::string readString();
 
+    /**
+     * Reads binary data into a new buffer, which has to be freed with g_free()
+     * @param len The number of elements
+     */
     void readData(void** data, int* len);
 
+    /**
+     * Reads binary data written from an array of T
+     */
+    template <typename T>
+    std::vector<T> readData();
+
+    /**
+     * Reads binary data without copying it
+     * @param width The expected size of one element
+     * @return The data, which points into the buffer given to read()
+     */
+    std::string_view readDataView(size_t width);
+
     /// Reads raw image data from the stream.
     std::string readImage();
 
 private:
     void checkType(char type);
 
+    /**
+     * Reads the header of binary data and returns a view on the data
+     */
+    std::string_view readBinary(size_t& count, size_t& width);
+
+    /**
+     * @return A view on the next `count` bytes, and moves past them
+     * @throw InputStreamException if less than `count` bytes are left
+     */
+    std::string_view take(size_t count, const char* what);
+
+    template <typename T>
+    T readValue(const char* what);
+
     static std::string getType(char type);
 
 private:
-    std::istringstream istream;
-    size_t pos();
+    const char* data = nullptr;
     size_t len = 0;
+    size_t pos = 0;
 };
+
+template <typename T>
+auto ObjectInputStream::readData() -> std::vector<T> {
+    static_assert(std::is_trivially_copyable_v<T>, "the elements are read from their binary representation");
+    std::string_view bytes = readDataView(sizeof(T));
+    std::vector<T> output(bytes.size() / sizeof(T));
+    if (!output.empty()) {
+        std::memcpy(output.data(), bytes.data(), bytes.size());
+    }
+    return output;
+}
@@ -19,6 +19,10 @@
 
 class ObjectEncoding;
 
+/**
+ * @brief Writes objects as a stream, which starts with a header made of the version of the format (XML_VERSION_STR)
+ * and of the length of the rest of the stream.
+ */
 class ObjectOutputStream {
 public:
     ObjectOutputStream(ObjectEncoding* encoder);
@@ -39,8 +43,17 @@ public:
     /// Writes the raw image data to the output stream.
     void writeImage(const std::string_view& imgData);
 
+    /**
+     * @return The stream, which the caller owns. Can only be called once.
+     */
     GString* getStr();
 
 private:
     ObjectEncoding* encoder = nullptr;
+
+    /**
+     * Position of the stream length in the header, and length of the header, in encoded bytes
+     */
+    size_t lengthOffset = 0;
+    size_t headerLength = 0;
 };
@@ -16,7 +16,7 @@
 class ObjectInputStream;
 class ObjectOutputStream;
 
-const static char* const XML_VERSION_STR = "XojStrm1:";
+const static char* const XML_VERSION_STR = "XojStrm2:";
 
 class Serializable {
 public:
@@ -1,37 +1,40 @@
 #include "util/serializing/ObjectInputStream.h"
 
 #include <cinttypes>  // for uint32_t
+#include <cstring>    // for memcpy
+#include <sstream>    // for ostringstream
 
-#include <glib.h>  // for g_free, g_strdup_...
+#include <glib.h>  // for g_free, g_malloc, g_strdup_...
 
 #include "util/PlaceholderString.h"                 // for PlaceholderString
 #include "util/i18n.h"                              // for FORMAT_STR, FS
 #include "util/serializing/InputStreamException.h"  // for InputStreamException
 #include "util/serializing/Serializable.h"          // for XML_VERSION_STR
 
-// This function requires that T is read from its binary representation to work (e.g. integer type)
-template <typename T>
-T readTypeFromSStream(std::istringstream& istream) {
-    if (istream.str().size() < sizeof(T)) {
+auto ObjectInputStream::take(size_t count, const char* what) -> std::string_view {
+    if (count > this->len - this->pos) {
         std::ostringstream oss;
-        oss << "End reached: trying to read " << sizeof(T) << " bytes while only " << istream.str().size()
-            << " bytes available";
+        oss << "End reached: trying to read " << what << " (" << count << " bytes) while only "
+            << this->len - this->pos << " bytes available";
         throw InputStreamException(oss.str(), __FILE__, __LINE__);
     }
-    T output;
-
-    istream.read((char*)&output, sizeof(T));
+    std::string_view bytes(this->data + this->pos, count);
+    this->pos += count;
+    return bytes;
+}
 
+// This function requires that T is read from its binary representation to work (e.g. integer type)
+template <typename T>
+auto ObjectInputStream::readValue(const char* what) -> T {
+    T output;
+    std::memcpy(&output, take(sizeof(T), what).data(), sizeof(T));
     return output;
 }
 
-size_t ObjectInputStream::pos() { return istream.tellg(); }
-
-auto ObjectInputStream::read(const char* data, int data_len) -> bool {
-    istream.clear();
-    len = (size_t)data_len;
-    std::string dataStr = std::string(data, len);
-    istream.str(dataStr);
+auto ObjectInputStream::read(const char* data, size_t len) -> bool {
+    this->data = data;
+    this->len = data ? len : 0;
+    this->pos = 0;
 
     try {
         std::string version = readString();
@@ -40,6 +43,14 @@ auto ObjectInputStream::read(const char* data, int data_len) -> bool {
                       version.c_str(), XML_VERSION_STR);
             return false;
         }
+
+        size_t streamLen = readSizeT();
+        if (streamLen > this->len - this->pos) {
+            g_warning("ObjectInputStream truncated: %zu bytes expected, but only %zu bytes available", streamLen,
+                      this->len - this->pos);
+            return false;
+        }
+        this->len = this->pos + streamLen;
     } catch (const InputStreamException& e) {
         g_warning("InputStreamException: %s", e.what());
         return false;
@@ -61,12 +72,12 @@ auto ObjectInputStream::readObject() -> std::string {
 }
 
 auto ObjectInputStream::getNextObjectName() -> std::string {
-    auto position = istream.tellg();
+    size_t position = this->pos;
 
     checkType('{');
     std::string name = readString();
 
-    istream.seekg(position);
+    this->pos = position;
     return name;
 }
 
@@ -74,91 +85,94 @@ void ObjectInputStream::endObject() { checkType('}'); }
 
 auto ObjectInputStream::readInt() -> int {
     checkType('i');
-    return readTypeFromSStream<int>(istream);
+    return readValue<int>("a number");
 }
 
 auto ObjectInputStream::readDouble() -> double {
     checkType('d');
-    return readTypeFromSStream<double>(istream);
+    return readValue<double>("a floating point");
 }
 
 auto ObjectInputStream::readSizeT() -> size_t {
     checkType('l');
-    return readTypeFromSStream<size_t>(istream);
+    return readValue<size_t>("a size");
 }
 
 auto ObjectInputStream::readString() -> std::string {
     checkType('s');
 
-    size_t lenString = (size_t)readTypeFromSStream<int>(istream);
-
-    if (istream.str().size() < len) {
-        throw InputStreamException("End reached, but try to read an string", __FILE__, __LINE__);
+    int lenString = readValue<int>("a string length");
+    if (lenString < 0) {
+        throw InputStreamException("Negative string length", __FILE__, __LINE__);
     }
 
-    std::string output;
-    output.resize(lenString);
-
-    istream.read(&output[0], (long)lenString);
-
-    return output;
+    return std::string(take(static_cast<size_t>(lenString), "a string"));
 }
 
-void ObjectInputStream::readData(void** data, int* length) {
+auto ObjectInputStream::readBinary(size_t& count, size_t& width) -> std::string_view {
     checkType('b');
 
-    if (istream.str().size() < 2 * sizeof(int)) {
-        throw InputStreamException("End reached, but try to read data len and width", __FILE__, __LINE__);
+    int len = readValue<int>("a data length");
+    int w = readValue<int>("a data width");
+    if (len < 0 || w < 0) {
+        throw InputStreamException("Negative data length or width", __FILE__, __LINE__);
     }
+    count = static_cast<size_t>(len);
+    width = static_cast<size_t>(w);
 
-    int len = readTypeFromSStream<int>(istream);
-    int width = readTypeFromSStream<int>(istream);
-
-    if (istream.str().size() < (len * width)) {
+    if (width != 0 && count > (this->len - this->pos) / width) {
         throw InputStreamException("End reached, but try to read data", __FILE__, __LINE__);
     }
+    return take(count * width, "data");
+}
 
-    if (len == 0) {
+void ObjectInputStream::readData(void** data, int* length) {
+    size_t count = 0;
+    size_t width = 0;
+    std::string_view bytes = readBinary(count, width);
+
+    if (bytes.empty()) {
         *length = 0;
         *data = nullptr;
     } else {
-        *data = (void*)new char[(size_t)(len * width)];
-        *length = len;
-
-        istream.read((char*)*data, len * width);
+        *data = g_malloc(bytes.size());
+        std::memcpy(*data, bytes.data(), bytes.size());
+        *length = static_cast<int>(count);
     }
 }
 
-auto ObjectInputStream::readImage() -> std::string {
-    checkType('m');
+auto ObjectInputStream::readDataView(size_t width) -> std::string_view {
+    size_t count = 0;
+    size_t actualWidth = 0;
+    std::string_view bytes = readBinary(count, actualWidth);
 
-    if (istream.str().size() < sizeof(size_t)) {
-        throw InputStreamException("End reached, but try to read an image's data's length", __FILE__, __LINE__);
+    if (count != 0 && actualWidth != width) {
+        throw InputStreamException(FS(FORMAT_STR("Expected data elements of {1} bytes but read elements of {2} bytes") %
+                                      width % actualWidth),
+                                   __FILE__, __LINE__);
     }
+    return bytes;
+}
 
-    const size_t len = readTypeFromSStream<size_t>(istream);
-    if (istream.str().size() < len) {
-        throw InputStreamException("End reached, but try to read an image", __FILE__, __LINE__);
-    }
-    std::string data;
-    data.resize(len);
-    istream.read(data.data(), static_cast<int>(len));
+auto ObjectInputStream::readImage() -> std::string {
+    checkType('m');
 
-    return data;
+    const size_t len = readValue<size_t>("an image's data's length");
+    return std::string(take(len, "an image"));
 }
 
 void ObjectInputStream::checkType(char type) {
-    if (istream.str().size() < 2) {
+    if (this->len - this->pos < 2) {
         throw InputStreamException(FS(FORMAT_STR("End reached, but try to read {1}, index {2} of {3}") % getType(type) %
-                                      (uint32_t)pos() % (uint32_t)len),
+                                      (uint32_t)this->pos % (uint32_t)this->len),
                                    __FILE__, __LINE__);
     }
-    char t = 0, underscore = 0;
-    istream >> underscore >> t;
+    char underscore = this->data[this->pos];
+    char t = this->data[this->pos + 1];
 
     if (underscore != '_') {
         throw InputStreamException(FS(FORMAT_STR("Expected type signature of {1}, index {2} of {3}, but read '{4}'") %
-                                      getType(type) % ((uint32_t)pos() + 1) % (uint32_t)len % underscore),
+                                      getType(type) % ((uint32_t)this->pos + 1) % (uint32_t)this->len % underscore),
                                    __FILE__, __LINE__);
     }
 
@@ -166,6 +180,7 @@ void ObjectInputStream::checkType(char type) {
         throw InputStreamException(FS(FORMAT_STR("Expected {1} but read {2}") % getType(type) % getType(t)), __FILE__,
                                    __LINE__);
     }
+    this->pos += 2;
 }
 
 auto ObjectInputStream::getType(char type) -> std::string {
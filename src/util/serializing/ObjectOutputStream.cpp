@@ -10,6 +10,13 @@ ObjectOutputStream::ObjectOutputStream(ObjectEncoding* encoder) {
     this->encoder = encoder;
 
     writeString(XML_VERSION_STR);
+
+    // Length of the rest of the stream, set by getStr()
+    this->encoder->addStr("_l");
+    this->lengthOffset = this->encoder->data->len;
+    size_t placeholder = 0;
+    this->encoder->addData(&placeholder, sizeof(size_t));
+    this->headerLength = this->encoder->data->len;
 }
 
 ObjectOutputStream::~ObjectOutputStream() {
@@ -67,4 +74,16 @@ void ObjectOutputStream::writeImage(const std::string_view& imgData) {
     this->encoder->addData(imgData.data(), static_cast<int>(len));
 }
 
-auto ObjectOutputStream::getStr() -> GString* { return this->encoder->getData(); }
+auto ObjectOutputStream::getStr() -> GString* {
+    GString* str = this->encoder->getData();
+
+    // Complete the header, with the length encoded like the rest of the stream
+    size_t streamLength = str->len - this->headerLength;
+    this->encoder->data = g_string_new(nullptr);
+    this->encoder->addData(&streamLength, sizeof(size_t));
+    GString* encodedLength = this->encoder->getData();
+    g_string_overwrite_len(str, this->lengthOffset, encodedLength->str, static_cast<gssize>(encodedLength->len));
+    g_string_free(encodedLength, true);
+
+    return str;
+}
@@ -0,0 +1,105 @@
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <gdk/gdk.h>
+
+#include "control/ToolEnums.h"
+#include "control/ToolHandler.h"
+#include "control/settings/Settings.h"
+#include "control/tools/EraseHandler.h"
+#include "gui/LegacyRedrawable.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Element.h"
+#include "model/Layer.h"
+#include "model/XojPage.h"
+#include "undo/UndoRedoHandler.h"
+#include "util/PathUtil.h"
+
+#include "SyntheticDocument.h"
+
+namespace {
+/**
+ * The EraseHandler reports the areas to rerender to a page view: there is none here
+ */
+class NoRedrawable: public LegacyRedrawable {
+public:
+    void repaintArea(double x1, double y1, double x2, double y2) const override {}
+    void repaintPage() const override {}
+    void rerenderPage() override {}
+    void rerenderRect(double x, double y, double width, double height) override {}
+    GdkRGBA getSelectionColor() override { return GdkRGBA{}; }
+    void deleteViewBuffer() override {}
+    int getX() const override { return 0; }
+    int getY() const override { return 0; }
+};
+
+synthetic::DocumentOptions optionsWithStrokes(int64_t strokes) {
+    synthetic::DocumentOptions options;
+    options.pages = 1;
+    options.strokesPerPage = static_cast<size_t>(strokes);
+    options.imagesPerPage = 0;
+    options.textsPerPage = 0;
+    return options;
+}
+};  // namespace
+
+/**
+ * An eraser drag across the page. Arg: strokes on the page
+ */
+static void BM_Erase(benchmark::State& state) {
+    Settings settings(Util::getTmpDirSubfolder("benchmarks") / "settings.xml");
+    ToolHandler toolHandler(nullptr, nullptr, &settings);
+    toolHandler.selectTool(TOOL_ERASER);
+    NoRedrawable view;
+    DocumentHandler docHandler;
+    std::unique_ptr<Document> doc;
+    std::unique_ptr<UndoRedoHandler> undo;
+
+    for (auto _: state) {
+        state.PauseTiming();
+        // Neither the deletion of the previous document nor the generation of a new one are measured
+        undo.reset();
+        doc = std::make_unique<Document>(&docHandler);
+        synthetic::fillDocument(*doc, optionsWithStrokes(state.range(0)));
+        undo = std::make_unique<UndoRedoHandler>(nullptr);
+        PageRef page = doc->getPage(0);
+        state.ResumeTiming();
+
+        EraseHandler eraser(undo.get(), doc.get(), page, &toolHandler, &view);
+        for (double t = 0; t <= 1; t += 0.002) { eraser.erase(t * page->getWidth(), t * page->getHeight()); }
+        eraser.finalize();
+    }
+    undo.reset();
+}
+BENCHMARK(BM_Erase)->Arg(300)->Arg(3000)->Unit(benchmark::kMillisecond);
+
+/**
+ * The transformations applied to the elements of a selection when it is released after a move, scale and rotation, as
+ * in EditSelectionContents::finalizeSelection. Arg: selected strokes
+ *
+ * EditSelection itself needs the main window, which is not available here.
+ */
+static void BM_SelectionTransform(benchmark::State& state) {
+    DocumentHandler docHandler;
+    Document doc(&docHandler);
+    synthetic::DocumentOptions options = optionsWithStrokes(state.range(0));
+    options.imagesPerPage = 5;
+    options.textsPerPage = 20;
+    synthetic::fillDocument(doc, options);
+    const std::vector<Element*>& elements = doc.getPage(0)->getSelectedLayer()->getElements();
+
+    double direction = 1;
+    for (auto _: state) {
+        for (Element* e: elements) {
+            e->move(direction * 3, direction * 2);
+            e->scale(100, 100, 1 + direction * 0.01, 1 - direction * 0.01, 0, false);
+            e->rotate(300, 400, direction * 0.05);
+        }
+        // Alternate, so that the elements do not drift away
+        direction = -direction;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * elements.size()));
+}
+BENCHMARK(BM_SelectionTransform)->Arg(300)->Arg(3000)->Unit(benchmark::kMillisecond);
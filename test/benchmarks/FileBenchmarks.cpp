@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "util/PathUtil.h"
+#include "util/XojPreviewExtractor.h"
+
+#include "SyntheticDocument.h"
+#include "filesystem.h"
+
+namespace {
+synthetic::DocumentOptions optionsWithPages(int64_t pages) {
+    synthetic::DocumentOptions options;
+    options.pages = static_cast<size_t>(pages);
+    return options;
+}
+};  // namespace
+
+static void BM_LoadDocument(benchmark::State& state) {
+    const fs::path filepath = synthetic::getDocumentFile(optionsWithPages(state.range(0)));
+    for (auto _: state) {
+        LoadHandler handler;
+        Document* doc = handler.loadDocument(filepath);
+        if (!doc) {
+            state.SkipWithError("Could not load the synthetic document");
+            break;
+        }
+        benchmark::DoNotOptimize(doc);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fs::file_size(filepath)));
+}
+BENCHMARK(BM_LoadDocument)->Arg(1)->Arg(10)->Arg(50)->Unit(benchmark::kMillisecond);
+
+static void BM_SaveDocument(benchmark::State& state) {
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(synthetic::getDocumentFile(optionsWithPages(state.range(0))));
+    if (!doc) {
+        state.SkipWithError("Could not load the synthetic document");
+        return;
+    }
+    const fs::path target = Util::getTmpDirSubfolder("benchmarks") / "save.xopp";
+    for (auto _: state) {
+        SaveHandler saver;
+        saver.prepareSave(doc);
+        saver.saveTo(target);
+        if (!saver.getErrorMessage().empty()) {
+            state.SkipWithError("Could not save the document");
+            break;
+        }
+    }
+    fs::remove(target);
+}
+BENCHMARK(BM_SaveDocument)->Arg(1)->Arg(10)->Arg(50)->Unit(benchmark::kMillisecond);
+
+static void BM_ExtractPreview(benchmark::State& state) {
+    const fs::path filepath = synthetic::getDocumentFile(optionsWithPages(state.range(0)));
+    for (auto _: state) {
+        XojPreviewExtractor extractor;
+        if (extractor.readFile(filepath) != PREVIEW_RESULT_IMAGE_READ) {
+            state.SkipWithError("No preview found");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ExtractPreview)->Arg(1)->Arg(50)->Unit(benchmark::kMicrosecond);
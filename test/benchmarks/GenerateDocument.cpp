@@ -0,0 +1,73 @@
+/*
+ * Generates the synthetic documents used by the benchmarks, e.g. to inspect them or to profile the application on them
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "SyntheticDocument.h"
+#include "filesystem.h"
+
+namespace {
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " OUTPUT.xopp [options]\n"
+              << "       " << program << " OUTPUT.pdf [--pages N] [--seed N]\n"
+              << "Options:\n"
+              << "  --pages N     Number of pages (default: 10)\n"
+              << "  --strokes N   Strokes per page (default: 300)\n"
+              << "  --points N    Points per stroke (default: 80)\n"
+              << "  --no-pressure Strokes without pressure values\n"
+              << "  --images N    Images per page (default: 1)\n"
+              << "  --texts N     Texts per page (default: 5)\n"
+              << "  --seed N      Seed of the generator (default: 1)\n";
+}
+};  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const fs::path output = fs::u8path(argv[1]);
+
+    synthetic::DocumentOptions options;
+    for (int i = 2; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--no-pressure") {
+            options.pressure = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        const auto value = std::strtoul(argv[++i], nullptr, 10);
+        if (arg == "--pages") {
+            options.pages = value;
+        } else if (arg == "--strokes") {
+            options.strokesPerPage = value;
+        } else if (arg == "--points") {
+            options.pointsPerStroke = value;
+        } else if (arg == "--images") {
+            options.imagesPerPage = value;
+        } else if (arg == "--texts") {
+            options.textsPerPage = value;
+        } else if (arg == "--seed") {
+            options.seed = static_cast<uint32_t>(value);
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (output.extension() == ".pdf") {
+        synthetic::writePdf(output, options.pages, options.seed);
+        return EXIT_SUCCESS;
+    }
+    if (std::string error = synthetic::writeDocument(output, options); !error.empty()) {
+        std::cerr << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
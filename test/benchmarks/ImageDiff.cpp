@@ -0,0 +1,134 @@
+#include "ImageDiff.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+using Lab = std::array<float, 3>;
+
+auto linearize(double c) -> double { return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4); }
+
+auto labF(double t) -> double { return t > 216.0 / 24389.0 ? std::cbrt(t) : (24389.0 / 27.0 * t + 16.0) / 116.0; }
+
+/**
+ * Converts an ARGB32 (premultiplied) pixel, composited over white, to CIE L*a*b* (D65)
+ */
+auto toLab(uint32_t argb) -> Lab {
+    const double a = ((argb >> 24) & 0xff) / 255.0;
+    // Premultiplied over white: c + (1 - a)
+    const double r = linearize(((argb >> 16) & 0xff) / 255.0 + 1.0 - a);
+    const double g = linearize(((argb >> 8) & 0xff) / 255.0 + 1.0 - a);
+    const double b = linearize((argb & 0xff) / 255.0 + 1.0 - a);
+
+    const double x = (0.4124 * r + 0.3576 * g + 0.1805 * b) / 0.95047;
+    const double y = 0.2126 * r + 0.7152 * g + 0.0722 * b;
+    const double z = (0.0193 * r + 0.1192 * g + 0.9505 * b) / 1.08883;
+
+    const double fx = labF(x);
+    const double fy = labF(y);
+    const double fz = labF(z);
+    return {static_cast<float>(116 * fy - 16), static_cast<float>(500 * (fx - fy)),
+            static_cast<float>(200 * (fy - fz))};
+}
+
+auto deltaE(const Lab& p, const Lab& q) -> double {
+    return std::sqrt((p[0] - q[0]) * (p[0] - q[0]) + (p[1] - q[1]) * (p[1] - q[1]) + (p[2] - q[2]) * (p[2] - q[2]));
+}
+
+/**
+ * The image converted to L*a*b*, pixel by pixel
+ */
+auto toLabImage(cairo_surface_t* surface) -> std::vector<Lab> {
+    cairo_surface_flush(surface);
+    const int width = cairo_image_surface_get_width(surface);
+    const int height = cairo_image_surface_get_height(surface);
+    const int stride = cairo_image_surface_get_stride(surface);
+    const unsigned char* data = cairo_image_surface_get_data(surface);
+
+    std::vector<Lab> lab(static_cast<size_t>(width) * static_cast<size_t>(height));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint32_t argb = 0;
+            std::memcpy(&argb, data + y * stride + 4 * x, sizeof(argb));
+            lab[static_cast<size_t>(y * width + x)] = toLab(argb);
+        }
+    }
+    return lab;
+}
+
+/**
+ * @return Whether the pixel (x, y) of `from` differs by at most `tolerance` from some pixel around (x, y) in `to`
+ */
+auto hasCloseNeighbour(const std::vector<Lab>& from, const std::vector<Lab>& to, int x, int y, int width, int height,
+                       double tolerance) -> bool {
+    const Lab& p = from[static_cast<size_t>(y * width + x)];
+    for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height - 1); ny++) {
+        for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width - 1); nx++) {
+            if (deltaE(p, to[static_cast<size_t>(ny * width + nx)]) <= tolerance) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+};  // namespace
+
+auto imagediff::compare(cairo_surface_t* expected, cairo_surface_t* actual, double tolerance, cairo_surface_t* diff)
+        -> Result {
+    Result result;
+    const int width = cairo_image_surface_get_width(expected);
+    const int height = cairo_image_surface_get_height(expected);
+    result.sameSize =
+            width == cairo_image_surface_get_width(actual) && height == cairo_image_surface_get_height(actual);
+    if (!result.sameSize) {
+        return result;
+    }
+    result.pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+
+    const std::vector<Lab> labExpected = toLabImage(expected);
+    const std::vector<Lab> labActual = toLabImage(actual);
+
+    unsigned char* diffData = nullptr;
+    int diffStride = 0;
+    if (diff) {
+        // A faded copy of the expected image, as a background for the differences
+        cairo_t* cr = cairo_create(diff);
+        cairo_set_source_rgb(cr, 1, 1, 1);
+        cairo_paint(cr);
+        cairo_set_source_surface(cr, expected, 0, 0);
+        cairo_paint_with_alpha(cr, 0.2);
+        cairo_destroy(cr);
+        cairo_surface_flush(diff);
+        diffData = cairo_image_surface_get_data(diff);
+        diffStride = cairo_image_surface_get_stride(diff);
+    }
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const auto i = static_cast<size_t>(y * width + x);
+            const double delta = deltaE(labExpected[i], labActual[i]);
+            result.maxDelta = std::max(result.maxDelta, delta);
+            if (delta <= tolerance) {
+                continue;
+            }
+            // Antialiasing moved by a pixel, in either direction, is not a difference
+            if (hasCloseNeighbour(labExpected, labActual, x, y, width, height, tolerance) &&
+                hasCloseNeighbour(labActual, labExpected, x, y, width, height, tolerance)) {
+                continue;
+            }
+            result.differingPixels++;
+            if (diffData) {
+                const uint32_t red = 0xffff0000U;
+                std::memcpy(diffData + y * diffStride + 4 * x, &red, sizeof(red));
+            }
+        }
+    }
+    if (diff) {
+        cairo_surface_mark_dirty(diff);
+    }
+    return result;
+}
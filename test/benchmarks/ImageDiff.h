@@ -0,0 +1,44 @@
+/*
+ * Xournal++
+ *
+ * Perceptual comparison of rendered pages
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <cairo.h>
+
+namespace imagediff {
+
+struct Result {
+    bool sameSize = false;
+    /// Largest color difference (CIE76 delta E) between a pixel and its counterpart
+    double maxDelta = 0;
+    /// Number of pixels which differ noticeably from their counterpart and all its neighbours
+    size_t differingPixels = 0;
+    size_t pixels = 0;
+
+    double differingRatio() const { return pixels ? static_cast<double>(differingPixels) / pixels : 0.0; }
+};
+
+/**
+ * Compares two ARGB32 images as a human would.
+ *
+ * The colors are compared in the CIE L*a*b* space, where a delta E of about 2.3 is just noticeable. A pixel only counts
+ * as different if it differs by more than the tolerance from the pixel at the same position in the other image and
+ * from its 8 neighbours, so that antialiasing shifted by one pixel is not reported.
+ *
+ * @param tolerance The largest delta E which does not count as a difference
+ * @param diff If not null, an ARGB32 image of the same size, on which the differing pixels are painted in red over a
+ * faded copy of the expected image
+ */
+Result compare(cairo_surface_t* expected, cairo_surface_t* actual, double tolerance, cairo_surface_t* diff = nullptr);
+
+}  // namespace imagediff
@@ -0,0 +1,95 @@
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+#include <cairo.h>
+#include <glib.h>
+
+#include "control/PdfCache.h"
+#include "control/xojfile/LoadHandler.h"
+#include "model/Document.h"
+#include "model/XojPage.h"
+#include "pdf/base/XojPdfDocument.h"
+#include "util/PathUtil.h"
+#include "util/raii/CairoWrappers.h"
+#include "view/DocumentView.h"
+
+#include "SyntheticDocument.h"
+#include "filesystem.h"
+
+namespace {
+constexpr size_t PDF_PAGES = 8;
+
+auto createPageSurface(double width, double height, double zoom) -> xoj::util::CairoSPtr {
+    cairo_surface_t* surface =
+            cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::ceil(width * zoom)),
+                                       static_cast<int>(std::ceil(height * zoom)));
+    xoj::util::CairoSPtr cr(cairo_create(surface), xoj::util::adopt);
+    cairo_surface_destroy(surface);  // owned by cr
+    cairo_scale(cr.get(), zoom, zoom);
+    return cr;
+}
+};  // namespace
+
+/**
+ * Offscreen rendering of a page, as done by the RenderJob. Args: strokes on the page, zoom in percent
+ */
+static void BM_DrawPage(benchmark::State& state) {
+    synthetic::DocumentOptions options;
+    options.pages = 1;
+    options.strokesPerPage = static_cast<size_t>(state.range(0));
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(synthetic::getDocumentFile(options));
+    if (!doc) {
+        state.SkipWithError("Could not load the synthetic document");
+        return;
+    }
+    PageRef page = doc->getPage(0);
+    const double zoom = static_cast<double>(state.range(1)) / 100;
+    auto cr = createPageSurface(page->getWidth(), page->getHeight(), zoom);
+
+    for (auto _: state) {
+        DocumentView view;
+        view.drawPage(page, cr.get(), true);
+        cairo_surface_flush(cairo_get_target(cr.get()));
+    }
+}
+BENCHMARK(BM_DrawPage)
+        ->Args({300, 100})
+        ->Args({3000, 100})
+        ->Args({3000, 300})
+        ->Unit(benchmark::kMillisecond);
+
+/**
+ * Rendering of PDF backgrounds through the PdfCache. Arg: 1 if the rendering can use the cache, 0 otherwise
+ */
+static void BM_PdfCache(benchmark::State& state) {
+    const fs::path filepath = Util::getTmpDirSubfolder("benchmarks") / "synthetic.pdf";
+    synthetic::writePdf(filepath, PDF_PAGES, 1);
+
+    XojPdfDocument pdf;
+    GError* error = nullptr;
+    if (!pdf.load(filepath, "", &error)) {
+        g_warning("Could not load the synthetic PDF: %s", error ? error->message : "");
+        g_clear_error(&error);
+        state.SkipWithError("Could not load the synthetic PDF");
+        return;
+    }
+    const bool useCache = state.range(0) != 0;
+    PdfCache cache(pdf, nullptr);
+    cache.setMaxSize(PDF_PAGES);
+    XojPdfPageSPtr firstPage = pdf.getPage(0);
+    const double zoom = 1.5;
+    auto cr = createPageSurface(firstPage->getWidth(), firstPage->getHeight(), zoom);
+
+    size_t pageNo = 0;
+    for (auto _: state) {
+        if (!useCache) {
+            cache.clearCache();
+        }
+        XojPdfPageSPtr pdfPage = pdf.getPage(pageNo);
+        cache.render(cr.get(), pageNo, zoom, pdfPage->getWidth(), pdfPage->getHeight());
+        cairo_surface_flush(cairo_get_target(cr.get()));
+        pageNo = (pageNo + 1) % PDF_PAGES;
+    }
+}
+BENCHMARK(BM_PdfCache)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
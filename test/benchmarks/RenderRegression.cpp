@@ -0,0 +1,359 @@
+/*
+ * Renders pages of a document offscreen, as the main view does, and records the images and rendering times.
+ * The results can be compared to those of another version (the golden set), to catch visual and performance
+ * regressions.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <locale>
+#include <map>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cairo.h>
+
+#include "control/PdfCache.h"
+#include "control/xojfile/LoadHandler.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/XojPage.h"
+#include "pdf/base/XojPdfDocument.h"
+#include "util/StringUtils.h"
+#include "util/raii/CairoWrappers.h"
+#include "view/DocumentView.h"
+
+#include "ImageDiff.h"
+#include "filesystem.h"
+
+namespace {
+/**
+ * Slowdowns smaller than this, in milliseconds, are measurement noise
+ */
+constexpr double MIN_SLOWDOWN_MS = 2.0;
+
+struct Options {
+    fs::path document;
+    fs::path output;
+    fs::path golden;
+    /// 0-based page indices, all the pages if empty
+    std::vector<size_t> pages;
+    std::vector<double> zooms = {1.0};
+    int repeat = 5;
+    /// Largest delta E between two pixels which are considered identical
+    double tolerance = 2.3;
+    /// Largest ratio of differing pixels for a page to match the golden one
+    double maxDiffRatio = 0.0005;
+    /// Largest ratio between the median rendering time and the golden one
+    double maxSlowdown = 1.5;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " DOCUMENT OUTPUT_DIR [options]\n"
+              << "Renders pages of DOCUMENT (.xopp, .xoj or .pdf) to PNG files in OUTPUT_DIR, with their rendering\n"
+              << "times in OUTPUT_DIR/timing.json\n"
+              << "Options:\n"
+              << "  --pages LIST          Pages to render, e.g. 1,3-5 (default: all)\n"
+              << "  --zooms LIST          Zoom levels, e.g. 1,1.5,3 (default: 1)\n"
+              << "  --repeat N            Renderings of each page, to measure the time (default: 5)\n"
+              << "  --golden DIR          Compare the images and times to the output of a previous run in DIR\n"
+              << "  --tolerance E         Color difference (delta E) below which pixels match (default: 2.3)\n"
+              << "  --max-diff-ratio R    Ratio of differing pixels below which images match (default: 0.0005)\n"
+              << "  --max-slowdown F      Ratio to the golden rendering time above which it is a regression\n"
+              << "                        (default: 1.5)\n";
+}
+
+auto parsePages(const std::string& list, std::vector<size_t>& pages) -> bool {
+    std::istringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const auto dash = item.find('-');
+        const long first = std::strtol(item.c_str(), nullptr, 10);
+        const long last = dash == std::string::npos ? first : std::strtol(item.c_str() + dash + 1, nullptr, 10);
+        if (first < 1 || last < first) {
+            return false;
+        }
+        for (long p = first; p <= last; p++) { pages.push_back(static_cast<size_t>(p - 1)); }
+    }
+    return !pages.empty();
+}
+
+auto parseZooms(const std::string& list, std::vector<double>& zooms) -> bool {
+    zooms.clear();
+    std::istringstream in(list);
+    in.imbue(std::locale::classic());
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        std::istringstream value(item);
+        value.imbue(std::locale::classic());
+        double zoom = 0;
+        if (!(value >> zoom) || zoom <= 0) {
+            return false;
+        }
+        zooms.push_back(zoom);
+    }
+    return !zooms.empty();
+}
+
+auto parseDouble(const char* str, double& value) -> bool {
+    std::istringstream in(str);
+    in.imbue(std::locale::classic());
+    return static_cast<bool>(in >> value);
+}
+
+auto parseArgs(int argc, char* argv[], Options& options) -> bool {
+    if (argc < 3) {
+        return false;
+    }
+    options.document = fs::u8path(argv[1]);
+    options.output = fs::u8path(argv[2]);
+    for (int i = 3; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (arg == "--pages") {
+            ok = parsePages(value, options.pages);
+        } else if (arg == "--zooms") {
+            ok = parseZooms(value, options.zooms);
+        } else if (arg == "--repeat") {
+            options.repeat = std::max(1, std::atoi(value));
+        } else if (arg == "--golden") {
+            options.golden = fs::u8path(value);
+        } else if (arg == "--tolerance") {
+            ok = parseDouble(value, options.tolerance);
+        } else if (arg == "--max-diff-ratio") {
+            ok = parseDouble(value, options.maxDiffRatio);
+        } else if (arg == "--max-slowdown") {
+            ok = parseDouble(value, options.maxSlowdown);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto imageName(size_t page, double zoom) -> std::string {
+    std::ostringstream name;
+    name << "page-" << std::setw(4) << std::setfill('0') << page + 1 << "-zoom-" << std::lround(zoom * 100) << ".png";
+    return name.str();
+}
+
+/**
+ * Reads the median times of a previous run: timing.json has one rendering per line
+ */
+auto readGoldenTimes(const fs::path& timingFile) -> std::map<std::string, double> {
+    std::map<std::string, double> times;
+    std::ifstream in(timingFile);
+    const std::regex entry(R"re("image": "([^"]+)".*"median_ms": ([0-9.eE+-]+))re");
+    std::string line;
+    while (std::getline(in, line)) {
+        std::smatch match;
+        if (std::regex_search(line, match, entry)) {
+            std::istringstream value(match[2].str());
+            value.imbue(std::locale::classic());
+            double ms = 0;
+            if (value >> ms) {
+                times[match[1].str()] = ms;
+            }
+        }
+    }
+    return times;
+}
+
+struct Timing {
+    double firstMs = 0;
+    double minMs = 0;
+    double medianMs = 0;
+};
+
+/**
+ * Renders the page onto the context's target `repeat` times
+ */
+auto render(const PageRef& page, cairo_t* cr, PdfCache* pdfCache, int repeat) -> Timing {
+    std::vector<double> times;
+    for (int i = 0; i < repeat; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        {
+            xoj::util::CairoSaveGuard saveGuard(cr);
+            cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+            cairo_paint(cr);
+        }
+        DocumentView view;
+        view.setPdfCache(pdfCache);
+        view.drawPage(page, cr, true);
+        cairo_surface_flush(cairo_get_target(cr));
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    Timing timing;
+    timing.firstMs = times.front();
+    std::sort(times.begin(), times.end());
+    timing.minMs = times.front();
+    timing.medianMs = times[times.size() / 2];
+    return timing;
+}
+};  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    // Load the document
+    LoadHandler loadHandler;
+    DocumentHandler docHandler;
+    std::unique_ptr<Document> pdfDocument;
+    Document* doc = nullptr;
+    if (options.document.extension() == ".pdf") {
+        pdfDocument = std::make_unique<Document>(&docHandler);
+        if (pdfDocument->readPdf(options.document, true, false)) {
+            doc = pdfDocument.get();
+        } else {
+            std::cerr << pdfDocument->getLastErrorMsg() << std::endl;
+        }
+    } else {
+        doc = loadHandler.loadDocument(options.document);
+        if (!doc) {
+            std::cerr << loadHandler.getLastError() << std::endl;
+        }
+    }
+    if (!doc) {
+        return 2;
+    }
+
+    if (options.pages.empty()) {
+        for (size_t p = 0; p < doc->getPageCount(); p++) { options.pages.push_back(p); }
+    }
+
+    std::error_code ec;
+    fs::create_directories(options.output, ec);
+    if (ec) {
+        std::cerr << "Could not create " << options.output.u8string() << ": " << ec.message() << std::endl;
+        return 2;
+    }
+
+    const bool compare = !options.golden.empty();
+    std::map<std::string, double> goldenTimes;
+    if (compare) {
+        goldenTimes = readGoldenTimes(options.golden / "timing.json");
+    }
+
+    PdfCache pdfCache(doc->getPdfDocument(), nullptr);
+    pdfCache.setMaxSize(4);
+
+    std::ostringstream json;
+    json.imbue(std::locale::classic());
+    json << std::fixed << std::setprecision(3);
+    json << "{\n\"document\": \"" << StringUtils::escapeJson(options.document.u8string()) << "\",\n\"renders\": [\n";
+
+    int failures = 0;
+    bool firstEntry = true;
+    for (size_t pageNo: options.pages) {
+        if (pageNo >= doc->getPageCount()) {
+            std::cerr << "Page " << pageNo + 1 << " does not exist: the document has " << doc->getPageCount()
+                      << " pages" << std::endl;
+            return 2;
+        }
+        PageRef page = doc->getPage(pageNo);
+
+        for (double zoom: options.zooms) {
+            const std::string name = imageName(pageNo, zoom);
+            const int width = static_cast<int>(std::ceil(page->getWidth() * zoom));
+            const int height = static_cast<int>(std::ceil(page->getHeight() * zoom));
+            xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+                                                xoj::util::adopt);
+            xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+            cairo_scale(cr.get(), zoom, zoom);
+
+            const Timing timing = render(page, cr.get(), &pdfCache, options.repeat);
+            cairo_surface_write_to_png(surface.get(), (options.output / name).u8string().c_str());
+
+            json << (firstEntry ? "" : ",\n") << "{\"image\": \"" << name << "\", \"page\": " << pageNo + 1
+                 << ", \"zoom\": " << zoom << ", \"width\": " << width << ", \"height\": " << height
+                 << ", \"first_ms\": " << timing.firstMs << ", \"min_ms\": " << timing.minMs
+                 << ", \"median_ms\": " << timing.medianMs;
+            firstEntry = false;
+
+            std::cout << name << ": " << std::fixed << std::setprecision(2) << timing.medianMs << " ms";
+
+            if (compare) {
+                bool failed = false;
+                xoj::util::CairoSurfaceSPtr golden(
+                        cairo_image_surface_create_from_png((options.golden / name).u8string().c_str()),
+                        xoj::util::adopt);
+                if (cairo_surface_status(golden.get()) != CAIRO_STATUS_SUCCESS) {
+                    std::cout << ", no golden image";
+                    json << ", \"visual\": \"missing\"";
+                    failed = true;
+                } else {
+                    xoj::util::CairoSurfaceSPtr diff(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+                                                     xoj::util::adopt);
+                    const auto result = imagediff::compare(golden.get(), surface.get(), options.tolerance, diff.get());
+                    const bool match = result.sameSize && result.differingRatio() <= options.maxDiffRatio;
+                    if (!result.sameSize) {
+                        std::cout << ", size differs from the golden image";
+                    } else {
+                        std::cout << ", " << result.differingPixels << " differing pixels (max delta E "
+                                  << result.maxDelta << ")";
+                    }
+                    json << ", \"visual\": \"" << (match ? "pass" : "fail") << "\", \"differing_pixels\": "
+                         << result.differingPixels << ", \"max_delta_e\": " << result.maxDelta;
+                    if (!match) {
+                        if (result.sameSize) {
+                            fs::path diffName = options.output / name;
+                            diffName.replace_extension(".diff.png");
+                            cairo_surface_write_to_png(diff.get(), diffName.u8string().c_str());
+                        }
+                        failed = true;
+                    }
+                }
+
+                if (auto it = goldenTimes.find(name); it != goldenTimes.end()) {
+                    const double goldenMs = it->second;
+                    const bool slower = timing.medianMs > goldenMs * options.maxSlowdown &&
+                                        timing.medianMs - goldenMs > MIN_SLOWDOWN_MS;
+                    std::cout << ", golden " << goldenMs << " ms";
+                    json << ", \"golden_median_ms\": " << goldenMs << ", \"timing\": \""
+                         << (slower ? "fail" : "pass") << "\"";
+                    failed = failed || slower;
+                }
+
+                if (failed) {
+                    std::cout << " -> FAILED";
+                    failures++;
+                }
+            }
+            json << "}";
+            std::cout << std::endl;
+        }
+    }
+    json << "\n]\n}\n";
+
+    std::ofstream timingFile(options.output / "timing.json");
+    timingFile << json.str();
+    if (!timingFile) {
+        std::cerr << "Could not write " << (options.output / "timing.json").u8string() << std::endl;
+        return 2;
+    }
+
+    if (failures > 0) {
+        std::cout << failures << " regression(s) found" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include "SyntheticDocument.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <cairo-pdf.h>
+#include <cairo.h>
+
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Font.h"
+#include "model/Image.h"
+#include "model/Layer.h"
+#include "model/PageType.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/Text.h"
+#include "model/XojPage.h"
+#include "util/Color.h"
+#include "util/PathUtil.h"
+#include "view/DocumentView.h"
+
+namespace {
+// A4, in points
+constexpr double PAGE_WIDTH = 595.275591;
+constexpr double PAGE_HEIGHT = 841.889764;
+
+constexpr int IMAGE_SIZE = 256;
+constexpr int PREVIEW_SIZE = 128;
+
+constexpr std::array<uint32_t, 6> COLORS = {0x000000U, 0x3333ccU, 0xff0000U, 0x008000U, 0xff8000U, 0x808080U};
+constexpr std::array<double, 3> WIDTHS = {0.85, 1.41, 2.26};
+
+const char* const LOREM = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt "
+                          "ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation.";
+
+/**
+ * std::mt19937's output is specified by the standard, unlike that of the distributions
+ */
+class Random {
+public:
+    explicit Random(uint32_t seed): rng(seed) {}
+
+    /// Uniform in [a, b)
+    double uniform(double a, double b) { return a + (b - a) * (static_cast<double>(rng()) / 4294967296.0); }
+
+    /// Uniform in [0, n)
+    size_t index(size_t n) { return static_cast<size_t>(rng()) % n; }
+
+private:
+    std::mt19937 rng;
+};
+
+auto createStroke(Random& rnd, const synthetic::DocumentOptions& options) -> Stroke* {
+    auto* s = new Stroke();
+    const bool highlighter = rnd.index(20) == 0;
+    s->setToolType(highlighter ? StrokeTool::HIGHLIGHTER : StrokeTool::PEN);
+    s->setColor(Color(COLORS[rnd.index(COLORS.size())]));
+    const double width = highlighter ? 8.5 : WIDTHS[rnd.index(WIDTHS.size())];
+    s->setWidth(width);
+    const bool pressure = options.pressure && !highlighter;
+
+    // A random walk, with a slowly turning direction, like handwriting
+    double x = rnd.uniform(20, PAGE_WIDTH - 20);
+    double y = rnd.uniform(20, PAGE_HEIGHT - 20);
+    double angle = rnd.uniform(0, 2 * M_PI);
+    const double step = rnd.uniform(0.5, 2.5);
+    for (size_t i = 0; i < std::max<size_t>(options.pointsPerStroke, 2); i++) {
+        const double z = pressure ? width * rnd.uniform(0.4, 1.0) : Point::NO_PRESSURE;
+        s->addPoint(Point(x, y, z));
+        angle += rnd.uniform(-0.35, 0.35);
+        x = std::clamp(x + step * std::cos(angle), 0.0, PAGE_WIDTH);
+        y = std::clamp(y + step * std::sin(angle), 0.0, PAGE_HEIGHT);
+    }
+    return s;
+}
+
+auto createImage(Random& rnd) -> Image* {
+    // A gradient with random colors: cheap to generate, but not trivially compressible
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, IMAGE_SIZE, IMAGE_SIZE);
+    cairo_t* cr = cairo_create(surface);
+    cairo_pattern_t* pattern = cairo_pattern_create_linear(0, 0, IMAGE_SIZE, IMAGE_SIZE);
+    for (int i = 0; i <= 4; i++) {
+        cairo_pattern_add_color_stop_rgb(pattern, i / 4.0, rnd.uniform(0, 1), rnd.uniform(0, 1), rnd.uniform(0, 1));
+    }
+    cairo_set_source(cr, pattern);
+    cairo_paint(cr);
+    for (int i = 0; i < 64; i++) {
+        cairo_set_source_rgba(cr, rnd.uniform(0, 1), rnd.uniform(0, 1), rnd.uniform(0, 1), 0.5);
+        cairo_arc(cr, rnd.uniform(0, IMAGE_SIZE), rnd.uniform(0, IMAGE_SIZE), rnd.uniform(2, 20), 0, 2 * M_PI);
+        cairo_fill(cr);
+    }
+    cairo_pattern_destroy(pattern);
+    cairo_destroy(cr);
+
+    std::string png;
+    cairo_surface_write_to_png_stream(
+            surface,
+            [](void* closure, const unsigned char* data, unsigned int length) {
+                static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &png);
+    cairo_surface_destroy(surface);
+
+    auto* img = new Image();
+    img->setImage(std::move(png));
+    const double size = rnd.uniform(60, 200);
+    img->setX(rnd.uniform(0, PAGE_WIDTH - size));
+    img->setY(rnd.uniform(0, PAGE_HEIGHT - size));
+    img->setWidth(size);
+    img->setHeight(size);
+    return img;
+}
+
+auto createText(Random& rnd) -> Text* {
+    auto* t = new Text();
+    t->setFont(XojFont("Sans", rnd.uniform(8, 16)));
+    t->setColor(Color(COLORS[rnd.index(COLORS.size())]));
+    std::string text = LOREM;
+    text.resize(20 + rnd.index(text.size() - 20));
+    t->setText(std::move(text));
+    t->setX(rnd.uniform(0, PAGE_WIDTH - 200));
+    t->setY(rnd.uniform(0, PAGE_HEIGHT - 20));
+    return t;
+}
+
+void updatePreview(Document& doc) {
+    PageRef page = doc.getPage(0);
+    const double zoom = PREVIEW_SIZE / std::max(page->getWidth(), page->getHeight());
+    cairo_surface_t* preview =
+            cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::ceil(page->getWidth() * zoom)),
+                                       static_cast<int>(std::ceil(page->getHeight() * zoom)));
+    cairo_t* cr = cairo_create(preview);
+    cairo_scale(cr, zoom, zoom);
+    DocumentView view;
+    view.drawPage(page, cr, true);
+    cairo_destroy(cr);
+    doc.setPreview(preview);
+    cairo_surface_destroy(preview);
+}
+};  // namespace
+
+void synthetic::fillDocument(Document& doc, const DocumentOptions& options) {
+    Random rnd(options.seed);
+    for (size_t p = 0; p < options.pages; p++) {
+        auto page = std::make_shared<XojPage>(PAGE_WIDTH, PAGE_HEIGHT);
+        page->setBackgroundType(PageType(p % 2 ? PageTypeFormat::Graph : PageTypeFormat::Lined));
+        Layer* layer = page->getSelectedLayer();
+
+        for (size_t i = 0; i < options.imagesPerPage; i++) { layer->addElement(createImage(rnd)); }
+        for (size_t i = 0; i < options.strokesPerPage; i++) { layer->addElement(createStroke(rnd, options)); }
+        for (size_t i = 0; i < options.textsPerPage; i++) { layer->addElement(createText(rnd)); }
+
+        doc.addPage(page);
+    }
+}
+
+auto synthetic::writeDocument(const fs::path& filepath, const DocumentOptions& options) -> std::string {
+    DocumentHandler handler;
+    Document doc(&handler);
+    fillDocument(doc, options);
+    if (doc.getPageCount() > 0) {
+        updatePreview(doc);
+    }
+
+    SaveHandler saver;
+    saver.prepareSave(&doc);
+    saver.saveTo(filepath);
+    return saver.getErrorMessage();
+}
+
+auto synthetic::getDocumentFile(const DocumentOptions& options) -> fs::path {
+    std::ostringstream name;
+    name << "synthetic-" << options.pages << "p-" << options.strokesPerPage << "s-" << options.pointsPerStroke << "n-"
+         << (options.pressure ? "pressure-" : "") << options.imagesPerPage << "i-" << options.textsPerPage << "t-"
+         << options.seed << ".xopp";
+    fs::path filepath = Util::getTmpDirSubfolder("benchmarks") / name.str();
+
+    static std::set<fs::path> generated;
+    if (generated.count(filepath) == 0) {
+        if (std::string error = writeDocument(filepath, options); !error.empty()) {
+            throw std::runtime_error("Could not generate " + filepath.u8string() + ": " + error);
+        }
+        generated.insert(filepath);
+    }
+    return filepath;
+}
+
+void synthetic::writePdf(const fs::path& filepath, size_t pages, uint32_t seed) {
+    Random rnd(seed);
+    cairo_surface_t* surface = cairo_pdf_surface_create(filepath.u8string().c_str(), PAGE_WIDTH, PAGE_HEIGHT);
+    cairo_t* cr = cairo_create(surface);
+    for (size_t p = 0; p < pages; p++) {
+        cairo_select_font_face(cr, "Serif", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+        cairo_set_font_size(cr, 11);
+        cairo_set_source_rgb(cr, 0, 0, 0);
+        for (double y = 60; y < PAGE_HEIGHT - 60; y += 14) {
+            cairo_move_to(cr, 50, y);
+            cairo_show_text(cr, std::string(LOREM, 40 + rnd.index(60)).c_str());
+        }
+        cairo_set_line_width(cr, 0.5);
+        for (int i = 0; i < 200; i++) {
+            cairo_set_source_rgb(cr, rnd.uniform(0, 1), rnd.uniform(0, 1), rnd.uniform(0, 1));
+            cairo_move_to(cr, rnd.uniform(0, PAGE_WIDTH), rnd.uniform(0, PAGE_HEIGHT));
+            cairo_line_to(cr, rnd.uniform(0, PAGE_WIDTH), rnd.uniform(0, PAGE_HEIGHT));
+            cairo_stroke(cr);
+        }
+        cairo_show_page(cr);
+    }
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
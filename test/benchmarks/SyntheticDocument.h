@@ -0,0 +1,61 @@
+/*
+ * Xournal++
+ *
+ * Deterministic generator of large documents, for the benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "filesystem.h"
+
+class Document;
+
+namespace synthetic {
+
+struct DocumentOptions {
+    size_t pages = 10;
+    size_t strokesPerPage = 300;
+    size_t pointsPerStroke = 80;
+    /// Whether the strokes have a pressure value for each point
+    bool pressure = true;
+    size_t imagesPerPage = 1;
+    size_t textsPerPage = 5;
+    /// Two documents generated with the same options and seed are identical
+    uint32_t seed = 1;
+};
+
+/**
+ * Appends pages filled with random strokes, images and texts to the document.
+ *
+ * The randomness does not depend on the standard library's distributions, so that the documents are identical on all
+ * platforms.
+ */
+void fillDocument(Document& doc, const DocumentOptions& options);
+
+/**
+ * Generates a document and saves it as a .xopp file, with a preview
+ * @return An error message, empty on success
+ */
+std::string writeDocument(const fs::path& filepath, const DocumentOptions& options);
+
+/**
+ * @return A .xopp file generated with the given options in the temporary directory. It is generated at the first call
+ * of each run, so that it always matches the current generator and file format.
+ */
+fs::path getDocumentFile(const DocumentOptions& options);
+
+/**
+ * Writes a PDF file whose pages are filled with random lines and text, to be used as a background
+ */
+void writePdf(const fs::path& filepath, size_t pages, uint32_t seed);
+
+}  // namespace synthetic
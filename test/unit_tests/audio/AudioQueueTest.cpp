@@ -0,0 +1,183 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <sndfile.h>
+
+#include "audio/AudioQueue.h"
+#include "audio/SNDFileCpp.h"
+#include "audio/VorbisConsumer.h"
+#include "audio/VorbisProducer.h"
+#include "control/settings/Settings.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+/// Frames per chunk handed to / requested by the simulated PortAudio callbacks
+constexpr size_t CALLBACK_FRAMES = 64;
+constexpr int SAMPLE_RATE = 44100;
+constexpr size_t CHANNELS = 2;
+
+auto makeSamples(size_t nFrames) -> std::vector<float> {
+    std::vector<float> samples(nFrames * CHANNELS);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = static_cast<float>(std::sin(static_cast<double>(i) * 0.01) * 0.5);
+    }
+    return samples;
+}
+
+/// Simulates the PortAudio playback callback: pops fixed size chunks until the producer signals the end of the stream
+auto drainLikeCallback(AudioQueue<float>& queue) -> std::vector<float> {
+    std::vector<float> result;
+    std::vector<float> chunk(CALLBACK_FRAMES * CHANNELS);
+    while (!(queue.hasStreamEnded() && queue.empty())) {
+        auto n = queue.pop(chunk.data(), chunk.size());
+        result.insert(result.end(), chunk.begin(), std::next(chunk.begin(), static_cast<std::ptrdiff_t>(n)));
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+    return result;
+}
+}  // namespace
+
+TEST(AudioQueue, testOrderIsPreservedUnderConcurrentBulkAccess) {
+    // A tiny queue forces many wrap-arounds and many full / empty situations
+    AudioQueue<float> queue(1000);
+    EXPECT_EQ(queue.capacity(), 1024U);
+    queue.setAudioAttributes(SAMPLE_RATE, static_cast<unsigned int>(CHANNELS));
+
+    constexpr size_t nSamples = 4'000'000;
+    std::thread producer([&queue] {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<size_t> frames(1, 300);
+        std::vector<float> chunk;
+        auto lock = queue.acquire_lock();
+        for (size_t sent = 0; sent < nSamples;) {
+            chunk.resize(std::min(frames(gen) * CHANNELS, nSamples - sent));
+            for (size_t i = 0; i < chunk.size(); i++) {
+                chunk[i] = static_cast<float>((sent + i) % (1U << 20U));
+            }
+            for (size_t written = 0; written < chunk.size();) {
+                written += queue.push(chunk.data() + written, chunk.size() - written);
+                if (written < chunk.size()) {
+                    queue.waitForConsumer(lock);
+                }
+            }
+            sent += chunk.size();
+        }
+        queue.signalEndOfStream();
+    });
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<size_t> frames(1, 200);
+    std::vector<float> chunk(200 * CHANNELS);
+    size_t received = 0;
+    size_t mismatches = 0;
+    while (!(queue.hasStreamEnded() && queue.empty())) {
+        auto n = queue.pop(chunk.data(), frames(gen) * CHANNELS);
+        EXPECT_EQ(n % CHANNELS, 0U);
+        for (size_t i = 0; i < n; i++) {
+            mismatches += chunk[i] != static_cast<float>((received + i) % (1U << 20U));
+        }
+        received += n;
+    }
+    producer.join();
+
+    EXPECT_EQ(received, nSamples);
+    EXPECT_EQ(mismatches, 0U);
+}
+
+TEST(AudioQueue, testPushOnFullQueueKeepsWholeFrames) {
+    AudioQueue<float> queue(8);
+    queue.setAudioAttributes(SAMPLE_RATE, static_cast<unsigned int>(CHANNELS));
+
+    std::vector<float> data{1, 2, 3, 4, 5, 6, 7};
+    EXPECT_EQ(queue.push(data.data(), 5), 4U);
+    EXPECT_EQ(queue.push(data.data(), 7), 4U);
+    EXPECT_EQ(queue.push(data.data(), 2), 0U);
+    EXPECT_EQ(queue.size(), 8U);
+
+    std::vector<float> out(8);
+    EXPECT_EQ(queue.pop(out.data(), 3), 2U);
+    EXPECT_EQ(queue.pop(out.data() + 2, 8), 6U);
+    EXPECT_EQ(out, (std::vector<float>{1, 2, 3, 4, 1, 2, 3, 4}));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(AudioQueue, testFileProducerToCallbackConsumer) {
+    auto dir = Util::getTmpDirSubfolder("audioqueue-test");
+    auto file = dir / "producer.wav";
+    auto samples = makeSamples(5 * SAMPLE_RATE);
+    {
+        SF_INFO info{};
+        info.channels = static_cast<int>(CHANNELS);
+        info.samplerate = SAMPLE_RATE;
+        info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+        auto sfFile = xoj::audio::make_snd_file(file, SFM_WRITE, &info);
+        ASSERT_TRUE(sfFile);
+        sf_writef_float(sfFile.get(), samples.data(), static_cast<sf_count_t>(samples.size() / CHANNELS));
+    }
+
+    AudioQueue<float> queue;
+    VorbisProducer producer(queue);
+    ASSERT_TRUE(producer.start(file, 0));
+    auto played = drainLikeCallback(queue);
+    producer.stop();
+
+    EXPECT_EQ(played, samples);
+    fs::remove_all(dir);
+}
+
+TEST(AudioQueue, testCallbackProducerToFileConsumer) {
+    auto dir = Util::getTmpDirSubfolder("audioqueue-test");
+    auto file = dir / "consumer.ogg";
+    auto samples = makeSamples(SAMPLE_RATE);
+
+    Settings settings(dir / "settings.xml");
+    settings.setAudioSampleRate(SAMPLE_RATE);
+    settings.setAudioGain(1.0);
+
+    AudioQueue<float> queue;
+    queue.setAudioAttributes(SAMPLE_RATE, static_cast<unsigned int>(CHANNELS));
+    VorbisConsumer consumer(settings, queue);
+    ASSERT_TRUE(consumer.start(file));
+
+    // Simulates the PortAudio recording callback: pushes fixed size chunks at 4x real time without ever waiting
+    constexpr auto callbackPeriod = std::chrono::microseconds(1'000'000 * CALLBACK_FRAMES / SAMPLE_RATE / 4);
+    size_t dropped = 0;
+    for (size_t offset = 0; offset < samples.size(); offset += CALLBACK_FRAMES * CHANNELS) {
+        auto n = std::min(CALLBACK_FRAMES * CHANNELS, samples.size() - offset);
+        dropped += n - queue.push(samples.data() + offset, n);
+        std::this_thread::sleep_for(callbackPeriod);
+    }
+    queue.signalEndOfStream();
+    consumer.join();
+    ASSERT_EQ(dropped, 0U);
+
+    SF_INFO info{};
+    {
+        auto sfFile = xoj::audio::make_snd_file(file, SFM_READ, &info);
+        ASSERT_TRUE(sfFile);
+    }
+    EXPECT_EQ(info.channels, static_cast<int>(CHANNELS));
+    EXPECT_EQ(info.frames, static_cast<sf_count_t>(samples.size() / CHANNELS));
+    fs::remove_all(dir);
+}
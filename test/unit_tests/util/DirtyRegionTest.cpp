@@ -0,0 +1,96 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/DirtyRegion.h"
+#include "util/Rectangle.h"
+
+using xoj::util::DirtyRegion;
+using xoj::util::Rectangle;
+
+namespace {
+bool pairwiseDisjoint(const DirtyRegion& region) {
+    const auto& rects = region.getRects();
+    for (size_t i = 0; i < rects.size(); i++) {
+        for (size_t j = i + 1; j < rects.size(); j++) {
+            if (rects[i].intersects(rects[j])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool covers(const DirtyRegion& region, const Rectangle<double>& rect) {
+    // Check a grid of points inside rect
+    for (int i = 0; i <= 10; i++) {
+        for (int j = 0; j <= 10; j++) {
+            const double x = rect.x + rect.width * (0.01 + 0.098 * i);
+            const double y = rect.y + rect.height * (0.01 + 0.098 * j);
+            bool found = false;
+            for (const auto& r: region.getRects()) {
+                found = found || (x >= r.x && x <= r.x + r.width && y >= r.y && y <= r.y + r.height);
+            }
+            if (!found) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+};  // namespace
+
+TEST(UtilDirtyRegion, testEmpty) {
+    DirtyRegion region;
+    EXPECT_TRUE(region.empty());
+    region.add(Rectangle<double>(0, 0, 0, 10));
+    region.add(Rectangle<double>(0, 0, 10, -1));
+    EXPECT_TRUE(region.empty());
+    EXPECT_EQ(region.getOverdrawRatio(), 1.0);
+}
+
+TEST(UtilDirtyRegion, testIntersectingAreMerged) {
+    DirtyRegion region;
+    region.add(Rectangle<double>(0, 0, 10, 10));
+    region.add(Rectangle<double>(5, 5, 10, 10));
+    ASSERT_EQ(region.getRects().size(), 1);
+    const auto& r = region.getRects().front();
+    EXPECT_EQ(r.x, 0);
+    EXPECT_EQ(r.y, 0);
+    EXPECT_EQ(r.width, 15);
+    EXPECT_EQ(r.height, 15);
+}
+
+TEST(UtilDirtyRegion, testFarApartAreKept) {
+    DirtyRegion region;
+    region.add(Rectangle<double>(0, 0, 10, 10));
+    region.add(Rectangle<double>(100, 100, 10, 10));
+    EXPECT_EQ(region.getRects().size(), 2);
+    EXPECT_DOUBLE_EQ(region.getArea(), 200);
+    EXPECT_DOUBLE_EQ(region.getOverdrawRatio(), 1.0);
+
+    auto bounds = region.getBounds();
+    EXPECT_EQ(bounds.x, 0);
+    EXPECT_EQ(bounds.y, 0);
+    EXPECT_EQ(bounds.width, 110);
+    EXPECT_EQ(bounds.height, 110);
+
+    region.clear();
+    EXPECT_TRUE(region.empty());
+    EXPECT_EQ(region.getRequestedArea(), 0);
+}
+
+TEST(UtilDirtyRegion, testEraserDrag) {
+    // Many small rectangles along a diagonal, like an eraser drag
+    DirtyRegion region(4);
+    std::vector<Rectangle<double>> added;
+    for (int i = 0; i < 500; i++) {
+        added.emplace_back(0.7 * i, 0.3 * i + 20 * (i % 3), 6, 6);
+        region.add(added.back());
+        ASSERT_LE(region.getRects().size(), 4);
+        ASSERT_TRUE(pairwiseDisjoint(region));
+    }
+    for (const auto& r: added) { EXPECT_TRUE(covers(region, r)); }
+    EXPECT_GE(region.getArea(), 0.0);
+    EXPECT_LE(region.getArea(), region.getBounds().area());
+}
@@ -1,4 +1,5 @@
 #include <array>
+#include <cmath>
 #include <random>
 #include <string>
 #include <tuple>
@@ -347,3 +348,64 @@ TEST(UtilObjectIOStream, testReadStroke) {
         FAIL();
     }
 }
+
+TEST(UtilObjectIOStream, testStreamLength) {
+    std::string str = serializeInt(42);
+
+    // Trailing bytes are ignored
+    std::string padded = str + "_i1234";
+    ObjectInputStream stream;
+    EXPECT_TRUE(stream.read(padded.data(), padded.size()));
+    EXPECT_EQ(42, stream.readInt());
+    EXPECT_THROW(stream.readInt(), InputStreamException);
+
+    // A truncated stream is rejected
+    ObjectInputStream truncated;
+    EXPECT_FALSE(truncated.read(str.data(), str.size() - 1));
+}
+
+TEST(UtilObjectIOStream, testFuzzStroke) {
+    std::mt19937 gen(4242);
+    std::uniform_real_distribution<double> coord(-1000., 1000.);
+    std::uniform_int_distribution<int> pointCount(0, 2000);
+    std::uniform_int_distribution<int> byte(1, 255);
+
+    for (int iter = 0; iter < 20; ++iter) {
+        Stroke stroke;
+        int n = pointCount(gen);
+        for (int i = 0; i < n; ++i) { stroke.addPoint(Point(coord(gen), coord(gen), std::abs(coord(gen)))); }
+        stroke.setWidth(std::abs(coord(gen)));
+        stroke.setFill(iter % 2 ? -1 : 128);
+        stroke.setAudioFilename(iter % 3 ? "" : "audio.mp3");
+
+        std::string str = serializeStroke(stroke);
+        {
+            ObjectInputStream stream;
+            ASSERT_TRUE(stream.read(str.data(), str.size()));
+            Stroke inStroke;
+            inStroke.readSerialized(stream);
+            assertStrokeEquality(stroke, inStroke);
+        }
+
+        // A truncated or corrupted stream is either rejected or read within its bounds
+        std::uniform_int_distribution<size_t> position(0, str.size() - 1);
+        for (int i = 0; i < 50; ++i) {
+            std::vector<char> damaged(str.begin(), str.end());
+            if (i % 2 == 0) {
+                damaged.resize(position(gen));
+            } else {
+                damaged[position(gen)] ^= static_cast<char>(byte(gen));
+            }
+
+            try {
+                ObjectInputStream stream;
+                if (stream.read(damaged.data(), damaged.size())) {
+                    Stroke inStroke;
+                    inStroke.readSerialized(stream);
+                }
+            } catch (const InputStreamException&) {
+                // expected for most of the damaged streams
+            }
+        }
+    }
+}
@@ -66,3 +66,11 @@ TEST(UtilStringUtils, testCompare) {
     EXPECT_EQ(true, StringUtils::iequals("ööaa", "Ööaa"));
     EXPECT_EQ(false, StringUtils::iequals("ööaa", "ööaaa"));
 }
+
+TEST(UtilStringUtils, testEscapeJson) {
+    EXPECT_EQ(std::string("plain text"), StringUtils::escapeJson("plain text"));
+    EXPECT_EQ(std::string("a\\\"b\\\\c"), StringUtils::escapeJson("a\"b\\c"));
+    EXPECT_EQ(std::string("line\\nnext\\ttab"), StringUtils::escapeJson("line\nnext\ttab"));
+    EXPECT_EQ(std::string("\\u0001"), StringUtils::escapeJson("\x01"));
+    EXPECT_EQ(std::string("äöü"), StringUtils::escapeJson("äöü"));
+}
@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "util/Tracing.h"
+
+#include "filesystem.h"
+
+namespace trace = xoj::util::trace;
+
+static auto readFile(const fs::path& file) -> std::string {
+    std::ifstream in(file);
+    std::stringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+TEST(UtilTracing, testDisabledByDefault) {
+    EXPECT_FALSE(trace::isEnabled());
+    // Not recording: does nothing
+    XOJ_TRACE_SCOPE("ignored");
+    trace::counter("ignored", {{"value", 1}});
+    EXPECT_TRUE(trace::stop());
+}
+
+TEST(UtilTracing, testWriteEvents) {
+    const fs::path file = fs::temp_directory_path() / "xournalpp-tracing-test.json";
+
+    trace::start(file);
+    EXPECT_TRUE(trace::isEnabled());
+    { XOJ_TRACE_SCOPE("scope \"quoted\""); }
+    trace::counter("queue", {{"high", 2}, {"low", 3}});
+    EXPECT_TRUE(trace::stop());
+    EXPECT_FALSE(trace::isEnabled());
+
+    // Recorded after the stop: not in the file
+    { XOJ_TRACE_SCOPE("late"); }
+
+    const std::string content = readFile(file);
+    fs::remove(file);
+
+    EXPECT_NE(std::string::npos, content.find("\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, content.find("{\"name\":\"scope \\\"quoted\\\"\",\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, content.find("\"args\":{\"high\":2,\"low\":3}"));
+    EXPECT_EQ(std::string::npos, content.find("late"));
+}